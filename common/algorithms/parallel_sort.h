@@ -176,8 +176,8 @@ namespace embree
     }
   }
   
-  template<typename T>
-    static void radixsort32(T* const morton, const size_t num, const unsigned int shift = 3*8)
+  template<typename Key, typename T>
+    static void radixsort_inplace(T* const morton, const size_t num, const unsigned int shift)
   {
     static const unsigned int BITS = 8;
     static const unsigned int BUCKETS = (1 << BITS);
@@ -193,7 +193,7 @@ namespace embree
 #pragma nounroll
 #endif
     for (size_t i=0;i<num;i++)
-      count[(unsigned(morton[i]) >> shift) & (BUCKETS-1)]++;
+      count[(Key(morton[i]) >> shift) & (BUCKETS-1)]++;
     
     /* prefix sums */
     __aligned(64) unsigned int head[BUCKETS];
@@ -220,11 +220,11 @@ namespace embree
         T v = morton[head[i]];
         while(1)
         {
-          const size_t b = (unsigned(v) >> shift) & (BUCKETS-1);
+          const size_t b = (Key(v) >> shift) & (BUCKETS-1);
           if (b == i) break;
           std::swap(v,morton[head[b]++]);
         }
-        assert((unsigned(v) >> shift & (BUCKETS-1)) == i);
+        assert((Key(v) >> shift & (BUCKETS-1)) == i);
         morton[head[i]++] = v;
       }
     }
@@ -236,19 +236,29 @@ namespace embree
       {
         
         for (size_t j=offset;j<offset+count[i]-1;j++)
-          assert(((unsigned(morton[j]) >> shift) & (BUCKETS-1)) == i);
+          assert(((Key(morton[j]) >> shift) & (BUCKETS-1)) == i);
         
         if (unlikely(count[i] < CMP_SORT_THRESHOLD))
           insertionsort_ascending(morton + offset, count[i]);
         else
-          radixsort32(morton + offset, count[i], shift-BITS);
+          radixsort_inplace<Key>(morton + offset, count[i], shift-BITS);
         
         for (size_t j=offset;j<offset+count[i]-1;j++)
           assert(morton[j] <= morton[j+1]);
         
         offset += count[i];
       }      
-  }    
+  }
+
+  template<typename T>
+    static void radixsort32(T* const morton, const size_t num, const unsigned int shift = 3*8) {
+    radixsort_inplace<uint32_t>(morton,num,shift);
+  }
+
+  template<typename T>
+    static void radixsort64(T* const morton, const size_t num, const unsigned int shift = 7*8) {
+    radixsort_inplace<uint64_t>(morton,num,shift);
+  }
 
   template<typename Ty, typename Key>
     class ParallelRadixSort
@@ -391,35 +401,43 @@ namespace embree
       }
     }
     
-    void tbbRadixIteration(const Key shift, const bool last,
+    /* returns true if all items have the same digit, in this case the items are not copied */
+    bool tbbRadixIteration(const Key shift,
                            const Ty* __restrict src, Ty* __restrict dst,
                            const size_t numTasks)
     {
       affinity_partitioner ap;
       parallel_for_affinity(numTasks,[&] (size_t taskIndex) { tbbRadixIteration0(shift,src,dst,taskIndex,numTasks); },ap);
+
+      /* skip the copy pass if the digit is identical for all items, which is common for the high digits of 64 bit keys */
+      const size_t digit = ((size_t)(Key)src[0] >> (size_t)shift) & (BUCKETS-1);
+      size_t count = 0;
+      for (size_t i=0; i<numTasks; i++)
+        count += radixCount[i][digit];
+      if (count == N) return true;
+
       parallel_for_affinity(numTasks,[&] (size_t taskIndex) { tbbRadixIteration1(shift,src,dst,taskIndex,numTasks); },ap);
+      return false;
     }
     
     void tbbRadixSort(const size_t numTasks)
     {
       radixCount = (TyRadixCount*) alignedMalloc(MAX_TASKS*sizeof(TyRadixCount),64);
-      
-      if (sizeof(Key) == sizeof(uint32_t)) {
-        tbbRadixIteration(0*BITS,0,src,tmp,numTasks);
-        tbbRadixIteration(1*BITS,0,tmp,src,numTasks);
-        tbbRadixIteration(2*BITS,0,src,tmp,numTasks);
-        tbbRadixIteration(3*BITS,1,tmp,src,numTasks);
+
+      /* sort by one digit after the other, swapping source and destination after each copy */
+      Ty* in = src;
+      Ty* out = tmp;
+      for (size_t shift=0; shift<8*sizeof(Key); shift+=BITS) {
+        if (!tbbRadixIteration((Key)shift,in,out,numTasks))
+          std::swap(in,out);
       }
-      else if (sizeof(Key) == sizeof(uint64_t))
-      {
-        tbbRadixIteration(0*BITS,0,src,tmp,numTasks);
-        tbbRadixIteration(1*BITS,0,tmp,src,numTasks);
-        tbbRadixIteration(2*BITS,0,src,tmp,numTasks);
-        tbbRadixIteration(3*BITS,0,tmp,src,numTasks);
-        tbbRadixIteration(4*BITS,0,src,tmp,numTasks);
-        tbbRadixIteration(5*BITS,0,tmp,src,numTasks);
-        tbbRadixIteration(6*BITS,0,src,tmp,numTasks);
-        tbbRadixIteration(7*BITS,1,tmp,src,numTasks);
+
+      /* the sorted items have to end up in the source array */
+      if (in != src) {
+        parallel_for(size_t(0), N, size_t(4096), [&] (const range<size_t>& r) {
+            for (size_t i=r.begin(); i<r.end(); i++)
+              src[i] = in[i];
+          });
       }
     }
     
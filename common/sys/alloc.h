@@ -113,6 +113,10 @@ namespace embree
   void  os_free   (void* ptr, size_t bytes, bool hugepages);
   void  os_advise (void* ptr, size_t bytes);
 
+  /*! maps a file copy-on-write into memory, returns nullptr on failure */
+  void* os_map_file (const char* filename, size_t& bytes);
+  void  os_unmap_file (void* ptr, size_t bytes);
+
   /*! allocator that performs OS allocations */
   template<typename T>
     struct os_allocator
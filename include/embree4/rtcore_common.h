@@ -157,6 +157,7 @@ enum RTCBuildQuality
   RTC_BUILD_QUALITY_MEDIUM = 1,
   RTC_BUILD_QUALITY_HIGH   = 2,
   RTC_BUILD_QUALITY_REFIT  = 3,
+  RTC_BUILD_QUALITY_OPTIMIZED = 4,
 };
 
 /* Axis-aligned bounding box representation */
@@ -303,6 +304,7 @@ enum RTCRayQueryFlags
   /* embree specific flags */
   RTC_RAY_QUERY_FLAG_INCOHERENT = (0 << 16), // optimize for incoherent rays
   RTC_RAY_QUERY_FLAG_COHERENT   = (1 << 16), // optimize for coherent rays
+  RTC_RAY_QUERY_FLAG_BREADTH_FIRST = (1 << 17), // trace ray streams breadth first through BVH treelets
 };
 
 /* Arguments for RTCFilterFunctionN */
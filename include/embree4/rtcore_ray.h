@@ -48,6 +48,17 @@ struct RTCRayHit
   struct RTCHit hit;
 };
 
+/* Maximal number of hits a multi-hit query can return for a single ray */
+#define RTC_MAX_MULTI_HIT_COUNT 16
+
+/* Nearest hits of a single ray sorted front to back */
+struct RTC_ALIGN(16) RTCMultiHit
+{
+  unsigned int numHits;                       // number of valid hits
+  float t[RTC_MAX_MULTI_HIT_COUNT];           // hit distances
+  struct RTCHit hit[RTC_MAX_MULTI_HIT_COUNT]; // hit data
+};
+
 /* Ray structure for a packet of 4 rays */
 struct RTC_ALIGN(16) RTCRay4
 {
@@ -12,6 +12,9 @@ struct RTCRayHit;
 struct RTCRayHit4;
 struct RTCRayHit8;
 struct RTCRayHit16;
+struct RTCRayHitN;
+struct RTCRayN;
+struct RTCMultiHit;
 
 /* Scene flags */
 enum RTCSceneFlags
@@ -20,7 +23,9 @@ enum RTCSceneFlags
   RTC_SCENE_FLAG_DYNAMIC                 = (1 << 0),
   RTC_SCENE_FLAG_COMPACT                 = (1 << 1),
   RTC_SCENE_FLAG_ROBUST                  = (1 << 2),
-  RTC_SCENE_FLAG_FILTER_FUNCTION_IN_ARGUMENTS = (1 << 3)
+  RTC_SCENE_FLAG_FILTER_FUNCTION_IN_ARGUMENTS = (1 << 3),
+  RTC_SCENE_FLAG_DETERMINISTIC           = (1 << 4),
+  RTC_SCENE_FLAG_LAZY                    = (1 << 5)
 };
 
 /* Additional arguments for rtcIntersect1/4/8/16 calls */
@@ -117,6 +122,15 @@ RTC_API void rtcCommitScene(RTCScene scene);
 /* Commits the scene from multiple threads. */
 RTC_API void rtcJoinCommitScene(RTCScene scene);
 
+/* Commits multiple scenes of the same device in a single build operation. */
+RTC_API void rtcCommitScenes(RTCScene* scenes, size_t numScenes);
+
+/* Commit completion callback function */
+typedef void (*RTCCommitCompleteFunction)(void* ptr, RTCScene scene, enum RTCError error);
+
+/* Commits the scene in the background and invokes the completion callback when done. */
+RTC_API void rtcCommitSceneAsync(RTCScene scene, RTCCommitCompleteFunction complete, void* ptr);
+
 
 /* Progress monitor callback function */
 typedef bool (*RTCProgressMonitorFunction)(void* ptr, double n);
@@ -127,6 +141,20 @@ RTC_API void rtcSetSceneProgressMonitorFunction(RTCScene scene, RTCProgressMonit
 /* Sets the build quality of the scene. */
 RTC_API void rtcSetSceneBuildQuality(RTCScene scene, enum RTCBuildQuality quality);
 
+/* Sets the time in milliseconds a scene commit should take. */
+RTC_API void rtcSetSceneBuildTimeBudget(RTCScene scene, float milliseconds);
+
+/* Estimated resources of a scene commit */
+struct RTCSceneCommitEstimate
+{
+  size_t accelBytes;  // bytes of the acceleration structures after the commit
+  size_t peakBytes;   // peak bytes allocated during the commit
+  double buildTime;   // build time in seconds
+};
+
+/* Estimates the memory and time a commit of the scene needs without building it. */
+RTC_API void rtcEstimateSceneCommit(RTCScene scene, struct RTCSceneCommitEstimate* estimate);
+
 /* Sets the scene flags. */
 RTC_API void rtcSetSceneFlags(RTCScene scene, enum RTCSceneFlags flags);
 
@@ -165,6 +193,24 @@ RTC_API void rtcIntersect8(const int* valid, RTCScene scene, struct RTCRayHit8*
 /* Intersects a packet of 16 rays with the scene. */
 RTC_API void rtcIntersect16(const int* valid, RTCScene scene, struct RTCRayHit16* rayhit, struct RTCIntersectArguments* args RTC_OPTIONAL_ARGUMENT);
 
+/* Intersects a stream of M rays in AOS layout with the scene. */
+RTC_API void rtcIntersectStream(RTCScene scene, struct RTCRayHit* rayhit, unsigned int M, size_t byteStride, struct RTCIntersectArguments* args RTC_OPTIONAL_ARGUMENT);
+
+/* Intersects a stream of N rays in SOA layout with the scene. */
+RTC_API void rtcIntersectStreamN(RTCScene scene, struct RTCRayHitN* rayhit, unsigned int N, struct RTCIntersectArguments* args RTC_OPTIONAL_ARGUMENT);
+
+/* Finds the maxHits nearest hits of a single ray with the scene. */
+RTC_API void rtcIntersectMultiHit1(RTCScene scene, struct RTCRayHit* rayhit, struct RTCMultiHit* hits, unsigned int maxHits, struct RTCIntersectArguments* args RTC_OPTIONAL_ARGUMENT);
+
+/* Finds the maxHits nearest hits of each ray of a packet of 4 rays with the scene. */
+RTC_API void rtcIntersectMultiHit4(const int* valid, RTCScene scene, struct RTCRayHit4* rayhit, struct RTCMultiHit* hits, unsigned int maxHits, struct RTCIntersectArguments* args RTC_OPTIONAL_ARGUMENT);
+
+/* Finds the maxHits nearest hits of each ray of a packet of 8 rays with the scene. */
+RTC_API void rtcIntersectMultiHit8(const int* valid, RTCScene scene, struct RTCRayHit8* rayhit, struct RTCMultiHit* hits, unsigned int maxHits, struct RTCIntersectArguments* args RTC_OPTIONAL_ARGUMENT);
+
+/* Finds the maxHits nearest hits of each ray of a packet of 16 rays with the scene. */
+RTC_API void rtcIntersectMultiHit16(const int* valid, RTCScene scene, struct RTCRayHit16* rayhit, struct RTCMultiHit* hits, unsigned int maxHits, struct RTCIntersectArguments* args RTC_OPTIONAL_ARGUMENT);
+
 
 /* Forwards ray inside user geometry callback. */
 RTC_SYCL_API void rtcForwardIntersect1(const struct RTCIntersectFunctionNArguments* args, RTCScene scene, struct RTCRay* ray, unsigned int instID);
@@ -191,6 +237,15 @@ RTC_API void rtcOccluded8(const int* valid, RTCScene scene, struct RTCRay8* ray,
 /* Tests a packet of 16 rays for occlusion with the scene. */
 RTC_API void rtcOccluded16(const int* valid, RTCScene scene, struct RTCRay16* ray, struct RTCOccludedArguments* args RTC_OPTIONAL_ARGUMENT);
 
+/* Tests a stream of M rays in AOS layout for occlusion with the scene. */
+RTC_API void rtcOccludedStream(RTCScene scene, struct RTCRay* ray, unsigned int M, size_t byteStride, struct RTCOccludedArguments* args RTC_OPTIONAL_ARGUMENT);
+
+/* Tests a stream of N rays in SOA layout for occlusion with the scene. */
+RTC_API void rtcOccludedStreamN(RTCScene scene, struct RTCRayN* ray, unsigned int N, struct RTCOccludedArguments* args RTC_OPTIONAL_ARGUMENT);
+
+/* Tests M rays that share the origin of the passed ray for occlusion with the scene. */
+RTC_API void rtcOccludedSharedOrigin(RTCScene scene, const struct RTCRay* ray, const float* dir, float* tfar, unsigned int M, struct RTCOccludedArguments* args RTC_OPTIONAL_ARGUMENT);
+
 
 /* Forwards single occlusion ray inside user geometry callback. */
 RTC_SYCL_API void rtcForwardOccluded1(const struct RTCOccludedFunctionNArguments* args, RTCScene scene, struct RTCRay* ray, unsigned int instID);
@@ -23,7 +23,7 @@ namespace embree
       {
         /*! default settings */
         Settings ()
-        : branchingFactor(2), maxDepth(32), logBlockSize(0), minLeafSize(1), maxLeafSize(7), finished_range_threshold(inf) {}
+        : branchingFactor(2), maxDepth(32), logBlockSize(0), minLeafSize(1), maxLeafSize(7), finished_range_threshold(inf), singleGeometryLeaves(true) {}
 
       public:
         size_t branchingFactor;  //!< branching factor of BVH to build
@@ -32,6 +32,7 @@ namespace embree
         size_t minLeafSize;      //!< minimum size of a leaf
         size_t maxLeafSize;      //!< maximum size of a leaf
         size_t finished_range_threshold;  //!< finished range threshold
+        bool singleGeometryLeaves;        //!< leaves only contain primitives of a single geometry
       };
 
       template<typename NodeRef,
@@ -107,7 +108,7 @@ namespace embree
               throw_RTCError(RTC_ERROR_UNKNOWN,"depth limit reached");
 
             /* create leaf for few primitives */
-            if (pinfo.size() <= cfg.maxLeafSize && sameGeometry(pinfo))
+            if (pinfo.size() <= cfg.maxLeafSize && (!cfg.singleGeometryLeaves || sameGeometry(pinfo)))
               return createLeaf(prims,pinfo,alloc);
 
             /* fill all children by always splitting the largest one */
@@ -123,7 +124,7 @@ namespace embree
               for (unsigned i=0; i<numChildren; i++)
               {
                 /* ignore leaves as they cannot get split */
-                if (children[i].size() <= cfg.maxLeafSize && sameGeometry(children[i]))
+                if (children[i].size() <= cfg.maxLeafSize && (!cfg.singleGeometryLeaves || sameGeometry(children[i])))
                   continue;
 
                 /* remember child with largest size */
@@ -136,7 +137,7 @@ namespace embree
 
               /*! split best child into left and right child */
               __aligned(64) PrimInfoRange left, right;
-              if (!sameGeometry(children[bestChild])) {
+              if (cfg.singleGeometryLeaves && !sameGeometry(children[bestChild])) {
                 alignedHeuristic.splitByGeometry(children[bestChild],left,right);
               } else {
                 alignedHeuristic.splitFallback(children[bestChild],left,right);
@@ -15,6 +15,12 @@ namespace embree
     {
       static const size_t MAX_BRANCHING_FACTOR = 8;          //!< maximum supported BVH branching factor
       static const size_t MIN_LARGE_LEAF_LEVELS = 8;         //!< create balanced tree of we are that many levels before the maximum tree depth
+      static const size_t MIN_PRIMITIVES_MORTON_CODES64 = 1 << 20; //!< minimal number of primitives to consider 64 bit morton codes
+
+      struct MortonCodeMapping;
+      struct MortonCodeMapping64;
+      struct MortonCodeGenerator;
+      struct MortonCodeGenerator64;
 
       /*! settings for morton builder */
       struct Settings
@@ -52,6 +58,10 @@ namespace embree
       /*! Build primitive consisting of morton code and primitive ID. */
       struct __aligned(8) BuildPrim
       {
+        typedef unsigned int Code;
+        typedef MortonCodeMapping Mapping;
+        typedef MortonCodeGenerator Generator;
+
         union {
           struct {
             unsigned int code;     //!< morton code
@@ -67,6 +77,23 @@ namespace embree
         __forceinline bool operator<(const BuildPrim &m) const { return code < m.code; }
       };
 
+      /*! Build primitive consisting of 64 bit morton code and primitive ID, used for very large scenes. */
+      struct __aligned(16) BuildPrim64
+      {
+        typedef uint64_t Code;
+        typedef MortonCodeMapping64 Mapping;
+        typedef MortonCodeGenerator64 Generator;
+
+        uint64_t code;         //!< morton code
+        unsigned int index;    //!< i'th primitive
+
+        /*! interface for radix sort */
+        __forceinline operator uint64_t() const { return code; }
+
+        /*! interface for standard sort */
+        __forceinline bool operator<(const BuildPrim64 &m) const { return code < m.code; }
+      };
+
       /*! maps bounding box to morton code */
       struct MortonCodeMapping
       {
@@ -102,6 +129,67 @@ namespace embree
         }
       };
 
+      /*! maps bounding box to 64 bit morton code */
+      struct MortonCodeMapping64
+      {
+        static const size_t LATTICE_BITS_PER_DIM = 21;
+        static const size_t LATTICE_SIZE_PER_DIM = size_t(1) << LATTICE_BITS_PER_DIM;
+
+        vfloat4 base;
+        vfloat4 scale;
+
+        __forceinline MortonCodeMapping64(const BBox3fa& bounds)
+        {
+          base  = (vfloat4)bounds.lower;
+          const vfloat4 diag  = (vfloat4)bounds.upper - (vfloat4)bounds.lower;
+          scale = select(diag > vfloat4(1E-19f), rcp(diag) * vfloat4(LATTICE_SIZE_PER_DIM * 0.99f),vfloat4(0.0f));
+        }
+
+        __forceinline uint64_t code (const BBox3fa& box) const
+        {
+          const vfloat4 lower = (vfloat4)box.lower;
+          const vfloat4 upper = (vfloat4)box.upper;
+          const vfloat4 centroid = lower+upper;
+          const vint4 binID = vint4((centroid-base)*scale);
+          const uint64_t x = extract<0>(binID);
+          const uint64_t y = extract<1>(binID);
+          const uint64_t z = extract<2>(binID);
+          return bitInterleave64(x,y,z);
+        }
+      };
+
+      /*! generates 64 bit morton codes */
+      struct MortonCodeGenerator64
+      {
+        __forceinline MortonCodeGenerator64(const MortonCodeMapping64& mapping, BuildPrim64* dest)
+          : mapping(mapping), dest(dest) {}
+
+        __forceinline void operator() (const BBox3fa& b, const unsigned index)
+        {
+          dest->index = index;
+          dest->code = mapping.code(b);
+          dest++;
+        }
+
+      public:
+        const MortonCodeMapping64 mapping;
+        BuildPrim64* dest;
+      };
+
+      /*! 32 bit morton codes only resolve 1024 lattice cells per dimension. For large scenes
+       *  whose primitives are much smaller than a lattice cell, many primitives map to the same
+       *  code and most build time is spent recreating codes, thus we use 64 bit codes for these.
+       *  As 64 bit codes double the sorting cost we only do so when a lattice cell is much larger
+       *  than the average primitive. */
+      static __forceinline bool useMortonCodes64(size_t numPrimitives, const BBox3fa& centBounds, float primSize)
+      {
+        if (numPrimitives < MIN_PRIMITIVES_MORTON_CODES64)
+          return false;
+
+        const float cellSize = reduce_max(centBounds.size()) / float(MortonCodeMapping::LATTICE_SIZE_PER_DIM);
+        return cellSize > 8.0f*primSize;
+      }
+
 #if defined (__AVX2__) || defined(__SYCL_DEVICE_ONLY__)
 
       /*! for AVX2 there is a fast scalar bitInterleave */
@@ -174,6 +262,7 @@ namespace embree
 
       template<
         typename ReductionTy,
+        typename BuildPrimTy,
         typename Allocator,
         typename CreateAllocator,
         typename CreateNodeFunc,
@@ -186,6 +275,14 @@ namespace embree
       {
         ALIGNED_CLASS_(16);
 
+        typedef typename BuildPrimTy::Code Code;
+        typedef typename BuildPrimTy::Mapping Mapping;
+        static const unsigned int CODE_BITS = 8*sizeof(Code);
+
+        /*! counts leading zeros of a morton code, returns the number of bits for zero */
+        static __forceinline unsigned int lzcnt_code(const unsigned int code) { return lzcnt(code); }
+        static __forceinline unsigned int lzcnt_code(const uint64_t code) { return code ? 63-(unsigned int)bsr(size_t(code)) : 64; }
+
       public:
 
         BuilderT (CreateAllocator& createAllocator,
@@ -273,7 +370,7 @@ namespace embree
               centBounds.extend(center2(calculateBounds(morton[i])));
 
             /* recalculate morton codes */
-            MortonCodeMapping mapping(centBounds);
+            Mapping mapping(centBounds);
             for (size_t i=current.begin(); i<current.end(); i++)
               morton[i].code = mapping.code(calculateBounds(morton[i]));
 
@@ -293,7 +390,7 @@ namespace embree
                                                        BBox3fa(empty), calculateCentBounds, BBox3fa::merge);
 
             /* recalculate morton codes */
-            MortonCodeMapping mapping(centBounds);
+            Mapping mapping(centBounds);
             parallel_for(current.begin(), current.end(), unsigned(1024), [&] ( const range<unsigned>& r ) {
                 for (size_t i=r.begin(); i<r.end(); i++) {
                   morton[i].code = mapping.code(calculateBounds(morton[i]));
@@ -304,42 +401,43 @@ namespace embree
 #if defined(TASKING_TBB)
             tbb::parallel_sort(morton+current.begin(),morton+current.end());
 #else
-            radixsort32(morton+current.begin(),current.size());
+            if (CODE_BITS == 64) radixsort64(morton+current.begin(),current.size());
+            else                 radixsort32(morton+current.begin(),current.size());
 #endif
           }
         }
 
         __forceinline void split(const range<unsigned>& current, range<unsigned>& left, range<unsigned>& right) const
         {
-          const unsigned int code_start = morton[current.begin()].code;
-          const unsigned int code_end   = morton[current.end()-1].code;
-          unsigned int bitpos = lzcnt(code_start^code_end);
+          const Code code_start = morton[current.begin()].code;
+          const Code code_end   = morton[current.end()-1].code;
+          unsigned int bitpos = lzcnt_code(code_start^code_end);
 
           /* if all items mapped to same morton code, then re-create new morton codes for the items */
-          if (unlikely(bitpos == 32))
+          if (unlikely(bitpos == CODE_BITS))
           {
             recreateMortonCodes(current);
-            const unsigned int code_start = morton[current.begin()].code;
-            const unsigned int code_end   = morton[current.end()-1].code;
-            bitpos = lzcnt(code_start^code_end);
+            const Code code_start = morton[current.begin()].code;
+            const Code code_end   = morton[current.end()-1].code;
+            bitpos = lzcnt_code(code_start^code_end);
 
             /* if the morton code is still the same, goto fall back split */
-            if (unlikely(bitpos == 32)) {
+            if (unlikely(bitpos == CODE_BITS)) {
               current.split(left,right);
               return;
             }
           }
 
           /* split the items at the topmost different morton code bit */
-          const unsigned int bitpos_diff = 31-bitpos;
-          const unsigned int bitmask = 1 << bitpos_diff;
+          const unsigned int bitpos_diff = CODE_BITS-1-bitpos;
+          const Code bitmask = Code(1) << bitpos_diff;
 
           /* find location where bit differs using binary search */
           unsigned begin = current.begin();
           unsigned end   = current.end();
           while (begin + 1 != end) {
             const unsigned mid = (begin+end)/2;
-            const unsigned bit = morton[mid].code & bitmask;
+            const Code bit = morton[mid].code & bitmask;
             if (bit == 0) begin = mid; else end = mid;
           }
           unsigned center = end;
@@ -432,11 +530,11 @@ namespace embree
         }
 
         /* build function */
-        ReductionTy build(BuildPrim* src, BuildPrim* tmp, size_t numPrimitives)
+        ReductionTy build(BuildPrimTy* src, BuildPrimTy* tmp, size_t numPrimitives)
         {
           /* sort morton codes */
           morton = src;
-          radix_sort_u32(src,tmp,numPrimitives,singleThreadThreshold);
+          radix_sort<BuildPrimTy,Code>(src,tmp,numPrimitives,singleThreadThreshold);
 
           /* build BVH */
           const ReductionTy root = recurse(1, range<unsigned>(0,(unsigned)numPrimitives), nullptr, true);
@@ -453,7 +551,7 @@ namespace embree
         ProgressMonitor& progressMonitor;
 
       public:
-        BuildPrim* morton;
+        BuildPrimTy* morton;
       };
 
 
@@ -464,7 +562,8 @@ namespace embree
         typename SetBoundsFunc,
         typename CreateLeafFunc,
         typename CalculateBoundsFunc,
-        typename ProgressMonitor>
+        typename ProgressMonitor,
+        typename BuildPrimTy>
 
         static ReductionTy build(CreateAllocFunc createAllocator,
                                  CreateNodeFunc createNode,
@@ -472,13 +571,14 @@ namespace embree
                                  CreateLeafFunc createLeaf,
                                  CalculateBoundsFunc calculateBounds,
                                  ProgressMonitor progressMonitor,
-                                 BuildPrim* src,
-                                 BuildPrim* tmp,
+                                 BuildPrimTy* src,
+                                 BuildPrimTy* tmp,
                                  size_t numPrimitives,
                                  const Settings& settings)
         {
           typedef BuilderT<
             ReductionTy,
+            BuildPrimTy,
             decltype(createAllocator()),
             CreateAllocFunc,
             CreateNodeFunc,
@@ -0,0 +1,343 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "bvh_builder_sah.h"
+#include "bvh_builder_morton.h"
+#include "../../common/algorithms/parallel_prefix_sum.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /* Parallel locally-ordered clustering (PLOC) builder. The primitives
+     * are sorted along a Morton curve and each cluster gets merged with its
+     * nearest neighbour inside a small window of that order until a single
+     * cluster remains. The resulting binary tree is collapsed into an N-wide
+     * BVH by the generic SAH builder, which only decides on the node and
+     * leaf layout along the clustered tree. */
+    struct BVHBuilderPLOC
+    {
+      static const size_t SEARCH_RADIUS = 16;              //!< number of clusters searched to the left and right for the nearest neighbour
+      static const size_t NEIGHBOUR_BLOCK_SIZE = 256;      //!< number of clusters whose nearest neighbours get searched together
+      static const unsigned int INVALID_NODE = unsigned(-1);
+
+      /*! node of the binary clustering tree, the first nodes are the primitives */
+      struct Node
+      {
+        BBox3fa bounds;      //!< bounds of all primitives of the subtree
+        unsigned int left;   //!< left child of inner nodes
+        unsigned int right;  //!< right child of inner nodes
+        unsigned int size;   //!< number of primitives of the subtree
+        unsigned int begin;  //!< first primitive of the subtree after reordering
+      };
+
+      /*! range of primitives that belongs to a node of the clustering tree */
+      struct Set : public PrimInfoRange
+      {
+        __forceinline Set () {}
+
+        __forceinline Set (EmptyTy)
+          : PrimInfoRange(EmptyTy()), node(INVALID_NODE) {}
+
+        __forceinline Set (size_t begin, size_t end, const BBox3fa& bounds, unsigned int node)
+          : PrimInfoRange(begin,end,CentGeomBBox3fa(bounds,bounds)), node(node) {}
+
+      public:
+        unsigned int node;   //!< clustering tree node, invalid for fallback splits
+      };
+
+      /*! split along the clustering tree */
+      struct Split
+      {
+        __forceinline Split () {}
+
+        __forceinline Split (float sah)
+          : sah(sah) {}
+
+        __forceinline float splitSAH() const { return sah; }
+
+      public:
+        float sah;
+      };
+
+      /*! heuristic that follows the clustering tree */
+      struct Heuristic
+      {
+        typedef BVHBuilderPLOC::Split Split;
+
+        __forceinline Heuristic (PrimRef* prims, const Node* nodes, size_t numPrimitives)
+          : prims(prims), nodes(nodes), numPrimitives(numPrimitives) {}
+
+        __forceinline bool isInnerNode(unsigned int node) const {
+          return node != INVALID_NODE && node >= numPrimitives;
+        }
+
+        /*! the clustering tree already fixed the split, we only evaluate its SAH */
+        __forceinline const Split find(const Set& set, const size_t logBlockSize) const
+        {
+          if (!isInnerNode(set.node)) return Split(inf);
+          const Node& node = nodes[set.node];
+          const Node& lnode = nodes[node.left];
+          const Node& rnode = nodes[node.right];
+          const size_t blockSize = size_t(1) << logBlockSize;
+          const size_t lblocks = (lnode.size+blockSize-1) >> logBlockSize;
+          const size_t rblocks = (rnode.size+blockSize-1) >> logBlockSize;
+          return Split(halfArea(lnode.bounds)*float(lblocks) + halfArea(rnode.bounds)*float(rblocks));
+        }
+
+        __forceinline void split(const Split& split, const Set& set, Set& lset, Set& rset) const
+        {
+          assert(isInnerNode(set.node));
+          const Node& node = nodes[set.node];
+          const Node& lnode = nodes[node.left];
+          const Node& rnode = nodes[node.right];
+          lset = Set(lnode.begin,lnode.begin+lnode.size,lnode.bounds,node.left);
+          rset = Set(rnode.begin,rnode.begin+rnode.size,rnode.bounds,node.right);
+        }
+
+        /*! splits in the middle to guarantee logarithmic depth for large leaves */
+        void splitFallback(const Set& set, Set& lset, Set& rset) const
+        {
+          const size_t begin = set.begin();
+          const size_t end = set.end();
+          const size_t center = (begin+end)/2;
+
+          BBox3fa lbounds(empty), rbounds(empty);
+          for (size_t i=begin; i<center; i++) lbounds.extend(prims[i].bounds());
+          for (size_t i=center; i<end; i++) rbounds.extend(prims[i].bounds());
+          lset = Set(begin,center,lbounds,INVALID_NODE);
+          rset = Set(center,end,rbounds,INVALID_NODE);
+        }
+
+        /*! the primitive order is already deterministic */
+        __forceinline void deterministic_order(const Set& set) const {}
+
+      private:
+        PrimRef* const prims;
+        const Node* const nodes;
+        const size_t numPrimitives;
+      };
+
+      /*! number of clusters kept and inner nodes created by a merge step */
+      struct ClusterCount
+      {
+        __forceinline ClusterCount ()
+          : kept(0), merged(0) {}
+
+        __forceinline friend ClusterCount operator+ (const ClusterCount& a, const ClusterCount& b) {
+          ClusterCount c; c.kept = a.kept+b.kept; c.merged = a.merged+b.merged; return c;
+        }
+
+      public:
+        size_t kept;
+        size_t merged;
+      };
+
+      /*! builds the binary clustering tree and reorders the primitives into its leaf order, returns the root node */
+      static unsigned int cluster(MemoryMonitorInterface* device, PrimRef* prims, const PrimInfo& pinfo, Node* nodes, size_t singleThreadThreshold)
+      {
+        const size_t numPrimitives = pinfo.size();
+        const size_t radius = SEARCH_RADIUS;
+        mvector<unsigned int> clusterArray0(device,numPrimitives);
+        mvector<unsigned int> clusterArray1(device,numPrimitives);
+        mvector<unsigned int> neighbours(device,numPrimitives);
+        mvector<BBox3fa> clusterBoundsArray0(device,numPrimitives);
+        mvector<BBox3fa> clusterBoundsArray1(device,numPrimitives);
+        unsigned int* clusters = clusterArray0.data();
+        unsigned int* clustersTmp = clusterArray1.data();
+        BBox3fa* clusterBounds = clusterBoundsArray0.data();
+        BBox3fa* clusterBoundsTmp = clusterBoundsArray1.data();
+
+        /* sort primitives along the Morton curve of their centroids */
+        {
+          mvector<BVHBuilderMorton::BuildPrim> morton(device,numPrimitives);
+          mvector<BVHBuilderMorton::BuildPrim> mortonTmp(device,numPrimitives);
+          const BVHBuilderMorton::MortonCodeMapping mapping(pinfo.centBounds);
+          parallel_for(size_t(0), numPrimitives, size_t(1024), [&] (const range<size_t>& r) {
+              for (size_t i=r.begin(); i<r.end(); i++)
+              {
+                const BBox3fa bounds = prims[i].bounds();
+                morton[i].index = unsigned(i);
+                morton[i].code = mapping.code(bounds);
+                nodes[i].bounds = bounds;
+                nodes[i].left = nodes[i].right = INVALID_NODE;
+                nodes[i].size = 1;
+              }
+            });
+          radix_sort_u32(morton.data(),mortonTmp.data(),numPrimitives,singleThreadThreshold);
+
+          parallel_for(size_t(0), numPrimitives, size_t(1024), [&] (const range<size_t>& r) {
+              for (size_t i=r.begin(); i<r.end(); i++) {
+                clusters[i] = morton[i].index;
+                clusterBounds[i] = nodes[morton[i].index].bounds;
+              }
+            });
+        }
+
+        /* merge mutual nearest neighbours until a single cluster is left */
+        std::vector<size_t> levels;
+        levels.push_back(numPrimitives);
+        size_t numClusters = numPrimitives;
+        size_t numNodes = numPrimitives;
+        ParallelPrefixSumState<ClusterCount> pstate;
+
+        while (numClusters > 1)
+        {
+          /* the nearest neighbour minimizes the area of the merged cluster, ties are broken by the smaller index
+           * which guarantees that at least one mutual pair exists. Each pair inside the search window is
+           * evaluated once, blocks additionally evaluate the pairs that reach over their borders. */
+          parallel_for(size_t(0), numClusters, size_t(NEIGHBOUR_BLOCK_SIZE), [&] (const range<size_t>& r) {
+              float bestArea[NEIGHBOUR_BLOCK_SIZE+2*SEARCH_RADIUS];
+              unsigned int best[NEIGHBOUR_BLOCK_SIZE+2*SEARCH_RADIUS];
+              for (size_t begin=r.begin(); begin<r.end(); begin+=NEIGHBOUR_BLOCK_SIZE)
+              {
+                const size_t end = min(begin+NEIGHBOUR_BLOCK_SIZE,r.end());
+                const size_t wbegin = max(begin,radius)-radius;
+                const size_t wend = min(end+radius,numClusters);
+                for (size_t i=wbegin; i<wend; i++) {
+                  bestArea[i-wbegin] = inf;
+                  best[i-wbegin] = INVALID_NODE;
+                }
+
+                for (size_t i=wbegin; i<end; i++)
+                {
+                  const BBox3fa bounds = clusterBounds[i];
+                  const size_t jend = min(i+radius+1,wend);
+                  for (size_t j=max(i+1,begin); j<jend; j++)
+                  {
+                    const float a = halfArea(merge(bounds,clusterBounds[j]));
+                    if (a < bestArea[i-wbegin] || best[i-wbegin] == INVALID_NODE) {
+                      bestArea[i-wbegin] = a;
+                      best[i-wbegin] = unsigned(j);
+                    }
+                    if (a < bestArea[j-wbegin] || best[j-wbegin] == INVALID_NODE) {
+                      bestArea[j-wbegin] = a;
+                      best[j-wbegin] = unsigned(i);
+                    }
+                  }
+                }
+
+                for (size_t i=begin; i<end; i++)
+                  neighbours[i] = best[i-wbegin];
+              }
+            });
+
+          /* count kept clusters and new inner nodes per task, then merge and compact */
+          auto mergeClusters = [&] (const range<size_t>& r, const ClusterCount& base, bool write) -> ClusterCount
+          {
+            ClusterCount count;
+            for (size_t i=r.begin(); i<r.end(); i++)
+            {
+              const unsigned int j = neighbours[i];
+              if (neighbours[j] != i)
+              {
+                if (write) {
+                  clustersTmp[base.kept+count.kept] = clusters[i];
+                  clusterBoundsTmp[base.kept+count.kept] = clusterBounds[i];
+                }
+                count.kept++;
+              }
+              else if (i < j)
+              {
+                if (write)
+                {
+                  const size_t nodeID = numNodes+base.merged+count.merged;
+                  Node& node = nodes[nodeID];
+                  node.bounds = merge(clusterBounds[i],clusterBounds[j]);
+                  node.left = clusters[i];
+                  node.right = clusters[j];
+                  node.size = nodes[clusters[i]].size+nodes[clusters[j]].size;
+                  clustersTmp[base.kept+count.kept] = unsigned(nodeID);
+                  clusterBoundsTmp[base.kept+count.kept] = node.bounds;
+                }
+                count.kept++;
+                count.merged++;
+              }
+            }
+            return count;
+          };
+
+          parallel_prefix_sum(pstate, size_t(0), numClusters, size_t(1024), ClusterCount(), [&] (const range<size_t>& r, const ClusterCount& base) {
+              return mergeClusters(r,base,false);
+            }, std::plus<ClusterCount>());
+          const ClusterCount total = parallel_prefix_sum(pstate, size_t(0), numClusters, size_t(1024), ClusterCount(), [&] (const range<size_t>& r, const ClusterCount& base) {
+              return mergeClusters(r,base,true);
+            }, std::plus<ClusterCount>());
+
+          assert(total.merged > 0);
+          numClusters = total.kept;
+          numNodes += total.merged;
+          levels.push_back(numNodes);
+          std::swap(clusters,clustersTmp);
+          std::swap(clusterBounds,clusterBoundsTmp);
+        }
+
+        /* assign primitive ranges top down, all nodes of a level were created by the same merge step */
+        const unsigned int root = clusters[0];
+        nodes[root].begin = 0;
+        for (size_t l=levels.size()-1; l>0; l--)
+        {
+          parallel_for(levels[l-1], levels[l], size_t(1024), [&] (const range<size_t>& r) {
+              for (size_t i=r.begin(); i<r.end(); i++) {
+                const Node& node = nodes[i];
+                nodes[node.left ].begin = node.begin;
+                nodes[node.right].begin = node.begin+nodes[node.left].size;
+              }
+            });
+        }
+
+        /* reorder primitives such that each subtree owns a consecutive range */
+        mvector<PrimRef> primsTmp(device,numPrimitives);
+        parallel_for(size_t(0), numPrimitives, size_t(1024), [&] (const range<size_t>& r) {
+            for (size_t i=r.begin(); i<r.end(); i++)
+              primsTmp[nodes[i].begin] = prims[i];
+          });
+        parallel_for(size_t(0), numPrimitives, size_t(1024), [&] (const range<size_t>& r) {
+            for (size_t i=r.begin(); i<r.end(); i++)
+              prims[i] = primsTmp[i];
+          });
+
+        return root;
+      }
+
+      /*! special builder that propagates reduction over the tree */
+      template<
+      typename ReductionTy,
+        typename CreateAllocFunc,
+        typename CreateNodeFunc,
+        typename UpdateNodeFunc,
+        typename CreateLeafFunc,
+        typename ProgressMonitor>
+
+        static ReductionTy build(CreateAllocFunc createAlloc,
+                                 CreateNodeFunc createNode, UpdateNodeFunc updateNode,
+                                 const CreateLeafFunc& createLeaf,
+                                 const ProgressMonitor& progressMonitor,
+                                 MemoryMonitorInterface* device,
+                                 PrimRef* prims, const PrimInfo& pinfo,
+                                 GeneralBVHBuilder::Settings settings)
+      {
+        const size_t numPrimitives = pinfo.size();
+        mvector<Node> nodes(device,2*numPrimitives-1);
+        const unsigned int root = cluster(device,prims,pinfo,nodes.data(),settings.singleThreadThreshold);
+
+        /* single primitives can never get split */
+        settings.minLeafSize = max(settings.minLeafSize,size_t(1));
+
+        Heuristic heuristic(prims,nodes.data(),numPrimitives);
+        return GeneralBVHBuilder::build<ReductionTy,Heuristic,Set,PrimRef>(
+          heuristic,
+          prims,
+          Set(0,numPrimitives,nodes[root].bounds,root),
+          createAlloc,
+          createNode,
+          updateNode,
+          createLeaf,
+          progressMonitor,
+          settings);
+      }
+    };
+  }
+}
@@ -154,41 +154,57 @@ namespace embree
     }
 
     template<typename Mesh>
-    size_t createMortonCodeArray(Mesh* mesh, mvector<BVHBuilderMorton::BuildPrim>& morton, BuildProgressMonitor& progressMonitor)
+    MortonCodeInfo computeMortonCodeInfo(Mesh* mesh, size_t numPrimitives)
     {
-      size_t numPrimitives = morton.size();
-
-      /* compute scene bounds */
-      std::pair<size_t,BBox3fa> cb_empty(0,empty);
-      auto cb = parallel_reduce 
-        ( size_t(0), numPrimitives, size_t(1024), cb_empty, [&](const range<size_t>& r) -> std::pair<size_t,BBox3fa>
+      /* compute centroid bounds and accumulate primitive sizes */
+      struct Reduction {
+        size_t num;
+        BBox3fa bounds;
+        double size;
+      };
+      const Reduction empty_reduction = { 0, empty, 0.0 };
+      const Reduction cb = parallel_reduce 
+        ( size_t(0), numPrimitives, size_t(1024), empty_reduction, [&](const range<size_t>& r) -> Reduction
           {
-            size_t num = 0;
-            BBox3fa bounds = empty;
-            
+            Reduction red = { 0, empty, 0.0 };
             for (size_t j=r.begin(); j<r.end(); j++)
             {
               BBox3fa prim_bounds = empty;
               if (unlikely(!mesh->buildBounds(j,&prim_bounds))) continue;
-              bounds.extend(center2(prim_bounds));
-              num++;
+              red.bounds.extend(center2(prim_bounds));
+              red.size += reduce_max(prim_bounds.size());
+              red.num++;
             }
-            return std::make_pair(num,bounds);
-          }, [] (const std::pair<size_t,BBox3fa>& a, const std::pair<size_t,BBox3fa>& b) {
-          return std::make_pair(a.first + b.first,merge(a.second,b.second)); 
+            return red;
+          }, [] (const Reduction& a, const Reduction& b) -> Reduction {
+          const Reduction red = { a.num + b.num, merge(a.bounds,b.bounds), a.size + b.size };
+          return red;
         });
-      
-      
-      size_t numPrimitivesGen = cb.first;
-      const BBox3fa centBounds = cb.second;
+
+      MortonCodeInfo info;
+      info.numPrimitives = cb.num;
+      info.centBounds = cb.bounds;
+      info.primSize = cb.num ? float(cb.size/double(cb.num)) : 0.0f;
+      return info;
+    }
+
+    template<typename Mesh, typename BuildPrim>
+    size_t createMortonCodeArray(Mesh* mesh, const MortonCodeInfo& info, mvector<BuildPrim>& morton, BuildProgressMonitor& progressMonitor)
+    {
+      typedef typename BuildPrim::Mapping Mapping;
+      typedef typename BuildPrim::Generator Generator;
+
+      size_t numPrimitives = morton.size();
+      size_t numPrimitivesGen = info.numPrimitives;
+      const BBox3fa centBounds = info.centBounds;
       
       /* compute morton codes */
       if (likely(numPrimitivesGen == numPrimitives))
       {
         /* fast path if all primitives were valid */
-        BVHBuilderMorton::MortonCodeMapping mapping(centBounds);
+        Mapping mapping(centBounds);
         parallel_for( size_t(0), numPrimitives, size_t(1024), [&](const range<size_t>& r) -> void {
-            BVHBuilderMorton::MortonCodeGenerator generator(mapping,&morton.data()[r.begin()]);
+            Generator generator(mapping,&morton.data()[r.begin()]);
             for (size_t j=r.begin(); j<r.end(); j++)
               generator(mesh->bounds(j),unsigned(j));
           });
@@ -197,10 +213,10 @@ namespace embree
       {
         /* slow path, fallback in case some primitives were invalid */
         ParallelPrefixSumState<size_t> pstate;
-        BVHBuilderMorton::MortonCodeMapping mapping(centBounds);
+        Mapping mapping(centBounds);
         parallel_prefix_sum( pstate, size_t(0), numPrimitives, size_t(1024), size_t(0), [&](const range<size_t>& r, const size_t base) -> size_t {
             size_t num = 0;
-            BVHBuilderMorton::MortonCodeGenerator generator(mapping,&morton.data()[r.begin()]);
+            Generator generator(mapping,&morton.data()[r.begin()]);
             for (size_t j=r.begin(); j<r.end(); j++)
             {
               BBox3fa bounds = empty;
@@ -213,7 +229,7 @@ namespace embree
         
         parallel_prefix_sum( pstate, size_t(0), numPrimitives, size_t(1024), size_t(0), [&](const range<size_t>& r, const size_t base) -> size_t {
             size_t num = 0;
-            BVHBuilderMorton::MortonCodeGenerator generator(mapping,&morton.data()[base]);
+            Generator generator(mapping,&morton.data()[base]);
             for (size_t j=r.begin(); j<r.end(); j++)
             {
               BBox3fa bounds = empty;
@@ -350,9 +366,18 @@ namespace embree
     // ====================================================================================================
     // ====================================================================================================
     
-    IF_ENABLED_TRIS (template size_t createMortonCodeArray<TriangleMesh>(TriangleMesh* mesh COMMA mvector<BVHBuilderMorton::BuildPrim>& morton COMMA BuildProgressMonitor& progressMonitor));
-    IF_ENABLED_QUADS(template size_t createMortonCodeArray<QuadMesh>(QuadMesh* mesh COMMA mvector<BVHBuilderMorton::BuildPrim>& morton COMMA BuildProgressMonitor& progressMonitor));
-    IF_ENABLED_USER (template size_t createMortonCodeArray<UserGeometry>(UserGeometry* mesh COMMA mvector<BVHBuilderMorton::BuildPrim>& morton COMMA BuildProgressMonitor& progressMonitor));
-    IF_ENABLED_INSTANCE (template size_t createMortonCodeArray<Instance>(Instance* mesh COMMA mvector<BVHBuilderMorton::BuildPrim>& morton COMMA BuildProgressMonitor& progressMonitor));
+    IF_ENABLED_TRIS (template MortonCodeInfo computeMortonCodeInfo<TriangleMesh>(TriangleMesh* mesh COMMA size_t numPrimitives));
+    IF_ENABLED_QUADS(template MortonCodeInfo computeMortonCodeInfo<QuadMesh>(QuadMesh* mesh COMMA size_t numPrimitives));
+    IF_ENABLED_USER (template MortonCodeInfo computeMortonCodeInfo<UserGeometry>(UserGeometry* mesh COMMA size_t numPrimitives));
+    IF_ENABLED_INSTANCE (template MortonCodeInfo computeMortonCodeInfo<Instance>(Instance* mesh COMMA size_t numPrimitives));
+
+    IF_ENABLED_TRIS (template size_t createMortonCodeArray<TriangleMesh COMMA BVHBuilderMorton::BuildPrim>(TriangleMesh* mesh COMMA const MortonCodeInfo& info COMMA mvector<BVHBuilderMorton::BuildPrim>& morton COMMA BuildProgressMonitor& progressMonitor));
+    IF_ENABLED_TRIS (template size_t createMortonCodeArray<TriangleMesh COMMA BVHBuilderMorton::BuildPrim64>(TriangleMesh* mesh COMMA const MortonCodeInfo& info COMMA mvector<BVHBuilderMorton::BuildPrim64>& morton COMMA BuildProgressMonitor& progressMonitor));
+    IF_ENABLED_QUADS(template size_t createMortonCodeArray<QuadMesh COMMA BVHBuilderMorton::BuildPrim>(QuadMesh* mesh COMMA const MortonCodeInfo& info COMMA mvector<BVHBuilderMorton::BuildPrim>& morton COMMA BuildProgressMonitor& progressMonitor));
+    IF_ENABLED_QUADS(template size_t createMortonCodeArray<QuadMesh COMMA BVHBuilderMorton::BuildPrim64>(QuadMesh* mesh COMMA const MortonCodeInfo& info COMMA mvector<BVHBuilderMorton::BuildPrim64>& morton COMMA BuildProgressMonitor& progressMonitor));
+    IF_ENABLED_USER (template size_t createMortonCodeArray<UserGeometry COMMA BVHBuilderMorton::BuildPrim>(UserGeometry* mesh COMMA const MortonCodeInfo& info COMMA mvector<BVHBuilderMorton::BuildPrim>& morton COMMA BuildProgressMonitor& progressMonitor));
+    IF_ENABLED_USER (template size_t createMortonCodeArray<UserGeometry COMMA BVHBuilderMorton::BuildPrim64>(UserGeometry* mesh COMMA const MortonCodeInfo& info COMMA mvector<BVHBuilderMorton::BuildPrim64>& morton COMMA BuildProgressMonitor& progressMonitor));
+    IF_ENABLED_INSTANCE (template size_t createMortonCodeArray<Instance COMMA BVHBuilderMorton::BuildPrim>(Instance* mesh COMMA const MortonCodeInfo& info COMMA mvector<BVHBuilderMorton::BuildPrim>& morton COMMA BuildProgressMonitor& progressMonitor));
+    IF_ENABLED_INSTANCE (template size_t createMortonCodeArray<Instance COMMA BVHBuilderMorton::BuildPrim64>(Instance* mesh COMMA const MortonCodeInfo& info COMMA mvector<BVHBuilderMorton::BuildPrim64>& morton COMMA BuildProgressMonitor& progressMonitor));
   }
 }
@@ -25,8 +25,19 @@ namespace embree
 
     PrimInfoMB createPrimRefArrayMSMBlur(Scene* scene, Geometry::GTypeMask types, size_t numPrimitives, mvector<PrimRefMB>& prims, mvector<SubGridBuildData>& sgrids, BuildProgressMonitor& progressMonitor, BBox1f t0t1 = BBox1f(0.0f,1.0f));
 
+    /*! number of valid primitives, bounds of their centroids and their average size, used to set up morton codes */
+    struct MortonCodeInfo
+    {
+      size_t numPrimitives;
+      BBox3fa centBounds;
+      float primSize;
+    };
+
     template<typename Mesh>
-      size_t createMortonCodeArray(Mesh* mesh, mvector<BVHBuilderMorton::BuildPrim>& morton, BuildProgressMonitor& progressMonitor);
+      MortonCodeInfo computeMortonCodeInfo(Mesh* mesh, size_t numPrimitives);
+
+    template<typename Mesh, typename BuildPrim>
+      size_t createMortonCodeArray(Mesh* mesh, const MortonCodeInfo& info, mvector<BuildPrim>& morton, BuildProgressMonitor& progressMonitor);
 
     /* special variants for grids */
     PrimInfo createPrimRefArrayGrids(Scene* scene, mvector<PrimRef>& prims, mvector<SubGridBuildData>& sgrids); // FIXME: remove
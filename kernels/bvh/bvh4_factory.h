@@ -277,6 +277,27 @@ namespace embree
     DEFINE_ISA_FUNCTION(Builder*,BVH4GridSceneBuilderSAH,void* COMMA Scene* COMMA size_t);
     DEFINE_ISA_FUNCTION(Builder*,BVH4GridMBSceneBuilderSAH,void* COMMA Scene* COMMA size_t);
 
+    // treelet restructuring pass for RTC_BUILD_QUALITY_OPTIMIZED
+  public:
+    DEFINE_ISA_FUNCTION(void,BVH4TreeletOptimize,void* COMMA double);
+
+    // depth first relayout for RTC_SCENE_FLAG_DETERMINISTIC, hot first relayout for bvh_layout=hot_first
+    DEFINE_ISA_FUNCTION(void,BVH4Relayout,void*);
+
+    // PLOC scene builders
+  private:
+    DEFINE_ISA_FUNCTION(Builder*,BVH4Triangle4SceneBuilderPLOC,void* COMMA Scene* COMMA size_t);
+    DEFINE_ISA_FUNCTION(Builder*,BVH4Triangle4vSceneBuilderPLOC,void* COMMA Scene* COMMA size_t);
+    DEFINE_ISA_FUNCTION(Builder*,BVH4Triangle4iSceneBuilderPLOC,void* COMMA Scene* COMMA size_t);
+    DEFINE_ISA_FUNCTION(Builder*,BVH4Quad4vSceneBuilderPLOC,void* COMMA Scene* COMMA size_t);
+    DEFINE_ISA_FUNCTION(Builder*,BVH4Quad4iSceneBuilderPLOC,void* COMMA Scene* COMMA size_t);
+    DEFINE_ISA_FUNCTION(Builder*,BVH4VirtualSceneBuilderPLOC,void* COMMA Scene* COMMA size_t);
+    DEFINE_ISA_FUNCTION(Builder*,BVH4InstanceSceneBuilderPLOC,void* COMMA Scene* COMMA Geometry::GTypeMask);
+
+    // on-disk BVH cache
+  private:
+    DEFINE_ISA_FUNCTION(Builder*,BVH4CacheBuilder,void* COMMA Geometry::GTypeMask COMMA Builder*);
+
     // spatial scene builder
   private:
     DEFINE_ISA_FUNCTION(Builder*,BVH4Triangle4SceneBuilderFastSpatialSAH,void* COMMA Scene* COMMA size_t);
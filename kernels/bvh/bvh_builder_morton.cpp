@@ -76,17 +76,17 @@ namespace embree
       }
     };
 
-    template<int N, typename Primitive>
+    template<int N, typename Primitive, typename BuildPrim>
     struct CreateMortonLeaf;
 
-    template<int N>
-    struct CreateMortonLeaf<N,Triangle4>
+    template<int N, typename BuildPrim>
+    struct CreateMortonLeaf<N,Triangle4,BuildPrim>
     {
       typedef BVHN<N> BVH;
       typedef typename BVH::NodeRef NodeRef;
       typedef typename BVH::NodeRecord NodeRecord;
 
-      __forceinline CreateMortonLeaf (TriangleMesh* mesh, unsigned int geomID, BVHBuilderMorton::BuildPrim* morton)
+      __forceinline CreateMortonLeaf (TriangleMesh* mesh, unsigned int geomID, BuildPrim* morton)
         : mesh(mesh), morton(morton), geomID_(geomID) {}
 
       __noinline NodeRecord operator() (const range<unsigned>& current, const FastAllocator::CachedAllocator& alloc)
@@ -131,18 +131,18 @@ namespace embree
     
     private:
       TriangleMesh* mesh;
-      BVHBuilderMorton::BuildPrim* morton;
+      BuildPrim* morton;
       unsigned int geomID_ = std::numeric_limits<unsigned int>::max();
     };
     
-    template<int N>
-    struct CreateMortonLeaf<N,Triangle4v>
+    template<int N, typename BuildPrim>
+    struct CreateMortonLeaf<N,Triangle4v,BuildPrim>
     {
       typedef BVHN<N> BVH;
       typedef typename BVH::NodeRef NodeRef;
       typedef typename BVH::NodeRecord NodeRecord;
 
-      __forceinline CreateMortonLeaf (TriangleMesh* mesh, unsigned int geomID, BVHBuilderMorton::BuildPrim* morton)
+      __forceinline CreateMortonLeaf (TriangleMesh* mesh, unsigned int geomID, BuildPrim* morton)
         : mesh(mesh), morton(morton), geomID_(geomID) {}
       
       __noinline NodeRecord operator() (const range<unsigned>& current, const FastAllocator::CachedAllocator& alloc)
@@ -185,18 +185,18 @@ namespace embree
       }
     private:
       TriangleMesh* mesh;
-      BVHBuilderMorton::BuildPrim* morton;
+      BuildPrim* morton;
       unsigned int geomID_ = std::numeric_limits<unsigned int>::max();
     };
 
-    template<int N>
-    struct CreateMortonLeaf<N,Triangle4i>
+    template<int N, typename BuildPrim>
+    struct CreateMortonLeaf<N,Triangle4i,BuildPrim>
     {
       typedef BVHN<N> BVH;
       typedef typename BVH::NodeRef NodeRef;
       typedef typename BVH::NodeRecord NodeRecord;
 
-      __forceinline CreateMortonLeaf (TriangleMesh* mesh, unsigned int geomID, BVHBuilderMorton::BuildPrim* morton)
+      __forceinline CreateMortonLeaf (TriangleMesh* mesh, unsigned int geomID, BuildPrim* morton)
         : mesh(mesh), morton(morton), geomID_(geomID) {}
       
       __noinline NodeRecord operator() (const range<unsigned>& current, const FastAllocator::CachedAllocator& alloc)
@@ -250,18 +250,18 @@ namespace embree
       }
     private:
       TriangleMesh* mesh;
-      BVHBuilderMorton::BuildPrim* morton;
+      BuildPrim* morton;
       unsigned int geomID_ = std::numeric_limits<unsigned int>::max();
     };
 
-    template<int N>
-    struct CreateMortonLeaf<N,Quad4v>
+    template<int N, typename BuildPrim>
+    struct CreateMortonLeaf<N,Quad4v,BuildPrim>
     {
       typedef BVHN<N> BVH;
       typedef typename BVH::NodeRef NodeRef;
       typedef typename BVH::NodeRecord NodeRecord;
 
-      __forceinline CreateMortonLeaf (QuadMesh* mesh, unsigned int geomID, BVHBuilderMorton::BuildPrim* morton)
+      __forceinline CreateMortonLeaf (QuadMesh* mesh, unsigned int geomID, BuildPrim* morton)
         : mesh(mesh), morton(morton), geomID_(geomID) {}
       
       __noinline NodeRecord operator() (const range<unsigned>& current, const FastAllocator::CachedAllocator& alloc)
@@ -307,18 +307,18 @@ namespace embree
       }
     private:
       QuadMesh* mesh;
-      BVHBuilderMorton::BuildPrim* morton;
+      BuildPrim* morton;
       unsigned int geomID_ = std::numeric_limits<unsigned int>::max();
     };
 
-    template<int N>
-    struct CreateMortonLeaf<N,Object>
+    template<int N, typename BuildPrim>
+    struct CreateMortonLeaf<N,Object,BuildPrim>
     {
       typedef BVHN<N> BVH;
       typedef typename BVH::NodeRef NodeRef;
       typedef typename BVH::NodeRecord NodeRecord;
 
-      __forceinline CreateMortonLeaf (UserGeometry* mesh, unsigned int geomID, BVHBuilderMorton::BuildPrim* morton)
+      __forceinline CreateMortonLeaf (UserGeometry* mesh, unsigned int geomID, BuildPrim* morton)
         : mesh(mesh), morton(morton), geomID_(geomID) {}
       
       __noinline NodeRecord operator() (const range<unsigned>& current, const FastAllocator::CachedAllocator& alloc)
@@ -351,18 +351,18 @@ namespace embree
       }
     private:
       UserGeometry* mesh;
-      BVHBuilderMorton::BuildPrim* morton;
+      BuildPrim* morton;
       unsigned int geomID_ = std::numeric_limits<unsigned int>::max();
     };
 
-    template<int N>
-    struct CreateMortonLeaf<N,InstancePrimitive>
+    template<int N, typename BuildPrim>
+    struct CreateMortonLeaf<N,InstancePrimitive,BuildPrim>
     {
       typedef BVHN<N> BVH;
       typedef typename BVH::NodeRef NodeRef;
       typedef typename BVH::NodeRecord NodeRecord;
 
-      __forceinline CreateMortonLeaf (Instance* mesh, unsigned int geomID, BVHBuilderMorton::BuildPrim* morton)
+      __forceinline CreateMortonLeaf (Instance* mesh, unsigned int geomID, BuildPrim* morton)
         : mesh(mesh), morton(morton), geomID_(geomID) {}
       
       __noinline NodeRecord operator() (const range<unsigned>& current, const FastAllocator::CachedAllocator& alloc)
@@ -395,17 +395,17 @@ namespace embree
       }
     private:
       Instance* mesh;
-      BVHBuilderMorton::BuildPrim* morton;
+      BuildPrim* morton;
       unsigned int geomID_ = std::numeric_limits<unsigned int>::max();
     };
 
-    template<typename Mesh>
+    template<typename Mesh, typename BuildPrim>
     struct CalculateMeshBounds
     {
       __forceinline CalculateMeshBounds (Mesh* mesh)
         : mesh(mesh) {}
       
-      __forceinline const BBox3fa operator() (const BVHBuilderMorton::BuildPrim& morton) {
+      __forceinline const BBox3fa operator() (const BuildPrim& morton) {
         return mesh->bounds(morton.index);
       }
       
@@ -424,40 +424,62 @@ namespace embree
     public:
       
       BVHNMeshBuilderMorton (BVH* bvh, Mesh* mesh, unsigned int geomID, const size_t minLeafSize, const size_t maxLeafSize, const size_t singleThreadThreshold = DEFAULT_SINGLE_THREAD_THRESHOLD)
-        : bvh(bvh), mesh(mesh), morton(bvh->device,0), settings(N,BVH::maxBuildDepth,minLeafSize,min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks),singleThreadThreshold), geomID_(geomID) {}
+        : bvh(bvh), mesh(mesh), morton(bvh->device,0), morton64(bvh->device,0), settings(N,BVH::maxBuildDepth,minLeafSize,min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks),singleThreadThreshold), geomID_(geomID) {}
       
       /* build function */
       void build() 
       {
-        /* we reset the allocator when the mesh size changed */
-        if (mesh->numPrimitives != numPreviousPrimitives) {
-          bvh->alloc.clear();
-          morton.clear();
-        }
         size_t numPrimitives = mesh->size();
-        numPreviousPrimitives = numPrimitives;
         
         /* skip build for empty scene */
         if (numPrimitives == 0) {
+          if (mesh->numPrimitives != numPreviousPrimitives) {
+            bvh->alloc.clear();
+            morton.clear();
+            morton64.clear();
+          }
+          numPreviousPrimitives = numPrimitives;
           bvh->set(BVH::emptyNode,empty,0);
           return;
         }
+
+        /* use 64 bit morton codes for large scenes with primitives much smaller than the 32 bit morton code lattice */
+        const MortonCodeInfo info = computeMortonCodeInfo(mesh,numPrimitives);
+        const bool useMortonCodes64 = BVHBuilderMorton::useMortonCodes64(info.numPrimitives,info.centBounds,info.primSize);
+
+        /* we reset the allocator when the mesh size or the morton code size changed */
+        if (mesh->numPrimitives != numPreviousPrimitives || useMortonCodes64 != previousMortonCodes64) {
+          bvh->alloc.clear();
+          morton.clear();
+          morton64.clear();
+        }
+        numPreviousPrimitives = numPrimitives;
+        previousMortonCodes64 = useMortonCodes64;
+
+        if (useMortonCodes64) build(morton64,info);
+        else                  build(morton,info);
+      }
+
+      template<typename BuildPrim>
+      void build(mvector<BuildPrim>& morton, const MortonCodeInfo& info)
+      {
+        size_t numPrimitives = mesh->size();
         
         /* preallocate arrays */
         morton.resize(numPrimitives);
         size_t bytesEstimated = numPrimitives*sizeof(AABBNode)/(4*N) + size_t(1.2f*Primitive::blocks(numPrimitives)*sizeof(Primitive));
-        size_t bytesMortonCodes = numPrimitives*sizeof(BVHBuilderMorton::BuildPrim);
+        size_t bytesMortonCodes = numPrimitives*sizeof(BuildPrim);
         bytesEstimated = max(bytesEstimated,bytesMortonCodes); // the first allocation block is reused to sort the morton codes
         bvh->alloc.init(bytesMortonCodes,bytesMortonCodes,bytesEstimated);
 
         /* create morton code array */
-        BVHBuilderMorton::BuildPrim* dest = (BVHBuilderMorton::BuildPrim*) bvh->alloc.specialAlloc(bytesMortonCodes);
-        size_t numPrimitivesGen = createMortonCodeArray<Mesh>(mesh,morton,bvh->scene->progressInterface);
+        BuildPrim* dest = (BuildPrim*) bvh->alloc.specialAlloc(bytesMortonCodes);
+        size_t numPrimitivesGen = createMortonCodeArray<Mesh>(mesh,info,morton,bvh->scene->progressInterface);
 
         /* create BVH */
         SetBVHNBounds<N> setBounds(bvh);
-        CreateMortonLeaf<N,Primitive> createLeaf(mesh,geomID_,morton.data());
-        CalculateMeshBounds<Mesh> calculateBounds(mesh);
+        CreateMortonLeaf<N,Primitive,BuildPrim> createLeaf(mesh,geomID_,morton.data());
+        CalculateMeshBounds<Mesh,BuildPrim> calculateBounds(mesh);
         auto root = BVHBuilderMorton::build<NodeRecord>(
           typename BVH::CreateAlloc(bvh), 
           typename BVH::AABBNode::Create(),
@@ -484,15 +506,18 @@ namespace embree
       
       void clear() {
         morton.clear();
+        morton64.clear();
       }
       
     private:
       BVH* bvh;
       Mesh* mesh;
       mvector<BVHBuilderMorton::BuildPrim> morton;
+      mvector<BVHBuilderMorton::BuildPrim64> morton64;
       BVHBuilderMorton::Settings settings;
       unsigned int geomID_ = std::numeric_limits<unsigned int>::max();
       unsigned int numPreviousPrimitives = 0;
+      bool previousMortonCodes64 = false;
     };
 
 #if defined(EMBREE_GEOMETRY_TRIANGLE)
@@ -5,6 +5,7 @@
 #include "bvh_builder.h"
 #include "../builders/primrefgen.h"
 #include "../builders/splitter.h"
+#include "../builders/bvh_builder_hair.h"
 
 #include "../geometry/linei.h"
 #include "../geometry/triangle.h"
@@ -280,6 +281,90 @@ namespace embree
     /************************************************************************************/
 
 
+    /*! builds a BVH with mixed aligned and oriented nodes over triangles or quads */
+    template<int N, typename Primitive>
+    struct BVHNBuilderOBBSAH : public Builder
+    {
+      typedef BVHN<N> BVH;
+      typedef typename BVH::NodeRef NodeRef;
+
+      BVH* bvh;
+      Scene* scene;
+      mvector<PrimRef> prims;
+      BVHBuilderHair::Settings settings;
+      Geometry::GTypeMask gtype_;
+
+      BVHNBuilderOBBSAH (BVH* bvh, Scene* scene, const Geometry::GTypeMask gtype)
+        : bvh(bvh), scene(scene), prims(scene->device,0), gtype_(gtype) {}
+
+      void build()
+      {
+        /* skip build for empty scene */
+        const size_t numPrimitives = scene->getNumPrimitives(gtype_,false);
+        if (numPrimitives == 0) {
+          bvh->clear();
+          prims.clear();
+          return;
+        }
+
+        double t0 = bvh->preBuild(TOSTRING(isa) "::BVH" + toString(N) + "BuilderOBBSAH");
+
+        /* create primref array */
+        prims.resize(numPrimitives);
+        const PrimInfo pinfo = createPrimRefArray(scene,gtype_,false,numPrimitives,prims,scene->progressInterface);
+
+        /* pinfo might has zero size due to invalid geometry */
+        if (unlikely(pinfo.size() == 0))
+        {
+          bvh->clear();
+          prims.clear();
+          return;
+        }
+
+        /* estimate acceleration structure size */
+        const size_t node_bytes = pinfo.size()*sizeof(typename BVH::OBBNode)/(4*N);
+        const size_t leaf_bytes = size_t(1.2*Primitive::blocks(pinfo.size())*sizeof(Primitive));
+        bvh->alloc.init_estimate(node_bytes+leaf_bytes);
+
+        /* builder settings */
+        settings.branchingFactor = N;
+        settings.maxDepth = BVH::maxBuildDepthLeaf;
+        settings.logBlockSize = bsf(Primitive::max_size());
+        settings.minLeafSize = Primitive::max_size();
+        settings.maxLeafSize = Primitive::max_size();
+        settings.singleGeometryLeaves = false;
+
+        /* the hair builder chooses oriented splits whenever their SAH beats the aligned ones, leaves may mix geometries */
+        NodeRef root = BVHBuilderHair::build<NodeRef>
+          (typename BVH::CreateAlloc(bvh),
+           typename BVH::AABBNode::Create(),
+           typename BVH::AABBNode::Set(),
+           typename BVH::OBBNode::Create(),
+           typename BVH::OBBNode::Set(),
+           CreateLeaf<N,Primitive>(bvh),scene->progressInterface,
+           [] (const range<size_t>& range) {},
+           scene,prims.data(),pinfo,settings);
+
+        bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
+
+        /* clear temporary data for static geometry */
+        if (scene->isStaticAccel()) {
+          prims.clear();
+        }
+        bvh->cleanup();
+        bvh->postBuild(t0);
+      }
+
+      void clear() {
+        prims.clear();
+      }
+    };
+
+    /************************************************************************************/
+    /************************************************************************************/
+    /************************************************************************************/
+    /************************************************************************************/
+
     template<int N, typename Primitive>
     struct CreateLeafGrid
     {
@@ -468,6 +553,7 @@ namespace embree
     Builder* BVH8Triangle4iSceneBuilderSAH     (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAH<8,Triangle4i>((BVH8*)bvh,scene,4,1.0f,4,inf,TriangleMesh::geom_type,true); }
     Builder* BVH8QuantizedTriangle4iSceneBuilderSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHQuantized<8,Triangle4i>((BVH8*)bvh,scene,4,1.0f,4,inf,TriangleMesh::geom_type); }
     Builder* BVH8QuantizedTriangle4SceneBuilderSAH  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHQuantized<8,Triangle4>((BVH8*)bvh,scene,4,1.0f,4,inf,TriangleMesh::geom_type); }
+    Builder* BVH8Triangle4vSceneBuilderOBB  (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderOBBSAH<8,Triangle4v>((BVH8*)bvh,scene,TriangleMesh::geom_type); }
 
     
 
@@ -488,6 +574,7 @@ namespace embree
     Builder* BVH8QuantizedQuad4vSceneBuilderSAH     (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHQuantized<8,Quad4v>((BVH8*)bvh,scene,4,1.0f,4,inf,QuadMesh::geom_type); }
     Builder* BVH8QuantizedQuad4iSceneBuilderSAH     (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderSAHQuantized<8,Quad4i>((BVH8*)bvh,scene,4,1.0f,4,inf,QuadMesh::geom_type); }
     Builder* BVH8Quad4vMeshBuilderSAH     (void* bvh, QuadMesh* mesh, unsigned int geomID, size_t mode)     { return new BVHNBuilderSAH<8,Quad4v>((BVH8*)bvh,mesh,geomID,4,1.0f,4,inf,QuadMesh::geom_type); }
+    Builder* BVH8Quad4vSceneBuilderOBB     (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderOBBSAH<8,Quad4v>((BVH8*)bvh,scene,QuadMesh::geom_type); }
 
 #endif
 #endif
@@ -7,10 +7,13 @@
 
 #include "bvh_builder_twolevel.h"
 #include "bvh_statistics.h"
+#include "bvh_refit.h"
+#include "bvh_relayout.h"
 #include "../builders/bvh_builder_sah.h"
 #include "../common/scene_line_segments.h"
 #include "../common/scene_triangle_mesh.h"
 #include "../common/scene_quad_mesh.h"
+#include "../common/content_hash.h"
 
 #define PROFILE 0
 
@@ -48,26 +51,17 @@ namespace embree
       while(1) 
 #endif
       {
-      /* reset memory allocator */
-      bvh->alloc.reset();
-      
       /* skip build for empty scene */
       const size_t numPrimitives = scene->getNumPrimitives(gtype,false);
 
       if (numPrimitives == 0) {
+        bvh->alloc.reset();
+        clearTopLevel();
         prims.resize(0);
         bvh->set(BVH::emptyNode,empty,0);
         return;
       }
 
-      /* calculate the size of the entire BVH */
-      const size_t numLeafBlocks = Primitive::blocks(numPrimitives);
-      const size_t node_bytes = 2*numLeafBlocks*sizeof(typename BVH::AABBNode)/N;
-      const size_t leaf_bytes = size_t(1.2*numLeafBlocks*sizeof(Primitive));
-      bvh->alloc.init_estimate(node_bytes+leaf_bytes); 
-
-      double t0 = bvh->preBuild(TOSTRING(isa) "::BVH" + toString(N) + "BuilderTwoLevel");
-
       /* resize object array if scene got larger */
       if (bvh->objects.size()  < num) bvh->objects.resize(num);
       if (builders.size() < num) builders.resize(num);
@@ -93,19 +87,41 @@ namespace embree
         }
       });
 
-      /* parallel build of acceleration structures */
-      parallel_for(size_t(0), num, [&] (const range<size_t>& r)
+      findDuplicates();
+
+#if ENABLE_INCREMENTAL_TOP_LEVEL
+      /* only update the changed objects in the top level hierarchy of the last build */
+      if (buildIncremental(numPrimitives))
+        return;
+#endif
+
+      /* reset memory allocator */
+      bvh->alloc.reset();
+
+      /* calculate the size of the entire BVH */
+      const size_t numLeafBlocks = Primitive::blocks(numPrimitives);
+      const size_t node_bytes = 2*numLeafBlocks*sizeof(typename BVH::AABBNode)/N;
+      const size_t leaf_bytes = size_t(1.2*numLeafBlocks*sizeof(Primitive));
+      bvh->alloc.init_estimate(node_bytes+leaf_bytes); 
+
+      double t0 = bvh->preBuild(TOSTRING(isa) "::BVH" + toString(N) + "BuilderTwoLevel");
+
+      /* parallel build of acceleration structures, duplicates get copied after their prototypes got built */
+      for (size_t pass=0; pass<(numDuplicates ? 2 : 1); pass++)
       {
-        for (size_t objectID=r.begin(); objectID<r.end(); objectID++)
+        parallel_for(size_t(0), num, [&] (const range<size_t>& r)
         {
-          /* ignore if no triangle mesh or not enabled */
-          Mesh* mesh = scene->getSafe<Mesh>(objectID);
-          if (mesh == nullptr || !mesh->isEnabled() || mesh->numTimeSteps != 1) 
-            continue;
+          for (size_t objectID=r.begin(); objectID<r.end(); objectID++)
+          {
+            /* ignore if no triangle mesh or not enabled */
+            Mesh* mesh = scene->getSafe<Mesh>(objectID);
+            if (mesh == nullptr || !mesh->isEnabled() || mesh->numTimeSteps != 1 || isDuplicate(objectID) != (pass == 1))
+              continue;
 
-          builders[objectID]->attachBuildRefs (this);
-        }
-      });
+            builders[objectID]->attachBuildRefs (this);
+          }
+        });
+      }
 
 
 #if PROFILE
@@ -113,6 +129,7 @@ namespace embree
 #endif
       /* fast path for single geometry scenes */
       if (nextRef == 1) { 
+        clearTopLevel();
         bvh->set(refs[0].node,LBBox3fa(refs[0].bounds()),numPrimitives);
       }
 
@@ -158,8 +175,10 @@ namespace embree
 #endif   
        
           /* skip if all objects where empty */
-          if (pinfo.size() == 0)
+          if (pinfo.size() == 0) {
+            clearTopLevel();
             bvh->set(BVH::emptyNode,empty,0);
+          }
         
           /* otherwise build toplevel hierarchy */
           else
@@ -178,6 +197,9 @@ namespace embree
 #if ENABLE_DIRECT_SAH_MERGE_BUILDER
             
             refs.resize(extSize); 
+
+            /* remember the object of each top level leaf for later incremental updates */
+            std::vector<std::pair<size_t,unsigned int>> leafObjects(extSize,std::make_pair(size_t(BVH::emptyNode),0u));
          
             NodeRef root = BVHBuilderBinnedOpenMergeSAH::build<NodeRef,BuildRef>(
               typename BVH::CreateAlloc(bvh),
@@ -186,6 +208,7 @@ namespace embree
               
               [&] (const BuildRef* refs, const range<size_t>& range, const FastAllocator::CachedAllocator& alloc) -> NodeRef  {
                 assert(range.size() == 1);
+                leafObjects[range.begin()] = std::make_pair(size_t(refs[range.begin()].node),refs[range.begin()].geomID());
                 return (NodeRef) refs[range.begin()].node;
               },
               [&] (BuildRef &bref, BuildRef *refs) -> size_t { 
@@ -193,6 +216,8 @@ namespace embree
               },              
               [&] (size_t dn) { bvh->scene->progressMonitor(0); },
               refs.data(),extSize,pinfo,settings);
+
+            createTopLevel(root,leafObjects);
 #else
             NodeRef root = BVHBuilderBinnedSAH::build<NodeRef>(
               typename BVH::CreateAlloc(bvh),
@@ -205,6 +230,8 @@ namespace embree
               },
               [&] (size_t dn) { bvh->scene->progressMonitor(0); },
               prims.data(),pinfo,settings);
+
+            clearTopLevel();
 #endif
 
             
@@ -241,6 +268,423 @@ namespace embree
         if (builders[i]) builders[i].reset();
 
       refs.clear();
+      clearTopLevel();
+    }
+
+    // ===========================================================================
+    // incremental top level updates
+    // ===========================================================================
+
+    /* bounds of geometries that change without a geometry commit, such as instances of a recommitted scene */
+    __forceinline bool dependentBounds(const Geometry* geometry, BBox3fa& bounds) {
+      return false;
+    }
+
+    __forceinline bool dependentBounds(const Instance* instance, BBox3fa& bounds)
+    {
+      if (!instance->buildBounds(0,&bounds)) bounds = empty;
+      return true;
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    bool BVHNBuilderTwoLevel<N,Mesh,Primitive>::buildIncremental(size_t numPrimitives)
+    {
+      if (topRoot == invalidTopID)
+        return false;
+
+      /* rebuild from scratch if the hierarchy got degraded by many updates or wastes too much memory */
+      if (numIncrementalUpdates > numTopLeaves || 2*garbageBytes > bvh->alloc.getUsedBytes())
+        return false;
+
+      /* find objects that got added, removed, or modified */
+      const size_t maxChanged = size_t(INCREMENTAL_MAX_CHANGED_FRACTION*float(numTopLeaves));
+      const size_t num = scene->size();
+      if (objectLeaves.size() < num) objectLeaves.resize(num);
+      std::vector<size_t> changed;
+      
+      for (size_t objectID=0; objectID<objectLeaves.size(); objectID++)
+      {
+        Mesh* mesh = objectID < num ? scene->getSafe<Mesh>(objectID) : nullptr;
+        if (mesh == nullptr || !mesh->isEnabled() || mesh->numTimeSteps != 1)
+        {
+          if (!objectLeaves[objectID].empty())
+            changed.push_back(objectID);
+        }
+        else if (isGeometryModified(objectID))
+          changed.push_back(objectID);
+        else
+        {
+          BBox3fa bounds;
+          if (dependentBounds(mesh,bounds))
+          {
+            const std::vector<size_t>& leaves = objectLeaves[objectID];
+            if (leaves.size() == 1 ? (topLeaves[leaves[0]].bounds.lower != bounds.lower || topLeaves[leaves[0]].bounds.upper != bounds.upper) : !bounds.empty())
+              changed.push_back(objectID);
+          }
+        }
+        if (changed.size() > maxChanged)
+          return false;
+      }
+
+      double t0 = bvh->preBuild(TOSTRING(isa) "::BVH" + toString(N) + "BuilderTwoLevelIncremental");
+
+      /* build changed objects, duplicates get copied after their prototypes got built */
+      for (size_t pass=0; pass<(numDuplicates ? 2 : 1); pass++)
+      {
+        parallel_for(size_t(0), changed.size(), [&] (const range<size_t>& r)
+        {
+          for (size_t i=r.begin(); i<r.end(); i++)
+          {
+            const size_t objectID = changed[i];
+            Mesh* mesh = objectID < num ? scene->getSafe<Mesh>(objectID) : nullptr;
+            if (mesh == nullptr || !mesh->isEnabled() || mesh->numTimeSteps != 1 || isDuplicate(objectID) != (pass == 1))
+              continue;
+
+            builders[objectID]->attachBuildRefs (this);
+          }
+        });
+      }
+
+      /* replace the top level leaves of changed objects */
+      for (size_t objectID : changed)
+      {
+        for (size_t leafID : objectLeaves[objectID])
+          removeTopLeaf(leafID);
+        objectLeaves[objectID].clear();
+      }
+
+      FastAllocator::CachedAllocator alloc = bvh->alloc.getCachedAllocator();
+      for (size_t i=0; i<size_t(nextRef); i++)
+      {
+        const size_t leafID = newTopLeaf(refs[i].bounds(),refs[i].node,refs[i].geomID());
+        objectLeaves[refs[i].geomID()].push_back(leafID);
+        insertTopLeaf(leafID,alloc);
+      }
+      numIncrementalUpdates += changed.size();
+
+      AABBNode* root = topNodes[topRoot].node;
+      if (topNodes[topRoot].numChildren == 0)
+        bvh->set(BVH::emptyNode,empty,0);
+      else
+        bvh->set(BVH::encodeNode(root),LBBox3fa(root->bounds()),numPrimitives);
+
+      bvh->alloc.cleanup();
+      bvh->postBuild(t0);
+      return true;
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNBuilderTwoLevel<N,Mesh,Primitive>::createTopLevel(NodeRef root, const std::vector<std::pair<size_t,unsigned int>>& leaves)
+    {
+      clearTopLevel();
+      if (!root.isAABBNode())
+        return;
+
+      std::unordered_map<size_t,unsigned int> leafObjects;
+      leafObjects.reserve(leaves.size());
+      for (const auto& leaf : leaves)
+        if (leaf.first != size_t(BVH::emptyNode))
+          leafObjects[leaf.first] = leaf.second;
+
+      objectLeaves.resize(scene->size());
+      bool valid = true;
+      topRoot = createTopNode(root,invalidTopID,0,leafObjects,valid);
+      if (!valid) clearTopLevel();
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    size_t BVHNBuilderTwoLevel<N,Mesh,Primitive>::createTopNode(NodeRef ref, size_t parent, unsigned int slot, const std::unordered_map<size_t,unsigned int>& leafObjects, bool& valid)
+    {
+      AABBNode* node = ref.getAABBNode();
+      const size_t nodeID = newTopNode(node);
+      topNodes[nodeID].parent = parent;
+      topNodes[nodeID].slot = slot;
+
+      for (unsigned int i=0; i<N && valid; i++)
+      {
+        const NodeRef child = node->child(i);
+        if (child == BVH::emptyNode) break;
+
+        size_t item = 0;
+        auto leaf = leafObjects.find(size_t(child));
+        if (leaf != leafObjects.end()) {
+          item = newTopLeaf(node->bounds(i),child,leaf->second) | topLeafBit;
+          objectLeaves[leaf->second].push_back(item & ~topLeafBit);
+        }
+        else if (child.isAABBNode())
+          item = createTopNode(child,nodeID,i,leafObjects,valid);
+        else {
+          valid = false;
+          break;
+        }
+        topNodes[nodeID].items[i] = item;
+        topNodes[nodeID].numChildren++;
+        if (item & topLeafBit) {
+          topLeaves[item & ~topLeafBit].parent = nodeID;
+          topLeaves[item & ~topLeafBit].slot = i;
+        }
+      }
+      return nodeID;
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNBuilderTwoLevel<N,Mesh,Primitive>::clearTopLevel()
+    {
+      topNodes.clear();
+      topLeaves.clear();
+      freeTopNodes.clear();
+      freeTopLeaves.clear();
+      objectLeaves.clear();
+      topRoot = invalidTopID;
+      numTopLeaves = 0;
+      numIncrementalUpdates = 0;
+      garbageBytes = 0;
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    size_t BVHNBuilderTwoLevel<N,Mesh,Primitive>::newTopNode(AABBNode* node)
+    {
+      TopNode n;
+      n.node = node;
+      n.parent = invalidTopID;
+      n.slot = 0;
+      n.numChildren = 0;
+      
+      if (freeTopNodes.empty()) {
+        topNodes.push_back(n);
+        return topNodes.size()-1;
+      }
+      const size_t nodeID = freeTopNodes.back(); freeTopNodes.pop_back();
+      topNodes[nodeID] = n;
+      return nodeID;
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    size_t BVHNBuilderTwoLevel<N,Mesh,Primitive>::newTopLeaf(const BBox3fa& bounds, NodeRef ref, unsigned int objectID)
+    {
+      TopLeaf l;
+      l.bounds = bounds;
+      l.ref = ref;
+      l.objectID = objectID;
+      l.slot = 0;
+      l.parent = invalidTopID;
+      numTopLeaves++;
+
+      if (freeTopLeaves.empty()) {
+        topLeaves.push_back(l);
+        return topLeaves.size()-1;
+      }
+      const size_t leafID = freeTopLeaves.back(); freeTopLeaves.pop_back();
+      topLeaves[leafID] = l;
+      return leafID;
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    BBox3fa BVHNBuilderTwoLevel<N,Mesh,Primitive>::topItemBounds(size_t item) const
+    {
+      if (item & topLeafBit) return topLeaves[item & ~topLeafBit].bounds;
+      return topNodes[item].node->bounds();
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    typename BVHNBuilderTwoLevel<N,Mesh,Primitive>::NodeRef BVHNBuilderTwoLevel<N,Mesh,Primitive>::topItemRef(size_t item) const
+    {
+      if (item & topLeafBit) return topLeaves[item & ~topLeafBit].ref;
+      return BVH::encodeNode(topNodes[item].node);
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNBuilderTwoLevel<N,Mesh,Primitive>::setTopItem(size_t nodeID, unsigned int slot, size_t item, const BBox3fa& bounds)
+    {
+      topNodes[nodeID].node->set(slot,topItemRef(item),bounds);
+      topNodes[nodeID].items[slot] = item;
+      if (item & topLeafBit) {
+        topLeaves[item & ~topLeafBit].parent = nodeID;
+        topLeaves[item & ~topLeafBit].slot = slot;
+      } else {
+        topNodes[item].parent = nodeID;
+        topNodes[item].slot = slot;
+      }
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNBuilderTwoLevel<N,Mesh,Primitive>::insertTopLeaf(size_t leafID, const FastAllocator::CachedAllocator& alloc)
+    {
+      const BBox3fa bounds = topLeaves[leafID].bounds;
+      const size_t item = leafID | topLeafBit;
+
+      /* descend along the smallest SAH cost increase, the leaf cost is the area of its parent */
+      size_t nodeID = topRoot;
+      float inherited = 0.0f;
+      while (true)
+      {
+        const TopNode& n = topNodes[nodeID];
+        if (n.numChildren == 0) {
+          setTopItem(nodeID,0,item,bounds);
+          topNodes[nodeID].numChildren = 1;
+          break;
+        }
+        
+        const BBox3fa nodeBounds = n.node->bounds();
+        inherited += area(merge(nodeBounds,bounds)) - area(nodeBounds);
+
+        /* add the leaf to a free slot of this node */
+        float bestCost = inf; ssize_t bestPair = -1;
+        if (n.numChildren < N)
+          bestCost = inherited + area(merge(nodeBounds,bounds));
+
+        /* or pair the leaf with a child under a new node, or descend into an inner child */
+        float bestDescendCost = inf; ssize_t bestDescend = -1;
+        for (unsigned int i=0; i<n.numChildren; i++)
+        {
+          const BBox3fa childBounds = n.node->bounds(i);
+          const float pairArea = area(merge(childBounds,bounds));
+          if (inherited + 2.0f*pairArea < bestCost) {
+            bestCost = inherited + 2.0f*pairArea;
+            bestPair = i;
+          }
+          if (n.items[i] & topLeafBit) continue;
+          const float descendCost = inherited + pairArea - area(childBounds) + area(bounds);
+          if (descendCost < bestDescendCost) {
+            bestDescendCost = descendCost;
+            bestDescend = i;
+          }
+        }
+
+        if (bestDescendCost < bestCost) {
+          nodeID = n.items[bestDescend];
+          continue;
+        }
+
+        if (bestPair == -1) {
+          setTopItem(nodeID,n.numChildren,item,bounds);
+          topNodes[nodeID].numChildren++;
+        }
+        else
+        {
+          const size_t sibling = n.items[bestPair];
+          const BBox3fa siblingBounds = n.node->bounds(bestPair);
+          const size_t pairID = newTopNode(((NodeRef)typename AABBNode::Create()(alloc)).getAABBNode());
+          setTopItem(pairID,0,sibling,siblingBounds);
+          setTopItem(pairID,1,item,bounds);
+          topNodes[pairID].numChildren = 2;
+          setTopItem(nodeID,(unsigned int)bestPair,pairID,merge(siblingBounds,bounds));
+        }
+        break;
+      }
+      updateTopPath(nodeID);
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNBuilderTwoLevel<N,Mesh,Primitive>::removeTopLeaf(size_t leafID)
+    {
+      size_t nodeID = topLeaves[leafID].parent;
+      unsigned int slot = topLeaves[leafID].slot;
+      if (topLeaves[leafID].ref.isLeaf()) garbageBytes += sizeof(Primitive);
+      freeTopLeaves.push_back(leafID);
+      numTopLeaves--;
+
+      while (true)
+      {
+        /* remove the item and keep the children compact */
+        TopNode& n = topNodes[nodeID];
+        const unsigned int last = --n.numChildren;
+        if (slot != last) setTopItem(nodeID,slot,n.items[last],n.node->bounds(last));
+        n.node->set(last,BVH::emptyNode,empty);
+
+        if (nodeID == topRoot)
+        {
+          /* an inner node as single child of the root becomes the new root */
+          if (n.numChildren == 1 && !(n.items[0] & topLeafBit)) {
+            garbageBytes += sizeof(AABBNode);
+            freeTopNodes.push_back(nodeID);
+            topRoot = n.items[0];
+            topNodes[topRoot].parent = invalidTopID;
+          }
+          return;
+        }
+
+        /* a node with a single child gets replaced by that child */
+        if (n.numChildren == 1)
+        {
+          const size_t parent = n.parent;
+          setTopItem(parent,n.slot,n.items[0],n.node->bounds(0));
+          garbageBytes += sizeof(AABBNode);
+          freeTopNodes.push_back(nodeID);
+          updateTopPath(parent);
+          return;
+        }
+
+        /* an empty node gets removed from its parent */
+        if (n.numChildren == 0)
+        {
+          garbageBytes += sizeof(AABBNode);
+          freeTopNodes.push_back(nodeID);
+          slot = n.slot;
+          nodeID = n.parent;
+          continue;
+        }
+        
+        updateTopPath(nodeID);
+        return;
+      }
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNBuilderTwoLevel<N,Mesh,Primitive>::rotateTopNode(size_t nodeID)
+    {
+      /* find the swap of a child with a grandchild that shrinks the grandchild's parent most */
+      TopNode& n = topNodes[nodeID];
+      float bestGain = 0.0f;
+      unsigned int bestI = 0, bestJ = 0, bestK = 0;
+      
+      for (unsigned int j=0; j<n.numChildren; j++)
+      {
+        if (n.items[j] & topLeafBit) continue;
+        const TopNode& c = topNodes[n.items[j]];
+        const float childArea = area(n.node->bounds(j));
+        
+        for (unsigned int k=0; k<c.numChildren; k++)
+        {
+          BBox3fa others = empty;
+          for (unsigned int l=0; l<c.numChildren; l++)
+            if (l != k) others.extend(c.node->bounds(l));
+
+          for (unsigned int i=0; i<n.numChildren; i++)
+          {
+            if (i == j) continue;
+            const float gain = childArea - area(merge(others,n.node->bounds(i)));
+            if (gain > bestGain) {
+              bestGain = gain;
+              bestI = i; bestJ = j; bestK = k;
+            }
+          }
+        }
+      }
+      if (bestGain <= 0.0f)
+        return;
+
+      const size_t childID = n.items[bestJ];
+      const size_t a = n.items[bestI];
+      const size_t b = topNodes[childID].items[bestK];
+      const BBox3fa boundsA = n.node->bounds(bestI);
+      const BBox3fa boundsB = topNodes[childID].node->bounds(bestK);
+      setTopItem(nodeID,bestI,b,boundsB);
+      setTopItem(childID,bestK,a,boundsA);
+      n.node->setBounds(bestJ,topNodes[childID].node->bounds());
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNBuilderTwoLevel<N,Mesh,Primitive>::updateTopPath(size_t nodeID)
+    {
+      /* restructure and refit all nodes up to the root */
+      for (; nodeID != invalidTopID; nodeID = topNodes[nodeID].parent)
+      {
+        rotateTopNode(nodeID);
+        const size_t parent = topNodes[nodeID].parent;
+        if (parent != invalidTopID)
+          topNodes[parent].node->setBounds(topNodes[nodeID].slot,topNodes[nodeID].node->bounds());
+      }
     }
 
     template<int N, typename Mesh, typename Primitive>
@@ -283,6 +727,231 @@ namespace embree
       }
     }
 
+    // ===========================================================================
+    // deduplication of meshes with the same topology
+    // ===========================================================================
+
+    /* hashes the index buffer and the vertex layout the leaves depend on */
+    template<typename Index>
+    uint64_t topologyHash(const BufferView<Index>& indices, const BufferView<Vec3fa>& vertices)
+    {
+      ContentHash hash;
+      hash.add(indices.getPtr(),indices.getStride(),indices.size(),sizeof(Index));
+      hash.add(vertices.size());
+      hash.add(vertices.getStride()); // leaves may store vertex offsets
+      return hash.get();
+    }
+
+    template<typename Index>
+    bool sameTopology(const BufferView<Index>& a, const BufferView<Index>& b)
+    {
+      if (a.size() != b.size())
+        return false;
+      for (size_t i=0; i<a.size(); i++)
+        if (memcmp(&a[i],&b[i],sizeof(Index)) != 0)
+          return false;
+      return true;
+    }
+
+    /* checks if the vertices of b are the vertices of a after some rotation and translation */
+    __forceinline bool rigidlyTransformed(const BufferView<Vec3fa>& a, const BufferView<Vec3fa>& b)
+    {
+      const size_t num = a.size();
+      if (num == 0 || num != b.size() || a.getStride() != b.getStride())
+        return false;
+
+      /* frame through the first vertex, the vertex farthest from it, and the vertex farthest from their line */
+      const Vec3fa a0 = a[0];
+      size_t i1 = 0, i2 = 0;
+      float d1 = 0.0f, d2 = 0.0f;
+      for (size_t i=1; i<num; i++) {
+        const float d = sqr_length(a[i]-a0);
+        if (d > d1) { d1 = d; i1 = i; }
+      }
+      for (size_t i=1; i<num; i++) {
+        const float d = sqr_length(cross(a[i]-a0,a[i1]-a0));
+        if (d > d2) { d2 = d; i2 = i; }
+      }
+      if (!(d2 > 0.0f)) return false;
+
+      auto frameOf = [] (const Vec3fa& p0, const Vec3fa& p1, const Vec3fa& p2) {
+        const Vec3fa u = normalize(p1-p0);
+        const Vec3fa w = normalize(cross(p1-p0,p2-p0));
+        return LinearSpace3fa(u,cross(w,u),w);
+      };
+      const Vec3fa b0 = b[0];
+      const LinearSpace3fa R = frameOf(b0,b[i1],b[i2]) * frameOf(a0,a[i1],a[i2]).transposed();
+      const AffineSpace3fa xfm(R,b0-xfmVector(R,a0));
+
+      /* the tolerance only affects BVH quality, the copied leaves get refitted to the actual vertices */
+      const float eps = 1E-3f*sqrt(d1);
+      for (size_t i=0; i<num; i++) {
+        if (!(sqr_length(xfmPoint(xfm,a[i])-b[i]) <= eps*eps))
+          return false;
+      }
+      return true;
+    }
+
+    /* updates the leaves of a copied BVH to another mesh */
+    template<int N, typename Mesh, typename Primitive>
+    struct CloneLeafBounds : public BVHNRefitter<N>::LeafBoundsInterface
+    {
+      typedef typename BVHN<N>::NodeRef NodeRef;
+
+      CloneLeafBounds (Mesh* mesh, unsigned int geomID)
+        : mesh(mesh), geomID(geomID) {}
+
+      const BBox3fa leafBounds (NodeRef& ref) const
+      {
+        size_t num; Primitive* prims = (Primitive*) ref.leaf(num);
+        BBox3fa bounds = empty;
+        for (size_t i=0; i<num; i++)
+        {
+          for (size_t j=0; j<Primitive::max_size(); j++)
+            if (prims[i].valid(j)) prims[i].geomID()[j] = geomID;
+          bounds.extend(prims[i].update(mesh));
+        }
+        return bounds;
+      }
+
+      Mesh* mesh;
+      unsigned int geomID;
+    };
+
+    template<int N, typename Mesh, typename Primitive>
+    void cloneMeshBVH(BVHN<N>* src, BVHN<N>* dst, Mesh* mesh, unsigned int geomID)
+    {
+      if (!BVHNRelayout<N>(src).clone(dst)) {
+        dst->set(BVHN<N>::emptyNode,empty,0);
+        return;
+      }
+      CloneLeafBounds<N,Mesh,Primitive> leafBounds(mesh,geomID);
+      BVHNRefitter<N>(dst,leafBounds).refit();
+    }
+
+    /* deduplication is only supported for triangle and quad meshes */
+    template<int N, typename Mesh, typename Primitive>
+    struct MeshDedup
+    {
+      static bool topologyKey(const Mesh* /*mesh*/, uint64_t& /*key*/) { return false; }
+      static bool sameShape(const Mesh* /*a*/, const Mesh* /*b*/) { return false; }
+      static void clone(BVHN<N>* /*src*/, BVHN<N>* /*dst*/, Mesh* /*mesh*/, unsigned int /*geomID*/) {}
+    };
+
+    template<int N, typename Primitive>
+    struct MeshDedup<N,TriangleMesh,Primitive>
+    {
+      static bool topologyKey(const TriangleMesh* mesh, uint64_t& key) {
+        key = topologyHash(mesh->triangles,mesh->vertices0);
+        return true;
+      }
+      static bool sameShape(const TriangleMesh* a, const TriangleMesh* b) {
+        return sameTopology(a->triangles,b->triangles) && rigidlyTransformed(a->vertices0,b->vertices0);
+      }
+      static void clone(BVHN<N>* src, BVHN<N>* dst, TriangleMesh* mesh, unsigned int geomID) {
+        cloneMeshBVH<N,TriangleMesh,Primitive>(src,dst,mesh,geomID);
+      }
+    };
+
+    template<int N, typename Primitive>
+    struct MeshDedup<N,QuadMesh,Primitive>
+    {
+      static bool topologyKey(const QuadMesh* mesh, uint64_t& key) {
+        key = topologyHash(mesh->quads,mesh->vertices0);
+        return true;
+      }
+      static bool sameShape(const QuadMesh* a, const QuadMesh* b) {
+        return sameTopology(a->quads,b->quads) && rigidlyTransformed(a->vertices0,b->vertices0);
+      }
+      static void clone(BVHN<N>* src, BVHN<N>* dst, QuadMesh* mesh, unsigned int geomID) {
+        cloneMeshBVH<N,QuadMesh,Primitive>(src,dst,mesh,geomID);
+      }
+    };
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNBuilderTwoLevel<N,Mesh,Primitive>::findDuplicates()
+    {
+      typedef MeshDedup<N,Mesh,Primitive> Dedup;
+      const size_t num = scene->size();
+      prototypes.assign(num,invalidObjectID);
+      numDuplicates = 0;
+      if (!scene->device->mesh_dedup)
+        return;
+
+      /* hash the topology of all meshes that get built */
+      std::vector<uint64_t> keys(num);
+      std::vector<char> candidates(num,0);
+      parallel_for(size_t(0), num, [&] (const range<size_t>& r)
+      {
+        for (size_t objectID=r.begin(); objectID<r.end(); objectID++)
+        {
+          Mesh* mesh = scene->getSafe<Mesh>(objectID);
+          if (mesh == nullptr || !mesh->isEnabled() || mesh->numTimeSteps != 1 || isSmallGeometry(mesh) || !isGeometryModified(objectID))
+            continue;
+          if (scene->getGeometryBuildQuality(mesh->quality) == RTC_BUILD_QUALITY_REFIT)
+            continue;
+          candidates[objectID] = Dedup::topologyKey(mesh,keys[objectID]);
+        }
+      });
+
+      /* group meshes by topology in object order, which makes the choice of prototypes deterministic */
+      std::unordered_map<uint64_t,std::vector<size_t>> groups;
+      for (size_t objectID=0; objectID<num; objectID++)
+        if (candidates[objectID]) groups[keys[objectID]].push_back(objectID);
+
+      std::vector<const std::vector<size_t>*> shared;
+      for (const auto& group : groups)
+        if (group.second.size() > 1) shared.push_back(&group.second);
+
+      /* the first mesh of each shape becomes the prototype of the later ones */
+      numDuplicates = parallel_reduce(size_t(0), shared.size(), size_t(0), [&] (const range<size_t>& r) -> size_t
+      {
+        size_t duplicates = 0;
+        for (size_t i=r.begin(); i<r.end(); i++)
+        {
+          const std::vector<size_t>& group = *shared[i];
+          const Mesh* first = scene->getSafe<Mesh>(group[0]);
+          duplicates += parallel_reduce(size_t(1), group.size(), size_t(0), [&] (const range<size_t>& r) -> size_t {
+              size_t d = 0;
+              for (size_t j=r.begin(); j<r.end(); j++) {
+                if (Dedup::sameShape(first,scene->getSafe<Mesh>(group[j]))) {
+                  prototypes[group[j]] = group[0];
+                  d++;
+                }
+              }
+              return d;
+            }, std::plus<size_t>());
+
+          /* meshes of other shapes try the few other prototypes */
+          std::vector<size_t> protos;
+          for (size_t j=1; j<group.size(); j++)
+          {
+            const size_t objectID = group[j];
+            if (prototypes[objectID] != invalidObjectID) continue;
+            const Mesh* mesh = scene->getSafe<Mesh>(objectID);
+            for (size_t proto : protos) {
+              if (Dedup::sameShape(scene->getSafe<Mesh>(proto),mesh)) {
+                prototypes[objectID] = proto;
+                duplicates++;
+                break;
+              }
+            }
+            if (prototypes[objectID] == invalidObjectID && protos.size()+1 < MAX_PROTOTYPES_PER_TOPOLOGY)
+              protos.push_back(objectID);
+          }
+        }
+        return duplicates;
+      }, std::plus<size_t>());
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNBuilderTwoLevel<N,Mesh,Primitive>::cloneMeshAccel(size_t objectID)
+    {
+      BVH* src = bvh->objects[prototypes[objectID]];
+      BVH* dst = bvh->objects[objectID];
+      MeshDedup<N,Mesh,Primitive>::clone(src,dst,getMesh(objectID),(unsigned int)objectID);
+    }
+
     template<int N, typename Mesh, typename Primitive>
     void BVHNBuilderTwoLevel<N,Mesh,Primitive>::setupSmallBuildRefBuilder (size_t objectID, Mesh const * const /*mesh*/)
     {
@@ -296,14 +965,17 @@ namespace embree
     template<int N, typename Mesh, typename Primitive>
     void BVHNBuilderTwoLevel<N,Mesh,Primitive>::setupLargeBuildRefBuilder (size_t objectID, Mesh const * const mesh)
     {
+      /* the build time budget of the scene may lower the quality of modified meshes */
+      const RTCBuildQuality quality = scene->getGeometryBuildQuality(mesh->quality);
       if (bvh->objects[objectID] == nullptr ||                                  // new mesh
-          builders[objectID]->meshQualityChanged (mesh->quality) ||             // changed build quality
+          (isGeometryModified(objectID) &&
+           builders[objectID]->meshQualityChanged (quality)) ||                 // changed build quality
           dynamic_cast<RefBuilderLarge*>(builders[objectID].get()) == nullptr)  // size change resulted in small->large change
       {
         Builder* builder = nullptr;
         delete bvh->objects[objectID]; 
-        createMeshAccel(objectID, builder);
-        builders[objectID].reset (new RefBuilderLarge(objectID, builder, mesh->quality));
+        createMeshAccel(objectID, quality, builder);
+        builders[objectID].reset (new RefBuilderLarge(objectID, builder, quality));
       }
     }
 
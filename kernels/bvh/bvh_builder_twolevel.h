@@ -4,6 +4,7 @@
 #pragma once
 
 #include <type_traits>
+#include <unordered_map>
 
 #include "bvh_builder_twolevel_internal.h"
 #include "bvh.h"
@@ -18,6 +19,10 @@
 #define SPLIT_MEMORY_RESERVE_SCALE 2
 #define SPLIT_MIN_EXT_SPACE 1000
 
+/* incremental top level updates */
+#define ENABLE_INCREMENTAL_TOP_LEVEL 1
+#define INCREMENTAL_MAX_CHANGED_FRACTION 0.1f
+
 namespace embree
 {
   namespace isa
@@ -117,6 +122,68 @@ namespace embree
       
     private:
 
+      enum : size_t {
+        invalidObjectID = size_t(-1),                     //!< marks objects without prototype
+        invalidTopID = size_t(-1),                        //!< marks missing parent
+        topLeafBit   = size_t(1) << (8*sizeof(size_t)-1)  //!< marks items referencing a top level leaf
+      };
+
+      /* node of the persistent top level hierarchy, mirrors an AABBNode of the BVH */
+      struct TopNode
+      {
+        AABBNode* node;            //!< top level node referenced by the BVH
+        size_t parent;             //!< index of the parent node, invalidTopID for the root
+        unsigned int slot;         //!< child slot inside the parent node
+        unsigned int numChildren;  //!< children are stored compactly at the front
+        size_t items[N];           //!< node index or leaf index (marked by topLeafBit) of each child
+      };
+
+      /* leaf of the persistent top level hierarchy */
+      struct TopLeaf
+      {
+        BBox3fa bounds;
+        NodeRef ref;               //!< object root, opened object node, or leaf of a small geometry
+        unsigned int objectID;
+        unsigned int slot;         //!< child slot inside the parent node
+        size_t parent;             //!< index of the parent node
+      };
+
+      bool buildIncremental (size_t numPrimitives);
+
+      /* meshes with the same topology as an earlier mesh copy its BVH instead of building their own */
+      static const size_t MAX_PROTOTYPES_PER_TOPOLOGY = 8;
+      void findDuplicates ();
+      void cloneMeshAccel (size_t objectID);
+      bool isDuplicate (size_t objectID) const {
+        return objectID < prototypes.size() && prototypes[objectID] != invalidObjectID;
+      }
+      std::vector<size_t> prototypes;                 //!< object the BVH of each object gets copied from, or invalidObjectID
+      size_t numDuplicates = 0;
+      void createTopLevel (NodeRef root, const std::vector<std::pair<size_t,unsigned int>>& leaves);
+      size_t createTopNode (NodeRef ref, size_t parent, unsigned int slot, const std::unordered_map<size_t,unsigned int>& leafObjects, bool& valid);
+      void clearTopLevel ();
+
+      size_t newTopNode (AABBNode* node);
+      size_t newTopLeaf (const BBox3fa& bounds, NodeRef ref, unsigned int objectID);
+      void   setTopItem (size_t nodeID, unsigned int slot, size_t item, const BBox3fa& bounds);
+      BBox3fa topItemBounds (size_t item) const;
+      NodeRef topItemRef (size_t item) const;
+
+      void insertTopLeaf (size_t leafID, const FastAllocator::CachedAllocator& alloc);
+      void removeTopLeaf (size_t leafID);
+      void rotateTopNode (size_t nodeID);
+      void updateTopPath (size_t nodeID);
+
+      std::vector<TopNode> topNodes;
+      avector<TopLeaf>     topLeaves;
+      std::vector<size_t>  freeTopNodes;
+      std::vector<size_t>  freeTopLeaves;
+      std::vector<std::vector<size_t>> objectLeaves;  //!< top level leaves of each object
+      size_t topRoot = invalidTopID;
+      size_t numTopLeaves = 0;
+      size_t numIncrementalUpdates = 0;               //!< objects updated since the last full build
+      size_t garbageBytes = 0;                        //!< unreachable top level memory since the last full build
+
       class RefBuilderBase {
       public:
         virtual ~RefBuilderBase () {}
@@ -173,9 +240,14 @@ namespace embree
         {
           BVH* object  = topBuilder->getBVH(objectID_); assert(object);
           
-          /* build object if it got modified */
+          /* build object if it got modified, duplicates copy the BVH of their prototype */
           if (topBuilder->isGeometryModified(objectID_))
-            builder_->build();
+          {
+            if (topBuilder->isDuplicate(objectID_))
+              topBuilder->cloneMeshAccel(objectID_);
+            else
+              builder_->build();
+          }
 
           /* create build primitive */
           if (!object->getBounds().empty())
@@ -234,7 +306,7 @@ namespace embree
         }
       }
 
-      void createMeshAccel (size_t geomID, Builder*& builder)
+      void createMeshAccel (size_t geomID, RTCBuildQuality quality, Builder*& builder)
       {
         bvh->objects[geomID] = new BVH(Primitive::type,scene);
         BVH* accel = bvh->objects[geomID];
@@ -244,7 +316,7 @@ namespace embree
           return;
         }
 
-        __internal_two_level_builder__::MeshBuilder<N,Mesh,Primitive>()(accel, mesh, geomID, this->gtype, this->useMortonBuilder_, builder);
+        __internal_two_level_builder__::MeshBuilder<N,Mesh,Primitive>()(accel, mesh, geomID, this->gtype, quality, this->useMortonBuilder_, builder);
       }      
 
       using BuilderList = std::vector<std::unique_ptr<RefBuilderBase>>;
@@ -248,12 +248,12 @@ namespace embree
       template<int N, typename Mesh, typename Primitive>
       struct MeshBuilder {
         MeshBuilder () {}
-        void operator () (void* bvh, Mesh* mesh, size_t geomID, Geometry::GTypeMask gtype, bool useMortonBuilder, Builder*& builder) {
+        void operator () (void* bvh, Mesh* mesh, size_t geomID, Geometry::GTypeMask gtype, RTCBuildQuality quality, bool useMortonBuilder, Builder*& builder) {
           if(useMortonBuilder) {
             builder = MortonBuilder<N,Mesh,Primitive>()(bvh,mesh,geomID,gtype);
             return;
           }
-          switch (mesh->quality) {
+          switch (quality) {
             case RTC_BUILD_QUALITY_LOW:    builder = MortonBuilder<N,Mesh,Primitive>()(bvh,mesh,geomID,gtype); break;
             case RTC_BUILD_QUALITY_MEDIUM:
             case RTC_BUILD_QUALITY_HIGH:   builder = SAHBuilder<N,Mesh,Primitive>()(bvh,mesh,geomID,gtype); break;
@@ -0,0 +1,265 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "bvh_cache.h"
+#include "../common/scene.h"
+#include "../common/content_hash.h"
+
+#include <fstream>
+#include <iomanip>
+
+namespace embree
+{
+  namespace isa
+  {
+    static const char cacheMagic[8] = { 'e','m','b','r','e','e','B','H' };
+
+    template<int N>
+    BVHNCache<N>::BVHNCache (BVH* bvh, Geometry::GTypeMask gtype)
+      : bvh(bvh), gtype(gtype) {}
+
+    template<int N>
+    uint64_t BVHNCache<N>::computeKey() const
+    {
+      Scene* scene = bvh->scene;
+      Device* device = scene->device;
+
+      /* the BVH layout and all settings that influence the build */
+      ContentHash hash;
+      hash.add(RTC_VERSION);
+      hash.add(uint32_t(VERSION));
+      hash.add(N);
+      hash.add(sizeof(AABBNode));
+      hash.add(std::string(bvh->primTy->name()));
+      hash.add(scene->getSceneFlags());
+      hash.add(scene->getBuildQuality());
+      hash.add(device->tri_builder);
+      hash.add(device->quad_builder);
+      hash.add(device->max_spatial_split_replications);
+      hash.add(device->useSpatialPreSplits);
+
+      /* the buffers of all geometries the BVH gets built over */
+      for (size_t geomID=0; geomID<scene->size(); geomID++)
+      {
+        const Geometry* geom = scene->get(geomID);
+        if (geom == nullptr || !geom->isEnabled() || !(geom->getTypeMask() & gtype) || geom->numTimeSteps != 1)
+          continue;
+
+        hash.add(geomID);
+        hash.add(geom->getType());
+        if (geom->getTypeMask() & Geometry::MTY_TRIANGLE_MESH)
+        {
+          const TriangleMesh* mesh = (const TriangleMesh*) geom;
+          hash.add(mesh->triangles.getPtr(),mesh->triangles.getStride(),mesh->triangles.size(),sizeof(TriangleMesh::Triangle));
+          hash.add(mesh->vertices0.getPtr(),mesh->vertices0.getStride(),mesh->vertices0.size(),sizeof(Vec3f));
+          hash.add(mesh->vertices0.getStride()); // leaves store vertex offsets
+        }
+        else if (geom->getTypeMask() & Geometry::MTY_QUAD_MESH)
+        {
+          const QuadMesh* mesh = (const QuadMesh*) geom;
+          hash.add(mesh->quads.getPtr(),mesh->quads.getStride(),mesh->quads.size(),sizeof(QuadMesh::Quad));
+          hash.add(mesh->vertices0.getPtr(),mesh->vertices0.getStride(),mesh->vertices0.size(),sizeof(Vec3f));
+          hash.add(mesh->vertices0.getStride()); // leaves store vertex offsets
+        }
+      }
+      return hash.get();
+    }
+
+    template<int N>
+    FileName BVHNCache<N>::filename(uint64_t key) const
+    {
+      std::stringstream name;
+      name << std::hex << std::setw(16) << std::setfill('0') << key << ".bvh";
+      return FileName(bvh->scene->device->bvh_cache_dir) + name.str();
+    }
+
+    template<int N>
+    bool BVHNCache<N>::owned(const void* ptr, size_t bytes) const
+    {
+      auto block = std::upper_bound(blocks.begin(),blocks.end(),std::make_pair((size_t)ptr,std::numeric_limits<size_t>::max()));
+      if (block == blocks.begin()) return false;
+      --block;
+      return (size_t)ptr >= block->first && (size_t)ptr+bytes <= block->second;
+    }
+
+    template<int N>
+    bool BVHNCache<N>::serialize(NodeRef ref, std::ostream& out, size_t& ofs, size_t& encoded) const
+    {
+      static const char zeros[RESERVED_BYTES] = { 0 };
+
+      if (ref == BVH::emptyNode) {
+        encoded = BVH::emptyNode;
+        return true;
+      }
+
+      const void* ptr = nullptr;
+      size_t bytes = 0, align = 0;
+      AABBNode node;
+
+      if (ref.isAABBNode())
+      {
+        /* children are written first to know their offsets */
+        if (!owned(ref.getAABBNode(),sizeof(AABBNode))) return false;
+        node = *ref.getAABBNode();
+        for (size_t i=0; i<N; i++) {
+          size_t child = 0;
+          if (!serialize(node.child(i),out,ofs,child)) return false;
+          node.child(i) = NodeRef(child);
+        }
+        ptr = &node; bytes = sizeof(AABBNode); align = NodeRef::byteNodeAlignment;
+      }
+      else if (ref.isLeaf())
+      {
+        /* nodes and leaves that reference memory of other BVHs, e.g. of two-level BVHs, are not supported */
+        size_t num; const char* prims = ref.leaf(num);
+        for (size_t i=0; i<num; i++)
+          bytes += bvh->primTy->getBytes(prims+bytes);
+        if (!owned(prims,bytes)) return false;
+        ptr = prims; align = NodeRef::byteAlignment;
+      }
+      else
+        return false;
+
+      const size_t pad = ((ofs+align-1) & ~(align-1)) - ofs;
+      out.write(zeros,pad);
+      ofs += pad;
+      encoded = ofs | (size_t(ref) & NodeRef::align_mask);
+      out.write((const char*)ptr,bytes);
+      ofs += bytes;
+      return true;
+    }
+
+    template<int N>
+    bool BVHNCache<N>::store(uint64_t key)
+    {
+      if (bvh->root == BVH::emptyNode)
+        return false;
+
+      blocks.clear();
+      bvh->alloc.gatherBlockRanges(blocks);
+      std::sort(blocks.begin(),blocks.end());
+
+      /* write to a temporary file first, such that concurrent loads never see a partial file */
+      const FileName file = filename(key);
+      std::stringstream tmp; tmp << file.str() << "." << std::hex << (size_t)bvh << read_tsc() << ".tmp";
+      std::ofstream out(tmp.str().c_str(),std::ios::binary);
+      if (!out) return false;
+
+      Header header;
+      memset(&header,0,sizeof(Header));
+      memcpy(header.magic,cacheMagic,sizeof(header.magic));
+      header.version = VERSION;
+      header.width = N;
+      strncpy(header.primTy,bvh->primTy->name(),sizeof(header.primTy)-1);
+      header.key = key;
+      header.numPrimitives = bvh->numPrimitives;
+      const BBox3fa bounds = bvh->bounds.bounds();
+      for (size_t i=0; i<3; i++) {
+        header.lower[i] = bounds.lower[i];
+        header.upper[i] = bounds.upper[i];
+      }
+      std::vector<char> page(size_t(DATA_OFFSET),0);
+      out.write(page.data(),page.size());
+
+      /* offset zero stays unused such that no leaf gets encoded as empty node */
+      size_t ofs = RESERVED_BYTES;
+      out.write(page.data(),ofs);
+      size_t root = 0;
+      bool ok = serialize(bvh->root,out,ofs,root);
+      header.root = root;
+      header.dataBytes = ofs;
+      out.seekp(0);
+      out.write((const char*)&header,sizeof(Header));
+      out.close();
+
+      ok &= !out.fail();
+      if (ok) ok = std::rename(tmp.str().c_str(),file.c_str()) == 0;
+      if (!ok) std::remove(tmp.str().c_str());
+      return ok;
+    }
+
+    template<int N>
+    bool BVHNCache<N>::relocate(NodeRef& ref, char* data, size_t dataBytes) const
+    {
+      if (ref == BVH::emptyNode)
+        return true;
+
+      const size_t ofs = size_t(ref) & ~NodeRef::align_mask;
+      if (ofs == 0 || ofs >= dataBytes) return false;
+      ref = NodeRef((size_t)data + size_t(ref));
+      if (!ref.isAABBNode())
+        return true;
+
+      if (ofs+sizeof(AABBNode) > dataBytes) return false;
+      AABBNode* node = ref.getAABBNode();
+      for (size_t i=0; i<N; i++)
+        if (!relocate(node->child(i),data,dataBytes))
+          return false;
+      return true;
+    }
+
+    template<int N>
+    bool BVHNCache<N>::load(uint64_t key)
+    {
+      size_t bytes = 0;
+      char* ptr = (char*) os_map_file(filename(key).c_str(),bytes);
+      if (ptr == nullptr)
+        return false;
+
+      /* a hash collision or an incomplete file never gets used */
+      const Header* header = (const Header*) ptr;
+      bool ok = bytes >= DATA_OFFSET+RESERVED_BYTES;
+      ok = ok && memcmp(header->magic,cacheMagic,sizeof(header->magic)) == 0;
+      ok = ok && header->version == VERSION && header->width == N && header->key == key;
+      ok = ok && strncmp(header->primTy,bvh->primTy->name(),sizeof(header->primTy)) == 0;
+      ok = ok && header->dataBytes == bytes-DATA_OFFSET;
+
+      NodeRef root(header->root);
+      ok = ok && relocate(root,ptr+DATA_OFFSET,header->dataBytes);
+      if (!ok) {
+        os_unmap_file(ptr,bytes);
+        return false;
+      }
+
+      const BBox3fa bounds(Vec3fa(header->lower[0],header->lower[1],header->lower[2]),
+                           Vec3fa(header->upper[0],header->upper[1],header->upper[2]));
+      const size_t numPrimitives = header->numPrimitives;
+
+      /* the allocator owns the mapping from now on */
+      bvh->alloc.clear();
+      bvh->alloc.addMappedBlock(ptr,bytes,DATA_OFFSET);
+      bvh->set(root,LBBox3fa(bounds),numPrimitives);
+      return true;
+    }
+
+    template<int N>
+    void BVHNCacheBuilder<N>::build()
+    {
+      BVHNCache<N> cache(bvh,gtype);
+      const uint64_t key = cache.computeKey();
+
+      const double t0 = bvh->preBuild("BVHCache");
+      if (cache.load(key)) {
+        bvh->postBuild(t0);
+        return;
+      }
+      builder->build();
+      cache.store(key);
+    }
+
+    Builder* BVH4CacheBuilder (void* bvh, Geometry::GTypeMask gtype, Builder* builder) {
+      return new BVHNCacheBuilder<4>((BVH4*)bvh,gtype,builder);
+    }
+
+#if defined(__AVX__)
+    Builder* BVH8CacheBuilder (void* bvh, Geometry::GTypeMask gtype, Builder* builder) {
+      return new BVHNCacheBuilder<8>((BVH8*)bvh,gtype,builder);
+    }
+#endif
+
+    template class BVHNCache<4>;
+#if defined(__AVX__)
+    template class BVHNCache<8>;
+#endif
+  }
+}
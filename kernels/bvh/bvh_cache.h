@@ -0,0 +1,105 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "bvh.h"
+#include "../common/builder.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Stores built BVHs as files in a cache directory. Files are named
+     *  after a hash of the geometry buffers and build settings. The file
+     *  contains a header followed by the nodes and leaves of the BVH,
+     *  where child references are stored as offsets. The data is laid out
+     *  as a FastAllocator block, which gets memory mapped copy-on-write
+     *  when loading. Only the inner nodes get touched to turn offsets
+     *  into pointers, leaves get paged in lazily by the first rays
+     *  visiting them. */
+    template<int N>
+    class BVHNCache
+    {
+      /*! Type shortcuts */
+      typedef BVHN<N> BVH;
+      typedef typename BVH::AABBNode AABBNode;
+      typedef typename BVH::NodeRef NodeRef;
+
+    public:
+      static const uint32_t VERSION = 1;
+      static const size_t DATA_OFFSET = PAGE_SIZE; //!< file offset of the BVH data
+      static const size_t RESERVED_BYTES = 64;     //!< unused bytes at the start of the BVH data, offset 0 encodes the empty node
+
+      /*! header at the start of each cache file */
+      struct Header
+      {
+        char magic[8];
+        uint32_t version;
+        uint32_t width;
+        char primTy[32];
+        uint64_t key;
+        uint64_t dataBytes;
+        uint64_t root;
+        uint64_t numPrimitives;
+        float lower[3];
+        float upper[3];
+      };
+
+    public:
+      BVHNCache (BVH* bvh, Geometry::GTypeMask gtype);
+
+      /*! hashes all inputs the BVH depends on */
+      uint64_t computeKey() const;
+
+      /*! replaces the BVH by the cached one, returns false if the cache has no valid entry */
+      bool load(uint64_t key);
+
+      /*! stores the BVH in the cache, returns false if the BVH could not get stored */
+      bool store(uint64_t key);
+
+    private:
+
+      /*! returns the name of the cache file of some key */
+      FileName filename(uint64_t key) const;
+
+      /*! checks if the memory range got allocated by the BVH */
+      bool owned(const void* ptr, size_t bytes) const;
+
+      /*! writes a subtree in post order, returns the encoded reference to the subtree */
+      bool serialize(NodeRef ref, std::ostream& out, size_t& ofs, size_t& encoded) const;
+
+      /*! turns the offsets of a subtree into pointers, returns false for invalid offsets */
+      bool relocate(NodeRef& ref, char* data, size_t dataBytes) const;
+
+    private:
+      BVH* bvh;
+      Geometry::GTypeMask gtype;
+      std::vector<std::pair<size_t,size_t>> blocks;  //!< sorted address ranges of the blocks of the BVH allocator
+    };
+
+    /*! Builder that loads the BVH from the cache or builds and stores it on a cache miss. */
+    template<int N>
+    class BVHNCacheBuilder : public Builder
+    {
+    public:
+      BVHNCacheBuilder (BVHN<N>* bvh, Geometry::GTypeMask gtype, Builder* builder)
+        : bvh(bvh), gtype(gtype), builder(builder) {}
+
+      void build();
+
+      void deleteGeometry(size_t geomID) {
+        builder->deleteGeometry(geomID);
+      }
+
+      void clear() {
+        builder->clear();
+      }
+
+    private:
+      BVHN<N>* bvh;
+      Geometry::GTypeMask gtype;
+      std::unique_ptr<Builder> builder;
+    };
+  }
+}
@@ -3,6 +3,7 @@
 
 #include "bvh_intersector1.h"
 #include "node_intersector1.h"
+#include "node_intersector_frustum.h"
 #include "bvh_traverser1.h"
 
 #include "../geometry/intersector_iterators.h"
@@ -23,6 +24,9 @@
 #include "../geometry/subgrid_mb_intersector.h"
 #include "../geometry/curve_intersector_virtual.h"
 
+#include <unordered_map>
+#include <algorithm>
+
 namespace embree
 {
   namespace isa
@@ -195,6 +199,631 @@ namespace embree
       }
     }
 
+    /*! Ray queues for the breadth first traversal. Rays are traversed
+     *  through one treelet of the BVH at a time, and rays that leave a
+     *  treelet are appended to the queue of the treelet's child subtree
+     *  they enter, such that all rays of a queue access the same nodes
+     *  and primitives in a row. */
+    template<typename NodeRef>
+    struct BVHNRayQueues
+    {
+      struct Item
+      {
+        unsigned int rayID;
+        float dist;
+      };
+
+      struct Queue
+      {
+        NodeRef node;
+        std::vector<Item> items;
+      };
+
+      __forceinline bool empty() const {
+        return queues.empty();
+      }
+
+      __forceinline void push(NodeRef node, unsigned int rayID, float dist)
+      {
+        auto i = index.find((size_t)node);
+        if (i == index.end()) {
+          i = index.insert(std::make_pair((size_t)node,queues.size())).first;
+          queues.push_back(Queue());
+          queues.back().node = node;
+        }
+        queues[i->second].items.push_back({rayID,dist});
+      }
+
+      __forceinline void clear()
+      {
+        queues.clear();
+        index.clear();
+      }
+
+    public:
+      std::vector<Queue> queues;
+      std::unordered_map<size_t,size_t> index; //!< maps treelet root nodes to queues
+    };
+
+    template<int N, int types, bool robust, typename PrimitiveIntersector1>
+    struct RayQueueDispatch
+    {
+      typedef typename PrimitiveIntersector1::Precalculations Precalculations;
+      typedef typename PrimitiveIntersector1::Primitive Primitive;
+      typedef BVHN<N> BVH;
+      typedef typename BVH::NodeRef NodeRef;
+      typedef typename BVH::BaseNode BaseNode;
+      typedef BVHNRayQueues<NodeRef> RayQueues;
+
+      /* number of BVH levels traversed per treelet */
+      static const size_t treeletDepth = N == 4 ? 3 : 2;
+      static const size_t stackSize = 1+(N-1)*treeletDepth;
+
+      struct StackItem
+      {
+        NodeRef ptr;
+        float dist;
+        unsigned int depth;
+      };
+
+      /* intersects a leaf, returns true if the ray does not need to get traversed further */
+      static __forceinline bool intersectLeaf(const Accel::Intersectors* This, Precalculations& pre, RayHit& ray, RayQueryContext* context,
+                                              Primitive* prim, size_t num, TravRay<N,robust>& tray, size_t& lazy_node)
+      {
+        PrimitiveIntersector1::intersect(This, pre, ray, context, prim, num, tray, lazy_node);
+        tray.tfar = ray.tfar;
+        return false;
+      }
+
+      static __forceinline bool intersectLeaf(const Accel::Intersectors* This, Precalculations& pre, Ray& ray, RayQueryContext* context,
+                                              Primitive* prim, size_t num, TravRay<N,robust>& tray, size_t& lazy_node)
+      {
+        if (!PrimitiveIntersector1::occluded(This, pre, ray, context, prim, num, tray, lazy_node))
+          return false;
+        ray.tfar = neg_inf;
+        return true;
+      }
+
+      /* traverses a single ray through the treelet rooted at root, and
+       * enqueues the ray at all treelets below that it enters */
+      template<bool occlusion, typename RayT>
+      static __forceinline void traverseTreelet(const Accel::Intersectors* This, const BVH* bvh,
+                                                RayT& ray, unsigned int rayID, NodeRef root, float dist,
+                                                RayQueues& next, RayQueryContext* context)
+      {
+        /* perform per ray precalculations required by the primitive intersector */
+        Precalculations pre(ray, bvh);
+
+        /* load the ray into SIMD registers */
+        TravRay<N,robust> tray(ray.org, ray.dir, max(ray.tnear(), 0.0f), max(ray.tfar, 0.0f));
+
+        StackItem stack[stackSize];
+        StackItem* stackPtr = stack+1;
+        stack[0].ptr = root;
+        stack[0].dist = dist;
+        stack[0].depth = 0;
+
+        while (stackPtr != stack)
+        {
+          stackPtr--;
+          const NodeRef cur = stackPtr->ptr;
+          const unsigned int depth = stackPtr->depth;
+
+          /* if popped node is too far, pop next one */
+          if (!occlusion && unlikely(stackPtr->dist > ray.tfar))
+            continue;
+
+          /* the ray leaves the treelet, continue in a later pass */
+          if (depth == treeletDepth && !cur.isLeaf()) {
+            next.push(cur,rayID,stackPtr->dist);
+            continue;
+          }
+
+          /* intersect node */
+          size_t mask; vfloat<N> tNear;
+          if (occlusion) STAT3(shadow.trav_nodes,1,1,1);
+          else           STAT3(normal.trav_nodes,1,1,1);
+          bool nodeIntersected = BVHNNodeIntersector1<N, types, robust>::intersect(cur, tray, ray.time(), tNear, mask);
+          if (likely(nodeIntersected))
+          {
+            /* push hit children such that the closest child is popped first */
+            const BaseNode* node = cur.baseNode();
+            StackItem* stackBegin = stackPtr;
+            while (mask)
+            {
+              const size_t r = bscf(mask);
+              StackItem item;
+              item.ptr = node->child(r);
+              item.dist = tNear[r];
+              item.depth = depth+1;
+              StackItem* p = stackPtr++;
+              for (; p > stackBegin && (p-1)->dist < item.dist; p--)
+                *p = *(p-1);
+              *p = item;
+            }
+            continue;
+          }
+          if (occlusion) STAT3(shadow.trav_nodes,-1,-1,-1);
+          else           STAT3(normal.trav_nodes,-1,-1,-1);
+
+          /* this is a leaf node */
+          assert(cur != BVH::emptyNode);
+          if (occlusion) STAT3(shadow.trav_leaves,1,1,1);
+          else           STAT3(normal.trav_leaves,1,1,1);
+          size_t num; Primitive* prim = (Primitive*)cur.leaf(num);
+          size_t lazy_node = 0;
+          if (intersectLeaf(This, pre, ray, context, prim, num, tray, lazy_node))
+            return;
+
+          /* lazy nodes are traversed in a later pass */
+          if (unlikely(lazy_node))
+            next.push((NodeRef)lazy_node,rayID,neg_inf);
+        }
+      }
+
+      template<bool occlusion, typename RayT>
+      static __forceinline void traverse(const Accel::Intersectors* This, RayT** rays, size_t M, RayQueryContext* context)
+      {
+        const BVH* __restrict__ bvh = (const BVH*)This->ptr;
+
+        /* we may traverse an empty BVH in case all geometry was invalid */
+        if (bvh->root == BVH::emptyNode)
+          return;
+
+        /* all rays start at the root treelet */
+        RayQueues cur, next;
+        for (size_t i=0; i<M; i++)
+        {
+          RayT& ray = *rays[i];
+
+          /* early out for already occluded rays */
+          if (occlusion && unlikely(ray.tfar < 0.0f))
+            continue;
+
+          /* filter out invalid rays */
+#if defined(EMBREE_IGNORE_INVALID_RAYS)
+          if (!ray.valid()) continue;
+#endif
+          /* verify correct input */
+          assert(ray.valid());
+          assert(ray.tnear() >= 0.0f);
+          assert(!(types & BVH_MB) || (ray.time() >= 0.0f && ray.time() <= 1.0f));
+
+          cur.push(bvh->root,(unsigned int)i,neg_inf);
+        }
+
+        /* process one level of treelets per pass */
+        while (!cur.empty())
+        {
+          for (size_t q=0; q<cur.queues.size(); q++)
+          {
+            const NodeRef root = cur.queues[q].node;
+            for (const typename RayQueues::Item& item : cur.queues[q].items)
+            {
+              RayT& ray = *rays[item.rayID];
+              if (occlusion ? ray.tfar < 0.0f : item.dist > ray.tfar)
+                continue;
+              traverseTreelet<occlusion>(This,bvh,ray,item.rayID,root,item.dist,next,context);
+            }
+          }
+          std::swap(cur,next);
+          next.clear();
+        }
+      }
+    };
+
+    template<int N, int types, bool robust, typename PrimitiveIntersector1>
+    void BVHNIntersector1<N, types, robust, PrimitiveIntersector1>::intersectQueue(const Accel::Intersectors* This,
+                                                                                   RayHit** rays, size_t M,
+                                                                                   RayQueryContext* context)
+    {
+      RayQueueDispatch<N, types, robust, PrimitiveIntersector1>::template traverse<false>(This, rays, M, context);
+    }
+
+    template<int N, int types, bool robust, typename PrimitiveIntersector1>
+    void BVHNIntersector1<N, types, robust, PrimitiveIntersector1>::occludedQueue(const Accel::Intersectors* This,
+                                                                                  Ray** rays, size_t M,
+                                                                                  RayQueryContext* context)
+    {
+      RayQueueDispatch<N, types, robust, PrimitiveIntersector1>::template traverse<true>(This, rays, M, context);
+    }
+
+    /*! Occlusion test of a batch of rays with nearby origins, such as
+     *  the shadow rays towards a point light. A binary hierarchy of
+     *  frusta is built over the rays of each direction octant, and BVH
+     *  nodes are tested against the frusta of that hierarchy. Subtrees
+     *  that miss a frustum get culled for all its rays with a single
+     *  test, and each level of BVH descent continues with the sub-frusta
+     *  that overlap the subtree. Rays are tested individually only at
+     *  BVH leaves, for the leaf frusta overlapping the leaf. */
+    template<int N, int types, bool robust, typename PrimitiveIntersector1>
+    struct FrustumDispatch
+    {
+      typedef typename PrimitiveIntersector1::Precalculations Precalculations;
+      typedef typename PrimitiveIntersector1::Primitive Primitive;
+      typedef BVHN<N> BVH;
+      typedef typename BVH::NodeRef NodeRef;
+      typedef typename BVH::AABBNode AABBNode;
+      typedef typename BVH::BaseNode BaseNode;
+
+      static const size_t stackSize = 1+(N-1)*BVH::maxDepth+3; // +3 due to 16-wide store
+
+      /* frusta of up to that many rays are not split further */
+      static const size_t maxLeafRays = 16;
+
+      static const unsigned int invalidFrustum = -1;
+
+      struct FrustumNode
+      {
+        __forceinline bool isLeaf() const {
+          return child[0] == invalidFrustum;
+        }
+
+        Frustum<robust> frustum;
+        unsigned int begin, end;  //!< range of rays inside the ray ID array
+        unsigned int child[2];
+        unsigned int parent;
+        unsigned int active;      //!< number of rays that are not yet found occluded
+      };
+
+      /* bounds of the ray data that determine a frustum */
+      struct FrustumBounds
+      {
+        __forceinline FrustumBounds()
+          : min_org(pos_inf), max_org(neg_inf), min_rdir(pos_inf), max_rdir(neg_inf), min_dist(pos_inf), max_dist(neg_inf) {}
+
+        __forceinline void extend(const Ray& ray, const Vec3fa& rdir)
+        {
+          min_org = min(min_org,Vec3fa(ray.org)); max_org = max(max_org,Vec3fa(ray.org));
+          min_rdir = min(min_rdir,rdir); max_rdir = max(max_rdir,rdir);
+          min_dist = min(min_dist,max(ray.tnear(),0.0f));
+          max_dist = max(max_dist,ray.tfar);
+        }
+
+        __forceinline void extend(const FrustumBounds& other)
+        {
+          min_org = min(min_org,other.min_org); max_org = max(max_org,other.max_org);
+          min_rdir = min(min_rdir,other.min_rdir); max_rdir = max(max_rdir,other.max_rdir);
+          min_dist = min(min_dist,other.min_dist);
+          max_dist = max(max_dist,other.max_dist);
+        }
+
+        Vec3fa min_org, max_org;
+        Vec3fa min_rdir, max_rdir;
+        float min_dist, max_dist;
+      };
+
+      struct FrustumTree
+      {
+        FrustumTree(Ray** rays, size_t M)
+          : rays(rays), rdir(M), leafOf(M) {}
+
+        /* builds the frustum hierarchy over the rays of the range [begin,end) of
+         * the ray ID array, the rays are already sorted by direction */
+        unsigned int build(unsigned int begin, unsigned int end, unsigned int parent, FrustumBounds& bounds)
+        {
+          const unsigned int nodeID = (unsigned int) nodes.size();
+          nodes.push_back(FrustumNode());
+          nodes[nodeID].begin = begin;
+          nodes[nodeID].end = end;
+          nodes[nodeID].child[0] = nodes[nodeID].child[1] = invalidFrustum;
+          nodes[nodeID].parent = parent;
+          nodes[nodeID].active = end-begin;
+
+          if (end-begin <= maxLeafRays)
+          {
+            for (unsigned int i=begin; i<end; i++) {
+              bounds.extend(*rays[ids[i]],rdir[ids[i]]);
+              leafOf[ids[i]] = nodeID;
+            }
+          }
+          else
+          {
+            const unsigned int center = (begin+end)/2;
+            FrustumBounds bounds0, bounds1;
+            const unsigned int child0 = build(begin,center,nodeID,bounds0);
+            const unsigned int child1 = build(center,end,nodeID,bounds1);
+            nodes[nodeID].child[0] = child0;
+            nodes[nodeID].child[1] = child1;
+            bounds.extend(bounds0);
+            bounds.extend(bounds1);
+          }
+
+          nodes[nodeID].frustum.init(bounds.min_org,bounds.max_org,bounds.min_rdir,bounds.max_rdir,bounds.min_dist,bounds.max_dist,N);
+          return nodeID;
+        }
+
+        /* marks a ray as occluded and removes it from all frusta containing it */
+        __forceinline void setOccluded(unsigned int rayID)
+        {
+          rays[rayID]->tfar = neg_inf;
+          for (unsigned int f = leafOf[rayID]; f != invalidFrustum; f = nodes[f].parent)
+            nodes[f].active--;
+        }
+
+      public:
+        Ray** rays;
+        std::vector<unsigned int> ids;  //!< ray IDs ordered by frustum
+        std::vector<Vec3fa> rdir;       //!< reciprocal ray directions
+        std::vector<unsigned int> leafOf;
+        std::vector<FrustumNode> nodes;
+      };
+
+      /* tests a single ray for occlusion with the subtree rooted at root */
+      static __forceinline bool occludedRay(const Accel::Intersectors* This, const BVH* bvh, Ray& ray, NodeRef root, RayQueryContext* context)
+      {
+        /* perform per ray precalculations required by the primitive intersector */
+        Precalculations pre(ray, bvh);
+
+        /* stack state */
+        NodeRef stack[stackSize];    // stack of nodes that still need to get traversed
+        NodeRef* stackPtr = stack+1; // current stack pointer
+        NodeRef* stackEnd = stack+stackSize;
+        stack[0] = root;
+
+        /* load the ray into SIMD registers */
+        TravRay<N,robust> tray(ray.org, ray.dir, max(ray.tnear(), 0.0f), max(ray.tfar, 0.0f));
+
+        /* initialize the node traverser */
+        BVHNNodeTraverser1Hit<N, types> nodeTraverser;
+
+        /* pop loop */
+        while (true) pop:
+        {
+          /* pop next node */
+          if (unlikely(stackPtr == stack)) break;
+          stackPtr--;
+          NodeRef cur = (NodeRef)*stackPtr;
+
+          /* downtraversal loop */
+          while (true)
+          {
+            /* intersect node */
+            size_t mask; vfloat<N> tNear;
+            STAT3(shadow.trav_nodes,1,1,1);
+            bool nodeIntersected = BVHNNodeIntersector1<N, types, robust>::intersect(cur, tray, ray.time(), tNear, mask);
+            if (unlikely(!nodeIntersected)) { STAT3(shadow.trav_nodes,-1,-1,-1); break; }
+
+            /* if no child is hit, pop next node */
+            if (unlikely(mask == 0))
+              goto pop;
+
+            /* select next child and push other children */
+            nodeTraverser.traverseAnyHit(cur, mask, tNear, stackPtr, stackEnd);
+          }
+
+          /* this is a leaf node */
+          assert(cur != BVH::emptyNode);
+          STAT3(shadow.trav_leaves,1,1,1);
+          size_t num; Primitive* prim = (Primitive*)cur.leaf(num);
+          size_t lazy_node = 0;
+          if (PrimitiveIntersector1::occluded(This, pre, ray, context, prim, num, tray, lazy_node))
+            return true;
+
+          /* push lazy node onto stack */
+          if (unlikely(lazy_node)) {
+            *stackPtr = (NodeRef)lazy_node;
+            stackPtr++;
+          }
+        }
+        return false;
+      }
+
+      typedef std::vector<std::pair<NodeRef,unsigned int>> Stack;
+
+      /* sequential radix sort of the keys by their upper 32 bits, which is
+       * much faster than a comparison sort for the typical batch sizes */
+      static void radixSortUpper(std::vector<uint64_t>& keys)
+      {
+        static const size_t BITS = 11;
+        static const size_t BUCKETS = 1 << BITS;
+        std::vector<uint64_t> tmp(keys.size());
+        std::vector<unsigned int> count(BUCKETS);
+        for (size_t shift=32; shift<64; shift+=BITS)
+        {
+          std::fill(count.begin(),count.end(),0);
+          for (size_t i=0; i<keys.size(); i++)
+            count[(keys[i] >> shift) & (BUCKETS-1)]++;
+          unsigned int sum = 0;
+          for (size_t b=0; b<BUCKETS; b++) {
+            const unsigned int c = count[b]; count[b] = sum; sum += c;
+          }
+          for (size_t i=0; i<keys.size(); i++)
+            tmp[count[(keys[i] >> shift) & (BUCKETS-1)]++] = keys[i];
+          keys.swap(tmp);
+        }
+      }
+
+      /* tests the rays of leaf frustum fID individually against the leaf children of node cur in mask */
+      static __forceinline void occludedLeaves(const Accel::Intersectors* This, const BVH* bvh, FrustumTree& tree,
+                                               NodeRef cur, unsigned int fID, size_t mask, RayQueryContext* context)
+      {
+        const FrustumNode& f = tree.nodes[fID];
+        for (unsigned int i=f.begin; i<f.end; i++)
+        {
+          const unsigned int rayID = tree.ids[i];
+          Ray& ray = *tree.rays[rayID];
+          if (ray.tfar < 0.0f) continue;
+
+          /* test the ray against the child boxes first, the frustum may overlap more leaves than the ray */
+          TravRay<N,robust> tray(ray.org, ray.dir, max(ray.tnear(), 0.0f), max(ray.tfar, 0.0f));
+          size_t rayMask; vfloat<N> tNear;
+          STAT3(shadow.trav_nodes,1,1,1);
+          BVHNNodeIntersector1<N, types, robust>::intersect(cur, tray, ray.time(), tNear, rayMask);
+          rayMask &= mask;
+          if (rayMask == 0) continue;
+
+          Precalculations pre(ray, bvh);
+          for (size_t m=rayMask; m; )
+          {
+            const NodeRef leaf = cur.baseNode()->child(bscf(m));
+            STAT3(shadow.trav_leaves,1,1,1);
+            size_t num; Primitive* prim = (Primitive*)leaf.leaf(num);
+            size_t lazy_node = 0;
+            if (PrimitiveIntersector1::occluded(This, pre, ray, context, prim, num, tray, lazy_node) ||
+                (lazy_node && occludedRay(This, bvh, ray, (NodeRef)lazy_node, context)))
+            {
+              tree.setOccluded(rayID);
+              break;
+            }
+          }
+        }
+      }
+
+      /* pushes the children of mask that overlap frustum fID onto the stack, inner
+       * children continue with the overlapped sub-frusta, and children that are
+       * leaves get refined down to the overlapped leaf frusta and get tested
+       * against their rays */
+      static void pushChildren(const Accel::Intersectors* This, const BVH* bvh, FrustumTree& tree, NodeRef cur,
+                               unsigned int fID, size_t mask, size_t leafMask, Stack& stack, RayQueryContext* context)
+      {
+        const BaseNode* node = cur.baseNode();
+        const FrustumNode& f = tree.nodes[fID];
+        if (f.isLeaf())
+        {
+          for (size_t m=mask & ~leafMask; m; ) {
+            const size_t r = bscf(m);
+            stack.push_back(std::make_pair(node->child(r),fID));
+          }
+          if (mask & leafMask)
+            occludedLeaves(This,bvh,tree,cur,fID,mask & leafMask,context);
+          return;
+        }
+
+        for (size_t k=0; k<2; k++)
+        {
+          const unsigned int childID = f.child[k];
+          if (tree.nodes[childID].active == 0)
+            continue;
+
+          vfloat<N> dist;
+          STAT3(shadow.trav_nodes,1,1,1);
+          const size_t childMask = mask & intersectNodeFrustum<N>(cur.getAABBNode(),tree.nodes[childID].frustum,dist);
+          for (size_t m=childMask & ~leafMask; m; ) {
+            const size_t r = bscf(m);
+            stack.push_back(std::make_pair(node->child(r),childID));
+          }
+          if (childMask & leafMask)
+            pushChildren(This,bvh,tree,cur,childID,childMask & leafMask,leafMask,stack,context);
+        }
+      }
+
+      static void occluded(const Accel::Intersectors* This, Ray** rays, size_t M, RayQueryContext* context)
+      {
+        const BVH* __restrict__ bvh = (const BVH*)This->ptr;
+
+        /* we may traverse an empty BVH in case all geometry was invalid */
+        if (bvh->root == BVH::emptyNode)
+          return;
+
+        FrustumTree tree(rays,M);
+
+        /* sort the active rays by direction octant and the morton code of their
+         * direction inside the octant, the lower 32 bits store the ray ID */
+        std::vector<uint64_t> keys; keys.reserve(M);
+        for (size_t i=0; i<M; i++)
+        {
+          Ray& ray = *rays[i];
+
+          /* early out for already occluded rays */
+          if (unlikely(ray.tfar < 0.0f))
+            continue;
+
+          /* filter out invalid rays */
+#if defined(EMBREE_IGNORE_INVALID_RAYS)
+          if (!ray.valid()) continue;
+#endif
+          /* verify correct input */
+          assert(ray.valid());
+          assert(ray.tnear() >= 0.0f);
+          assert(!(types & BVH_MB) || (ray.time() >= 0.0f && ray.time() <= 1.0f));
+
+          const Vec3fa dir(ray.dir);
+          const Vec3fa rdir = rcp_safe(dir);
+          tree.rdir[i] = rdir;
+          tree.leafOf[i] = invalidFrustum;
+
+          /* the frustum test requires rays with equal direction signs, thus the octant is derived from the reciprocal direction */
+          const unsigned int octant = (rdir.x < 0.0f ? 1 : 0) | (rdir.y < 0.0f ? 2 : 0) | (rdir.z < 0.0f ? 4 : 0);
+          const Vec3fa adir = abs(dir);
+          const float sum = adir.x+adir.y+adir.z;
+          const float scale = sum > 0.0f ? 1023.0f/sum : 0.0f;
+          const unsigned int code = bitInterleave((unsigned int)(adir.x*scale),(unsigned int)(adir.y*scale),0u);
+          keys.push_back((uint64_t(octant) << 61) | (uint64_t(code) << 32) | uint64_t(i));
+        }
+        radixSortUpper(keys);
+
+        tree.ids.resize(keys.size());
+        for (size_t i=0; i<keys.size(); i++)
+          tree.ids[i] = (unsigned int) keys[i];
+
+        Stack stack;
+        for (size_t begin=0; begin<keys.size();)
+        {
+          const uint64_t octant = keys[begin] >> 61;
+          size_t end = begin+1;
+          while (end < keys.size() && (keys[end] >> 61) == octant) end++;
+
+          tree.nodes.clear();
+          tree.nodes.reserve(4*(end-begin)/maxLeafRays+1);
+          FrustumBounds bounds;
+          const unsigned int rootFrustum = tree.build((unsigned int)begin,(unsigned int)end,invalidFrustum,bounds);
+          begin = end;
+
+          stack.clear();
+          stack.push_back(std::make_pair(bvh->root,rootFrustum));
+          while (!stack.empty())
+          {
+            const NodeRef cur = stack.back().first;
+            const FrustumNode& f = tree.nodes[stack.back().second];
+            const unsigned int fID = stack.back().second;
+            stack.pop_back();
+
+            /* all rays of the frustum are already occluded */
+            if (f.active == 0)
+              continue;
+
+            /* test rays individually at leaves, at nodes without frustum test, and for single rays */
+            if (cur.isLeaf() || !cur.isAABBNode() || f.active == 1)
+            {
+              for (unsigned int i=f.begin; i<f.end; i++)
+              {
+                const unsigned int rayID = tree.ids[i];
+                Ray& ray = *rays[rayID];
+                if (ray.tfar < 0.0f) continue;
+                if (occludedRay(This,bvh,ray,cur,context))
+                  tree.setOccluded(rayID);
+              }
+              continue;
+            }
+
+            /* cull children against the frustum */
+            STAT3(shadow.trav_nodes,1,1,1);
+            const AABBNode* node = cur.getAABBNode();
+            vfloat<N> dist;
+            const size_t mask = intersectNodeFrustum<N>(node,f.frustum,dist);
+            if (mask == 0)
+              continue;
+
+            size_t leafMask = 0;
+            for (size_t m=mask; m; ) {
+              const size_t r = bscf(m);
+              if (node->child(r).isLeaf()) leafMask |= (size_t)1 << r;
+            }
+            pushChildren(This,bvh,tree,cur,fID,mask,leafMask,stack,context);
+          }
+        }
+      }
+    };
+
+    template<int N, int types, bool robust, typename PrimitiveIntersector1>
+    void BVHNIntersector1<N, types, robust, PrimitiveIntersector1>::occludedFrustum(const Accel::Intersectors* This,
+                                                                                    Ray** rays, size_t M,
+                                                                                    RayQueryContext* context)
+    {
+      FrustumDispatch<N, types, robust, PrimitiveIntersector1>::occluded(This, rays, M, context);
+    }
+
     template<int N, int types, bool robust, typename PrimitiveIntersector1>
     struct PointQueryDispatch
     {
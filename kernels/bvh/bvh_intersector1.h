@@ -29,6 +29,13 @@ namespace embree
       static void intersect (const Accel::Intersectors* This, RayHit& ray, RayQueryContext* context);
       static void occluded  (const Accel::Intersectors* This, Ray& ray, RayQueryContext* context);
       static bool pointQuery(const Accel::Intersectors* This, PointQuery* query, PointQueryContext* context);
+
+      /* breadth first traversal of queues of single rays through treelets of the BVH */
+      static void intersectQueue (const Accel::Intersectors* This, RayHit** rays, size_t M, RayQueryContext* context);
+      static void occludedQueue  (const Accel::Intersectors* This, Ray** rays, size_t M, RayQueryContext* context);
+
+      /* occlusion test of rays with nearby origins, culling subtrees against a hierarchy of frusta over the rays */
+      static void occludedFrustum(const Accel::Intersectors* This, Ray** rays, size_t M, RayQueryContext* context);
     };
   }
 }
@@ -3,6 +3,7 @@
 
 #include "bvh_refit.h"
 #include "bvh_statistics.h"
+#include "../builders/bvh_builder_sah.h"
 
 #include "../geometry/linei.h"
 #include "../geometry/triangle.h"
@@ -28,35 +29,134 @@ namespace embree
       return sa < sb;
     }
 
+    /* SAH cost normalized by the area of the subtree bounds, degenerated subtrees count as not degraded */
+    __forceinline float normalizedSAH(float sah, const BBox3fa& bounds)
+    {
+      const float A = halfArea(bounds);
+      return A > 0.0f ? sah/A : 0.0f;
+    }
+
+    /* checks if the SAH cost of a subtree exceeds its reference cost by the maximal degradation ratio */
+    __forceinline bool degradedSAH(float sah, const BBox3fa& bounds, float reference, float maxDegradation)
+    {
+      if (maxDegradation <= 0.0f || reference <= 0.0f) return false;
+      return normalizedSAH(sah,bounds) > maxDegradation*reference;
+    }
+
+    /* primitive references of a leaf block, leaves of single primitives stay as they are */
+    template<typename Primitive>
+    struct LeafPrimRefs
+    {
+      template<typename Mesh>
+      static __forceinline bool gather(const Primitive& prim, const Mesh* mesh, avector<PrimRef>& prims)
+      {
+        for (size_t i=0; i<prim.size(); i++) {
+          BBox3fa bounds;
+          if (!mesh->buildBounds(prim.primID(i),&bounds)) return false;
+          prims.push_back(PrimRef(bounds,prim.geomID(i),prim.primID(i)));
+        }
+        return true;
+      }
+    };
+
+    template<>
+    struct LeafPrimRefs<Object>
+    {
+      template<typename Mesh>
+      static __forceinline bool gather(const Object& prim, const Mesh* mesh, avector<PrimRef>& prims) { return false; }
+    };
+
+    template<>
+    struct LeafPrimRefs<InstancePrimitive>
+    {
+      template<typename Mesh>
+      static __forceinline bool gather(const InstancePrimitive& prim, const Mesh* mesh, avector<PrimRef>& prims) { return false; }
+    };
+
+    /* SAH contribution of a child of some node */
+    template<int N>
+    __forceinline float childSAH(const typename BVHN<N>::NodeRef& child, const BBox3fa& bounds)
+    {
+      if (!child.isLeaf()) return halfArea(bounds);
+      size_t num; child.leaf(num);
+      return float(num)*halfArea(bounds);
+    }
+
     template<int N>
     BVHNRefitter<N>::BVHNRefitter (BVH* bvh, const LeafBoundsInterface& leafBounds)
-      : bvh(bvh), leafBounds(leafBounds), numSubTrees(0)
+      : bvh(bvh), leafBounds(leafBounds), numSubTrees(0), maxSAHDegradation(0.0f), rootSAH(0.0f), garbageBytes(0)
     {
+      for (size_t i=0; i<MAX_NUM_SUB_TREES; i++)
+        subTreeSAH[i] = 0.0f;
     }
 
     template<int N>
-    void BVHNRefitter<N>::refit()
+    void BVHNRefitter<N>::reset_sah()
     {
+      if (maxSAHDegradation <= 0.0f)
+        return;
+
+      /* refitting the fresh BVH keeps all bounds and records the costs as references */
+      rootSAH = 0.0f;
+      for (size_t i=0; i<MAX_NUM_SUB_TREES; i++)
+        subTreeSAH[i] = 0.0f;
+      garbageBytes = 0;
+      refit();
+    }
+
+    template<int N>
+    bool BVHNRefitter<N>::refit()
+    {
+      BBox3fa bounds = empty;
+      float sah = 0.0f;
+      
       if (bvh->numPrimitives <= SINGLE_THREAD_THRESHOLD) {
-        bvh->bounds = LBBox3fa(recurse_bottom(bvh->root));
+        bounds = recurse_bottom(bvh->root,sah);
       }
       else
       {
         BBox3fa subTreeBounds[MAX_NUM_SUB_TREES];
+        float subTreeCost[MAX_NUM_SUB_TREES];
+        const size_t usedBytes = bvh->alloc.getUsedBytes();
         numSubTrees = 0;
         gather_subtree_refs(bvh->root,numSubTrees,0);
         if (numSubTrees)
           parallel_for(size_t(0), numSubTrees, size_t(1), [&](const range<size_t>& r) {
               for (size_t i=r.begin(); i<r.end(); i++) {
                 NodeRef& ref = subTrees[i];
-                subTreeBounds[i] = recurse_bottom(ref);
+                subTreeCost[i] = 0.0f;
+                subTreeBounds[i] = recurse_bottom(ref,subTreeCost[i]);
+
+                /* rebuild subtrees that got degraded by the deformation */
+                if (degradedSAH(subTreeCost[i],subTreeBounds[i],subTreeSAH[i],maxSAHDegradation)) {
+                  ref = rebuild_subtree(ref,subTreeBounds[i]);
+                  subTreeCost[i] = subtree_sah(ref);
+                  subTreeSAH[i] = 0.0f;
+                }
+                if (subTreeSAH[i] == 0.0f)
+                  subTreeSAH[i] = normalizedSAH(subTreeCost[i],subTreeBounds[i]);
               }
             });
 
+        /* rebuilt subtrees allocate new memory, the replaced memory gets wasted until the next full build */
+        bvh->alloc.cleanup();
+        garbageBytes += bvh->alloc.getUsedBytes()-usedBytes;
+
         numSubTrees = 0;        
-        bvh->bounds = LBBox3fa(refit_toplevel(bvh->root,numSubTrees,subTreeBounds,0));
-      }    
-  }
+        bounds = refit_toplevel(bvh->root,numSubTrees,subTreeBounds,subTreeCost,sah,0);
+      }
+      bvh->bounds = LBBox3fa(bounds);
+
+      if (maxSAHDegradation <= 0.0f)
+        return true;
+
+      /* request a full rebuild if the whole BVH got degraded or too much memory got replaced */
+      if (rootSAH == 0.0f)
+        rootSAH = normalizedSAH(sah,bounds);
+      if (degradedSAH(sah,bounds,rootSAH,maxSAHDegradation))
+        return false;
+      return 2*garbageBytes <= bvh->alloc.getUsedBytes();
+    }
 
     template<int N>
     void BVHNRefitter<N>::gather_subtree_refs(NodeRef& ref,
@@ -85,12 +185,16 @@ namespace embree
     BBox3fa BVHNRefitter<N>::refit_toplevel(NodeRef& ref,
                                             size_t &subtrees,
                                             const BBox3fa *const subTreeBounds,
+                                            const float *const subTreeCost,
+                                            float& sah,
                                             const size_t depth)
     {
       if (depth >= MAX_SUB_TREE_EXTRACTION_DEPTH) 
       {
+        /* subtrees may have been rebuilt */
         assert(subtrees < MAX_NUM_SUB_TREES);
-        assert(subTrees[subtrees] == ref);
+        ref = subTrees[subtrees];
+        sah += subTreeCost[subtrees];
         return subTreeBounds[subtrees++];
       }
 
@@ -105,8 +209,10 @@ namespace embree
 
           if (unlikely(child == BVH::emptyNode)) 
             bounds[i] = BBox3fa(empty);
-          else
-            bounds[i] = refit_toplevel(child,subtrees,subTreeBounds,depth+1); 
+          else {
+            bounds[i] = refit_toplevel(child,subtrees,subTreeBounds,subTreeCost,sah,depth+1); 
+            sah += childSAH<N>(child,bounds[i]);
+          }
         }
         
         BBox3vf<N> boundsT = transpose<N>(bounds);
@@ -131,7 +237,7 @@ namespace embree
 
     
     template<int N>
-    BBox3fa BVHNRefitter<N>::recurse_bottom(NodeRef& ref)
+    BBox3fa BVHNRefitter<N>::recurse_bottom(NodeRef& ref, float& sah)
     {
       /* this is a leaf node */
       if (unlikely(ref.isLeaf()))
@@ -151,8 +257,10 @@ namespace embree
         {
           bounds[i] = BBox3fa(empty);          
         }
-      else
-        bounds[i] = recurse_bottom(node->child(i));
+      else {
+        bounds[i] = recurse_bottom(node->child(i),sah);
+        sah += childSAH<N>(node->child(i),bounds[i]);
+      }
       
       /* AOS to SOA transform */
       BBox3vf<N> boundsT = transpose<N>(bounds);
@@ -168,9 +276,112 @@ namespace embree
       return merge<N>(bounds);
     }
 
+    template<int N>
+    float BVHNRefitter<N>::subtree_sah(NodeRef ref) const
+    {
+      if (!ref.isAABBNode())
+        return 0.0f;
+
+      AABBNode* node = ref.getAABBNode();
+      float sah = 0.0f;
+      for (size_t i=0; i<N; i++) {
+        const NodeRef child = node->child(i);
+        if (unlikely(child == BVH::emptyNode)) continue;
+        sah += subtree_sah(child) + childSAH<N>(child,node->bounds(i));
+      }
+      return sah;
+    }
+
+    /* collects the leaves below some node, returns false if some leaf has empty bounds */
+    template<int N>
+    static bool gather_leaves(typename BVHN<N>::NodeRef ref, const BBox3fa& bounds, avector<PrimRef>& leaves)
+    {
+      if (ref.isLeaf()) {
+        if (bounds.empty()) return false;
+        leaves.push_back(PrimRef(bounds,(size_t)ref));
+        return true;
+      }
+
+      typename BVHN<N>::AABBNode* node = ref.getAABBNode();
+      for (size_t i=0; i<N; i++) {
+        if (unlikely(node->child(i) == BVHN<N>::emptyNode)) continue;
+        if (!gather_leaves<N>(node->child(i),node->bounds(i),leaves))
+          return false;
+      }
+      return true;
+    }
+
+    template<int N>
+    typename BVHNRefitter<N>::NodeRef BVHNRefitter<N>::rebuild_subtree(NodeRef ref, const BBox3fa& bounds)
+    {
+      avector<PrimRef> leaves;
+      if (!ref.isAABBNode() || !gather_leaves<N>(ref,bounds,leaves) || leaves.size() < 2)
+        return ref;
+
+      /* leaves deform as well, thus we rebuild over their primitives when possible and keep the leaves otherwise */
+      avector<PrimRef> prims;
+      bool splitLeaves = true;
+      for (size_t i=0; i<leaves.size() && splitLeaves; i++) {
+        NodeRef leaf = (NodeRef) leaves[i].ID();
+        splitLeaves = leafBounds.leafPrimRefs(leaf,prims);
+      }
+      avector<PrimRef>& buildPrims = splitLeaves ? prims : leaves;
+
+      PrimInfo pinfo(empty);
+      for (size_t i=0; i<buildPrims.size(); i++)
+        pinfo.add_center2(buildPrims[i]);
+
+      const size_t blockSize = splitLeaves ? leafBounds.leafBlockSize() : 1;
+      GeneralBVHBuilder::Settings settings;
+      settings.branchingFactor = N;
+      settings.maxDepth = BVH::maxBuildDepthLeaf-MAX_SUB_TREE_EXTRACTION_DEPTH;
+      settings.logBlockSize = bsr(blockSize);
+      settings.minLeafSize = blockSize;
+      settings.maxLeafSize = splitLeaves ? blockSize*BVH::maxLeafBlocks : 1;
+      settings.travCost = 1.0f;
+      settings.intCost = 1.0f;
+
+      return BVHBuilderBinnedSAH::build<NodeRef>(
+        typename BVH::CreateAlloc(bvh),
+        typename BVH::AABBNode::Create2(),
+        typename BVH::AABBNode::Set2(),
+        [&] (const PrimRef* prims, const range<size_t>& range, const FastAllocator::CachedAllocator& alloc) -> NodeRef {
+          if (splitLeaves) return leafBounds.createLeaf(prims,range,alloc);
+          assert(range.size() == 1);
+          return (NodeRef) prims[range.begin()].ID();
+        },
+        [&] (size_t dn) { bvh->scene->progressMonitor(0); },
+        buildPrims.data(),pinfo,settings);
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    bool BVHNRefitT<N,Mesh,Primitive>::leafPrimRefs(NodeRef& ref, avector<PrimRef>& prims) const
+    {
+      size_t num; Primitive* prim = (Primitive*) ref.leaf(num);
+      for (size_t i=0; i<num; i++)
+        if (!LeafPrimRefs<Primitive>::gather(prim[i],mesh,prims))
+          return false;
+      return true;
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    typename BVHNRefitT<N,Mesh,Primitive>::NodeRef BVHNRefitT<N,Mesh,Primitive>::createLeaf(const PrimRef* prims, const range<size_t>& set, const FastAllocator::CachedAllocator& alloc) const
+    {
+      size_t items = Primitive::blocks(set.size());
+      size_t start = set.begin();
+      Primitive* accel = (Primitive*) alloc.malloc1(items*sizeof(Primitive),BVH::byteAlignment);
+      NodeRef node = BVH::encodeLeaf((char*)accel,items);
+      for (size_t i=0; i<items; i++)
+        accel[i].fill(prims,start,set.end(),bvh->scene);
+      return node;
+    }
+
     template<int N, typename Mesh, typename Primitive>
     BVHNRefitT<N,Mesh,Primitive>::BVHNRefitT (BVH* bvh, Builder* builder, Mesh* mesh, size_t mode)
-      : bvh(bvh), builder(builder), refitter(new BVHNRefitter<N>(bvh,*(typename BVHNRefitter<N>::LeafBoundsInterface*)this)), mesh(mesh), topologyVersion(0) {}
+      : bvh(bvh), builder(builder), refitter(new BVHNRefitter<N>(bvh,*(typename BVHNRefitter<N>::LeafBoundsInterface*)this)), mesh(mesh), topologyVersion(0)
+    {
+      refitter->maxSAHDegradation = bvh->device->refit_max_sah_degradation;
+    }
 
     template<int N, typename Mesh, typename Primitive>
     void BVHNRefitT<N,Mesh,Primitive>::clear()
@@ -185,9 +396,12 @@ namespace embree
       if (mesh->topologyChanged(topologyVersion)) {
         topologyVersion = mesh->getTopologyVersion();
         builder->build();
+        refitter->reset_sah();
+      }
+      else if (!refitter->refit()) {
+        builder->build();
+        refitter->reset_sah();
       }
-      else
-        refitter->refit();
     }
 
     template class BVHNRefitter<4>;
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "../bvh/bvh.h"
+#include "../common/primref.h"
 
 namespace embree
 {
@@ -21,6 +22,15 @@ namespace embree
 
       struct LeafBoundsInterface {
         virtual const BBox3fa leafBounds(NodeRef& ref) const = 0;
+
+        /* appends the primitives of a leaf for subtree rebuilds, returns false if the leaf has to be kept as a whole */
+        virtual bool leafPrimRefs(NodeRef& ref, avector<PrimRef>& prims) const { return false; }
+
+        /* creates a leaf over primitives returned by leafPrimRefs */
+        virtual NodeRef createLeaf(const PrimRef* prims, const range<size_t>& set, const FastAllocator::CachedAllocator& alloc) const { return BVH::emptyNode; }
+
+        /* number of primitives stored per leaf block */
+        virtual size_t leafBlockSize() const { return 1; }
       };
 
     public:
@@ -28,8 +38,11 @@ namespace embree
       /*! Constructor. */
       BVHNRefitter (BVH* bvh, const LeafBoundsInterface& leafBounds);
 
-      /*! refits the BVH */
-      void refit();
+      /*! refits the BVH, returns false if the SAH cost degraded such that a full rebuild is required */
+      bool refit();
+
+      /*! records the SAH cost of a freshly built BVH as reference for degradation tracking */
+      void reset_sah();
 
     private:
       /* single-threaded subtree extraction based on BVH depth */
@@ -40,11 +53,19 @@ namespace embree
       /* single-threaded top-level refit */
       BBox3fa refit_toplevel(NodeRef& ref,
                              size_t &subtrees,
-							 const BBox3fa *const subTreeBounds,
+                             const BBox3fa *const subTreeBounds,
+                             const float *const subTreeCost,
+                             float& sah,
                              const size_t depth = 0);
 
-      /* single-threaded subtree refit */
-      BBox3fa recurse_bottom(NodeRef& ref);
+      /* single-threaded subtree refit, accumulates the unnormalized SAH cost of the subtree */
+      BBox3fa recurse_bottom(NodeRef& ref, float& sah);
+
+      /* unnormalized SAH cost of the subtree below some node */
+      float subtree_sah(NodeRef ref) const;
+
+      /* rebuilds a degraded subtree over its primitives or its existing leaves */
+      NodeRef rebuild_subtree(NodeRef ref, const BBox3fa& bounds);
       
     public:
       BVH* bvh;                              //!< BVH to refit
@@ -54,6 +75,11 @@ namespace embree
       static const size_t MAX_NUM_SUB_TREES             = (N==4) ? 256 : (N==8) ? 512 : N*N*N; // N ^ MAX_SUB_TREE_EXTRACTION_DEPTH
       size_t numSubTrees;
       NodeRef subTrees[MAX_NUM_SUB_TREES];
+
+      float maxSAHDegradation;               //!< SAH cost ratio to the last build that triggers a rebuild, 0 disables tracking
+      float rootSAH;                         //!< normalized SAH cost of the whole BVH at the last full build
+      float subTreeSAH[MAX_NUM_SUB_TREES];   //!< normalized SAH cost of each subtree at the last (partial) build
+      size_t garbageBytes;                   //!< node memory of replaced subtrees since the last full build
     };
 
     template<int N, typename Mesh, typename Primitive>
@@ -83,6 +109,10 @@ namespace embree
             bounds.extend(((Primitive*)prim)[i].update(mesh));
         return bounds;
       }
+
+      virtual bool leafPrimRefs (NodeRef& ref, avector<PrimRef>& prims) const;
+      virtual NodeRef createLeaf (const PrimRef* prims, const range<size_t>& set, const FastAllocator::CachedAllocator& alloc) const;
+      virtual size_t leafBlockSize () const { return Primitive::max_size(); }
       
     private:
       BVH* bvh;
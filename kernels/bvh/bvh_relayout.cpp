@@ -0,0 +1,284 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "bvh_relayout.h"
+#include "../common/scene.h"
+#include "../geometry/subdivpatch1.h"
+#include "../../common/algorithms/parallel_for.h"
+#include "../../common/algorithms/parallel_reduce.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    template<int N>
+    BVHNRelayout<N>::BVHNRelayout (BVH* bvh, Layout layout)
+      : bvh(bvh), layout(layout) {}
+
+    template<int N>
+    bool BVHNRelayout<N>::owned(const void* ptr, size_t bytes) const
+    {
+      auto block = std::upper_bound(blocks.begin(),blocks.end(),std::make_pair((size_t)ptr,std::numeric_limits<size_t>::max()));
+      if (block == blocks.begin()) return false;
+      --block;
+      return (size_t)ptr >= block->first && (size_t)ptr+bytes <= block->second;
+    }
+
+    template<int N>
+    size_t BVHNRelayout<N>::nodeBytes(NodeRef ref) const
+    {
+      size_t bytes = 0;
+      switch (ref.type()) {
+      case NodeRef::tyAABBNode     : bytes = sizeof(typename BVH::AABBNode); break;
+      case NodeRef::tyAABBNodeMB   : bytes = sizeof(typename BVH::AABBNodeMB); break;
+      case NodeRef::tyAABBNodeMB4D : bytes = sizeof(typename BVH::AABBNodeMB4D); break;
+      case NodeRef::tyOBBNode      : bytes = sizeof(typename BVH::OBBNode); break;
+      case NodeRef::tyOBBNodeMB    : bytes = sizeof(typename BVH::OBBNodeMB); break;
+      case NodeRef::tyQuantizedNode: bytes = sizeof(typename BVH::QuantizedNode); break;
+      default: return 0;
+      }
+      return owned(ref.baseNode(),bytes) ? bytes : 0;
+    }
+
+    template<int N>
+    size_t BVHNRelayout<N>::leafBytes(NodeRef ref) const
+    {
+      size_t num; const char* prims = ref.leaf(num);
+      if (num == 0 || !owned(prims,1))
+        return 0;
+
+      size_t bytes = 0;
+      for (size_t i=0; i<num; i++)
+        bytes += bvh->primTy->getBytes(prims+bytes);
+      return owned(prims,bytes) ? bytes : 0;
+    }
+
+    template<int N>
+    size_t BVHNRelayout<N>::subtreeBytes(NodeRef ref, size_t depth)
+    {
+      size_t bytes = 0;
+      if (ref == BVH::emptyNode || ref.isBarrier())
+        bytes = 0;
+      else if (ref.isLeaf())
+        bytes = align(leafBytes(ref));
+      else if (const size_t nbytes = nodeBytes(ref))
+      {
+        const BaseNode* node = ref.baseNode();
+        bytes = align(nbytes);
+        if (depth < PARALLEL_DEPTH)
+        {
+          bytes += parallel_reduce(size_t(0), size_t(N), size_t(1), size_t(0), [&] (const range<size_t>& r) -> size_t {
+              size_t b = 0;
+              for (size_t i=r.begin(); i<r.end(); i++)
+                b += subtreeBytes(node->child(i),depth+1);
+              return b;
+            }, std::plus<size_t>());
+        }
+        else
+        {
+          for (size_t i=0; i<N; i++)
+            bytes += subtreeBytes(node->child(i),depth+1);
+        }
+      }
+
+      if (depth <= PARALLEL_DEPTH) {
+        Lock<SpinLock> lock(mutex);
+        sizes[size_t(ref)] = bytes;
+      }
+      return bytes;
+    }
+
+    template<int N>
+    void BVHNRelayout<N>::childOrder(NodeRef ref, size_t order[N]) const
+    {
+      for (size_t i=0; i<N; i++)
+        order[i] = i;
+      if (layout == DEPTH_FIRST)
+        return;
+
+      /* leaves first, then inner nodes by decreasing surface area, which is proportional to the probability of a ray visiting them */
+      float area[N];
+      const BaseNode* node = ref.baseNode();
+      for (size_t i=0; i<N; i++)
+      {
+        const NodeRef child = node->child(i);
+        if (child == BVH::emptyNode || child.isBarrier()) area[i] = neg_inf;
+        else if (child.isLeaf())          area[i] = inf;
+        else if (ref.isAABBNode())        area[i] = halfArea(ref.getAABBNode()->bounds(i));
+        else if (ref.isAABBNodeMB() || ref.isAABBNodeMB4D()) area[i] = halfArea(ref.getAABBNodeMB()->bounds(i));
+        else if (ref.isQuantizedNode())   area[i] = halfArea(ref.quantizedNode()->bounds(i));
+        else                              area[i] = 0.0f;
+      }
+      std::stable_sort(order,order+N,[&] (size_t a, size_t b) { return area[a] > area[b]; });
+    }
+
+    template<int N>
+    size_t BVHNRelayout<N>::copy(NodeRef ref, char* data, size_t ofs, size_t depth, NodeRef& dst) const
+    {
+      /* empty nodes and subtrees of other BVHs stay as they are */
+      dst = ref;
+      if (ref == BVH::emptyNode || ref.isBarrier())
+        return ofs;
+
+      if (ref.isLeaf())
+      {
+        const size_t bytes = leafBytes(ref);
+        if (bytes == 0) return ofs;
+        size_t num; const char* prims = ref.leaf(num);
+        memcpy(data+ofs,prims,bytes);
+        memset(data+ofs+bytes,0,align(bytes)-bytes);
+        dst = NodeRef((size_t)(data+ofs) | (size_t(ref) & NodeRef::align_mask));
+        return ofs+align(bytes);
+      }
+
+      const size_t bytes = nodeBytes(ref);
+      if (bytes == 0) return ofs;
+      const BaseNode* node = ref.baseNode();
+      BaseNode* dstNode = (BaseNode*)(data+ofs);
+      memcpy(dstNode,node,bytes);
+      memset(data+ofs+bytes,0,align(bytes)-bytes);
+      dst = NodeRef((size_t)dstNode | ref.type());
+      ofs += align(bytes);
+
+      size_t order[N];
+      childOrder(ref,order);
+
+      if (depth < PARALLEL_DEPTH)
+      {
+        size_t childOfs[N];
+        for (size_t i=0; i<N; i++) {
+          childOfs[order[i]] = ofs;
+          ofs += sizes.at(size_t(node->child(order[i])));
+        }
+        parallel_for(size_t(0), size_t(N), size_t(1), [&] (const range<size_t>& r) {
+            for (size_t i=r.begin(); i<r.end(); i++)
+              copy(node->child(i),data,childOfs[i],depth+1,dstNode->child(i));
+          });
+      }
+      else
+      {
+        for (size_t i=0; i<N; i++)
+          ofs = copy(node->child(order[i]),data,ofs,depth+1,dstNode->child(order[i]));
+      }
+      return ofs;
+    }
+
+    template<int N>
+    void BVHNRelayout<N>::copyTop(NodeRef root, char* data, NodeRef& dst) const
+    {
+      struct Item
+      {
+        __forceinline Item (NodeRef ref, size_t depth, NodeRef* dst)
+          : ref(ref), depth(depth), dst(dst) {}
+
+        NodeRef ref;
+        size_t depth;
+        NodeRef* dst;
+        size_t ofs;
+      };
+
+      static_assert(TOP_DEPTH <= PARALLEL_DEPTH, "subtree sizes are only known up to the parallel depth");
+
+      /* store the inner nodes of the top levels breadth first */
+      size_t ofs = 0;
+      std::vector<Item> level, leaves, subtrees;
+      level.push_back(Item(root,0,&dst));
+      while (!level.empty())
+      {
+        std::vector<Item> next;
+        for (Item& item : level)
+        {
+          const size_t bytes = (item.ref.isLeaf() || item.depth >= TOP_DEPTH) ? 0 : nodeBytes(item.ref);
+          if (bytes == 0) {
+            if (item.ref.isLeaf()) leaves.push_back(item);
+            else                   subtrees.push_back(item);
+            continue;
+          }
+          BaseNode* dstNode = (BaseNode*)(data+ofs);
+          memcpy(dstNode,item.ref.baseNode(),bytes);
+          memset(data+ofs+bytes,0,align(bytes)-bytes);
+          *item.dst = NodeRef((size_t)dstNode | item.ref.type());
+          ofs += align(bytes);
+
+          size_t order[N];
+          childOrder(item.ref,order);
+          for (size_t i=0; i<N; i++)
+            next.push_back(Item(item.ref.baseNode()->child(order[i]),item.depth+1,&dstNode->child(order[i])));
+        }
+        level = std::move(next);
+      }
+
+      /* followed by the leaves of the top levels and the subtrees below, which get copied in parallel */
+      std::vector<Item> items = std::move(leaves);
+      items.insert(items.end(),subtrees.begin(),subtrees.end());
+      for (Item& item : items) {
+        item.ofs = ofs;
+        ofs += sizes.at(size_t(item.ref));
+      }
+      parallel_for(items.size(), [&] (size_t i) {
+          copy(items[i].ref,data,items[i].ofs,items[i].depth,*items[i].dst);
+        });
+    }
+
+    template<int N>
+    bool BVHNRelayout<N>::relayout() {
+      return clone(bvh);
+    }
+
+    template<int N>
+    bool BVHNRelayout<N>::clone(BVH* dst)
+    {
+      if (bvh->root == BVH::emptyNode)
+        return false;
+
+      /* the source of a clone is finished already and may get cloned by multiple threads at once */
+      if (dst == bvh) bvh->alloc.cleanup();
+      blocks.clear();
+      bvh->alloc.gatherBlockRanges(blocks);
+      std::sort(blocks.begin(),blocks.end());
+
+      sizes.clear();
+      const size_t bytes = subtreeBytes(bvh->root,0);
+      if (bytes == 0)
+        return false;
+
+      /* the old blocks stay valid until the copy is complete */
+      NodeRef root = BVH::emptyNode;
+      dst->alloc.replaceBlocks(bytes, [&] (char* data) {
+          if (layout == HOT_FIRST) copyTop(bvh->root,data,root);
+          else                     copy(bvh->root,data,0,0,root);
+        });
+      dst->set(root,bvh->bounds,bvh->numPrimitives);
+      return true;
+    }
+
+    template<int N>
+    static typename BVHNRelayout<N>::Layout relayoutMode(BVHN<N>* bvh)
+    {
+      if (bvh->scene && bvh->scene->device->bvh_layout == "hot_first")
+        return BVHNRelayout<N>::HOT_FIRST;
+      return BVHNRelayout<N>::DEPTH_FIRST;
+    }
+
+    void BVH4Relayout(void* accel)
+    {
+      /* the tessellation cache references subdivision patches by address */
+      BVH4* bvh = (BVH4*)(AccelData*)accel;
+      if (bvh->primTy == &SubdivPatch1::type) return;
+      BVHNRelayout<4>(bvh,relayoutMode(bvh)).relayout();
+    }
+
+#if defined(__AVX__)
+    void BVH8Relayout(void* accel)
+    {
+      BVH8* bvh = (BVH8*)(AccelData*)accel;
+      BVHNRelayout<8>(bvh,relayoutMode(bvh)).relayout();
+    }
+#endif
+
+    template class BVHNRelayout<4>;
+#if defined(__AVX__)
+    template class BVHNRelayout<8>;
+#endif
+  }
+}
@@ -0,0 +1,95 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "bvh.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Copies a built BVH into a single block of the BVH allocator. The
+     *  nodes and leaves are stored in depth first order, each node
+     *  followed by the subtrees of its children. The layout thus only
+     *  depends on the topology of the BVH, not on which thread
+     *  allocated which node during the build. Subtrees not allocated
+     *  by the BVH itself, e.g. object BVHs of a two-level BVH, are
+     *  referenced as before.
+     *
+     *  The hot first layout instead stores the nodes of the top levels
+     *  contiguously in breadth first order. Below, each node is followed
+     *  by the primitives of its leaf children and then by the subtrees of
+     *  its inner children in order of decreasing surface area, thus the
+     *  children most likely visited by a ray are stored closest to their
+     *  parent. */
+    template<int N>
+    class BVHNRelayout
+    {
+      /*! Type shortcuts */
+      typedef BVHN<N> BVH;
+      typedef typename BVH::BaseNode BaseNode;
+      typedef typename BVH::NodeRef NodeRef;
+
+    public:
+      static const size_t PARALLEL_DEPTH = 3;  //!< nodes up to that depth copy their children in parallel
+      static const size_t TOP_DEPTH = 3;       //!< nodes above that depth are stored breadth first in the hot first layout
+
+      enum Layout {
+        DEPTH_FIRST,  //!< each node followed by the subtrees of its children
+        HOT_FIRST     //!< top levels breadth first, below each node followed by its leaves and largest subtrees first
+      };
+
+    public:
+      BVHNRelayout (BVH* bvh, Layout layout = DEPTH_FIRST);
+
+      /*! copies the BVH into the new layout, returns false if the BVH stayed unchanged */
+      bool relayout();
+
+      /*! copies the BVH into the new layout of another BVH with the same primitive type, returns false if nothing got copied */
+      bool clone(BVH* dst);
+
+    private:
+
+      /*! checks if the memory range got allocated by the BVH */
+      bool owned(const void* ptr, size_t bytes) const;
+
+      /*! returns the number of bytes of an owned node, or zero */
+      size_t nodeBytes(NodeRef ref) const;
+
+      /*! returns the number of bytes of an owned leaf, or zero */
+      size_t leafBytes(NodeRef ref) const;
+
+      /*! rounds to the alignment of each node and leaf in the new layout, the hot first layout does not let nodes straddle cache lines */
+      __forceinline size_t align(size_t bytes) const {
+        const size_t alignment = layout == HOT_FIRST ? size_t(CACHELINE_SIZE) : size_t(NodeRef::byteNodeAlignment);
+        return (bytes+alignment-1) & ~(alignment-1);
+      }
+
+      /*! returns the number of bytes of a subtree in the new layout */
+      size_t subtreeBytes(NodeRef ref, size_t depth);
+
+      /*! returns the order in which the children of a node get stored */
+      void childOrder(NodeRef ref, size_t order[N]) const;
+
+      /*! copies a subtree to some offset of the new block, returns the offset after the subtree */
+      size_t copy(NodeRef ref, char* data, size_t ofs, size_t depth, NodeRef& dst) const;
+
+      /*! copies the top levels of the BVH breadth first followed by the subtrees below */
+      void copyTop(NodeRef root, char* data, NodeRef& dst) const;
+
+    private:
+      BVH* bvh;
+      Layout layout;
+      std::vector<std::pair<size_t,size_t>> blocks;  //!< sorted address ranges of the blocks of the BVH allocator
+      SpinLock mutex;
+      std::map<size_t,size_t> sizes;                  //!< subtree sizes of the children of nodes that get copied in parallel
+    };
+
+    /*! copies a BVH into the depth first layout, or the hot first layout if selected by the bvh_layout device config */
+    void BVH4Relayout(void* accel);
+#if defined(__AVX__)
+    void BVH8Relayout(void* accel);
+#endif
+  }
+}
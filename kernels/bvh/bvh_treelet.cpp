@@ -0,0 +1,320 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "bvh_treelet.h"
+#include "../common/scene.h"
+#include "../../common/algorithms/parallel_reduce.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    template<int N>
+    BVHNTreeletOptimizer<N>::Treelet::Treelet (size_t maxLeaves)
+      : numLeaves(0), numNodes(0), numFrozen(0),
+        bounds(size_t(1) << maxLeaves), cost(N*(size_t(1) << maxLeaves)), split(N*(size_t(1) << maxLeaves)) {}
+
+    template<int N>
+    BVHNTreeletOptimizer<N>::BVHNTreeletOptimizer (BVH* bvh, size_t maxLeaves, double deadline)
+      : bvh(bvh), maxLeaves(clamp(maxLeaves,size_t(N+1),size_t(MAX_TREELET_LEAVES))), deadline(deadline) {}
+
+    template<int N>
+    size_t BVHNTreeletOptimizer<N>::optimize()
+    {
+      if (!bvh->root.isAABBNode() || bvh->root.isBarrier())
+        return 0;
+
+      /* later passes can improve treelets whose leaves got restructured by the previous pass */
+      size_t numRestructured = 0;
+      for (size_t pass=0; pass<MAX_PASSES; pass++)
+      {
+        /* nodes outside the blocks of the BVH allocator belong to other BVHs, e.g. objects of a two-level BVH */
+        bvh->alloc.cleanup();
+        blocks.clear();
+        bvh->alloc.gatherBlockRanges(blocks);
+        std::sort(blocks.begin(),blocks.end());
+
+        Treelet treelet(maxLeaves);
+        const size_t n = recurse(bvh->root,0,treelet);
+        numRestructured += n;
+        if (n == 0 || timeout()) break;
+      }
+
+      /* new nodes got allocated for treelets that need more inner nodes than before */
+      bvh->alloc.cleanup();
+      return numRestructured;
+    }
+
+    template<int N>
+    bool BVHNTreeletOptimizer<N>::owned(NodeRef ref) const
+    {
+      const size_t ptr = (size_t) ref.getAABBNode();
+      auto block = std::upper_bound(blocks.begin(),blocks.end(),std::make_pair(ptr,std::numeric_limits<size_t>::max()));
+      if (block == blocks.begin()) return false;
+      --block;
+      return ptr >= block->first && ptr+sizeof(AABBNode) <= block->second;
+    }
+
+    template<int N>
+    size_t BVHNTreeletOptimizer<N>::recurse(NodeRef ref, size_t depth, Treelet& treelet)
+    {
+      if (!expandable(ref) || timeout())
+        return 0;
+
+      size_t numRestructured = restructure(ref,depth,treelet) ? 1 : 0;
+
+      AABBNode* node = ref.getAABBNode();
+      if (depth < PARALLEL_DEPTH)
+      {
+        numRestructured += parallel_reduce(size_t(0), size_t(N), size_t(1), size_t(0), [&] (const range<size_t>& r) -> size_t {
+            Treelet ltreelet(maxLeaves);
+            size_t n = 0;
+            for (size_t i=r.begin(); i<r.end(); i++)
+              n += recurse(node->child(i),depth+1,ltreelet);
+            return n;
+          }, std::plus<size_t>());
+      }
+      else
+      {
+        for (size_t i=0; i<N; i++)
+          numRestructured += recurse(node->child(i),depth+1,treelet);
+      }
+      return numRestructured;
+    }
+
+    template<int N>
+    float BVHNTreeletOptimizer<N>::gather(AABBNode* root, Treelet& treelet)
+    {
+      treelet.numLeaves = treelet.numNodes = treelet.numFrozen = 0;
+      for (size_t i=0; i<N; i++)
+      {
+        if (root->child(i) == BVH::emptyNode) break;
+        treelet.leaves[treelet.numLeaves] = root->child(i);
+        treelet.leafBounds[treelet.numLeaves] = root->bounds(i);
+        treelet.leafDepth[treelet.numLeaves] = 1;
+        treelet.numLeaves++;
+      }
+
+      float cost = 0.0f;
+      while (true)
+      {
+        /* expand the treelet leaf with largest surface area */
+        ssize_t best = -1;
+        float bestArea = neg_inf;
+        for (size_t i=0; i<treelet.numLeaves; i++) {
+          if (expandable(treelet.leaves[i]) && halfArea(treelet.leafBounds[i]) > bestArea) {
+            best = i; bestArea = halfArea(treelet.leafBounds[i]);
+          }
+        }
+        if (best == -1) break;
+
+        AABBNode* node = treelet.leaves[best].getAABBNode();
+        size_t numChildren = 0;
+        while (numChildren < N && node->child(numChildren) != BVH::emptyNode) numChildren++;
+
+        /* children of the treelet root with smallest area keep their place when the treelet gets too large */
+        ssize_t numFreeze = ssize_t(treelet.numLeaves+numChildren-1) - ssize_t(maxLeaves);
+        if (numFreeze > 0)
+        {
+          ssize_t numCandidates = 0;
+          for (size_t i=0; i<treelet.numLeaves; i++)
+            numCandidates += ssize_t(i) != best && treelet.leafDepth[i] == 1;
+          if (numFreeze > numCandidates || treelet.numFrozen+numFreeze+2 > N)
+            break;
+
+          for (ssize_t j=0; j<numFreeze; j++)
+          {
+            ssize_t smallest = -1;
+            float smallestArea = pos_inf;
+            for (size_t i=0; i<treelet.numLeaves; i++) {
+              if (ssize_t(i) != best && treelet.leafDepth[i] == 1 && halfArea(treelet.leafBounds[i]) < smallestArea) {
+                smallest = i; smallestArea = halfArea(treelet.leafBounds[i]);
+              }
+            }
+            treelet.frozen[treelet.numFrozen] = treelet.leaves[smallest];
+            treelet.frozenBounds[treelet.numFrozen] = treelet.leafBounds[smallest];
+            treelet.numFrozen++;
+
+            const size_t last = --treelet.numLeaves;
+            treelet.leaves[smallest] = treelet.leaves[last];
+            treelet.leafBounds[smallest] = treelet.leafBounds[last];
+            treelet.leafDepth[smallest] = treelet.leafDepth[last];
+            if (best == ssize_t(last)) best = smallest;
+          }
+        }
+
+        /* replace the expanded leaf by its children */
+        const size_t depth = treelet.leafDepth[best];
+        treelet.nodes[treelet.numNodes++] = node;
+        cost += bestArea;
+        for (size_t i=0; i<numChildren; i++)
+        {
+          const size_t slot = i == 0 ? size_t(best) : treelet.numLeaves++;
+          treelet.leaves[slot] = node->child(i);
+          treelet.leafBounds[slot] = node->bounds(i);
+          treelet.leafDepth[slot] = depth+1;
+        }
+      }
+      return cost;
+    }
+
+    template<int N>
+    void BVHNTreeletOptimizer<N>::partition(Treelet& treelet, size_t K)
+    {
+      /* cost[N*S+k-1] is the cost of the inner nodes when storing the leaves of S in at most k subtrees,
+       * cost[N*S] equals the cost of a single inner node over S. Subsets are processed in increasing
+       * order, such that all proper subsets of S are already done. */
+      const unsigned numSets = 1u << treelet.numLeaves;
+      for (unsigned S=1; S<numSets; S++)
+      {
+        const unsigned lowest = S & (0-S);
+        float* cost = &treelet.cost[N*S];
+        unsigned* split = &treelet.split[N*S];
+
+        if (S == lowest)
+        {
+          treelet.bounds[S] = treelet.leafBounds[bsf(S)];
+          for (size_t k=0; k<N; k++) {
+            cost[k] = 0.0f; split[k] = S;
+          }
+          continue;
+        }
+        treelet.bounds[S] = merge(treelet.bounds[S^lowest],treelet.leafBounds[bsf(S)]);
+
+        /* all partitions of S are enumerated by their subtree that contains the lowest leaf */
+        float best[N];
+        for (size_t k=0; k<N; k++) {
+          best[k] = pos_inf; split[k] = S;
+        }
+        const unsigned rest = S ^ lowest;
+        for (unsigned sub = (rest-1) & rest; ; sub = (sub-1) & rest)
+        {
+          const unsigned T = lowest | sub;
+          const float costT = treelet.cost[N*T];
+          const float* costR = &treelet.cost[N*(S^T)];
+          for (size_t k=1; k<N; k++) {
+            const float c = costT + costR[k-1];
+            if (c < best[k]) { best[k] = c; split[k] = T; }
+          }
+          if (sub == 0) break;
+        }
+
+        /* an inner node has at least two children */
+        cost[0] = halfArea(treelet.bounds[S]) + best[N-1];
+        split[0] = split[N-1];
+        for (size_t k=1; k<N; k++) {
+          if (cost[0] <= best[k]) { cost[k] = cost[0]; split[k] = S; }
+          else cost[k] = best[k];
+        }
+      }
+    }
+
+    template<int N>
+    size_t BVHNTreeletOptimizer<N>::groups(const Treelet& treelet, unsigned set, size_t k, unsigned* groups) const
+    {
+      size_t n = 0;
+      while (true)
+      {
+        const unsigned T = k > 1 ? treelet.split[N*set+k-1] : set;
+        groups[n++] = T;
+        if (T == set) break;
+        set ^= T; k--;
+      }
+      return n;
+    }
+
+    template<int N>
+    bool BVHNTreeletOptimizer<N>::checkDepth(const Treelet& treelet, unsigned set, size_t depth, size_t rootDepth) const
+    {
+      /* subtrees may not move deeper as their height is unknown, leaves may move down to the build depth limit */
+      if ((set & (set-1)) == 0)
+      {
+        const size_t i = bsf(set);
+        if (treelet.leaves[i].isLeaf()) return rootDepth+depth <= BVH::maxBuildDepthLeaf;
+        return depth <= treelet.leafDepth[i];
+      }
+
+      const unsigned first = treelet.split[N*set];
+      unsigned children[N];
+      const size_t numChildren = 1+groups(treelet,set^first,N-1,children+1);
+      children[0] = first;
+      for (size_t i=0; i<numChildren; i++)
+        if (!checkDepth(treelet,children[i],depth+1,rootDepth))
+          return false;
+      return true;
+    }
+
+    template<int N>
+    typename BVHNTreeletOptimizer<N>::NodeRef BVHNTreeletOptimizer<N>::create(Treelet& treelet, unsigned set, size_t& nextNode)
+    {
+      if ((set & (set-1)) == 0)
+        return treelet.leaves[bsf(set)];
+
+      /* reuse the inner nodes of the old treelet before allocating new ones */
+      AABBNode* node = nullptr;
+      if (nextNode < treelet.numNodes)
+        node = treelet.nodes[nextNode++];
+      else
+        node = (AABBNode*) bvh->alloc.getCachedAllocator().malloc0(sizeof(AABBNode),BVH::byteNodeAlignment);
+      node->clear();
+
+      const unsigned first = treelet.split[N*set];
+      unsigned children[N];
+      const size_t numChildren = 1+groups(treelet,set^first,N-1,children+1);
+      children[0] = first;
+      for (size_t i=0; i<numChildren; i++)
+        node->set(i,create(treelet,children[i],nextNode),treelet.bounds[children[i]]);
+      return BVH::encodeNode(node);
+    }
+
+    template<int N>
+    bool BVHNTreeletOptimizer<N>::restructure(NodeRef ref, size_t depth, Treelet& treelet)
+    {
+      AABBNode* root = ref.getAABBNode();
+      const float oldCost = gather(root,treelet);
+      if (treelet.numNodes == 0)
+        return false;
+
+      const size_t K = N-treelet.numFrozen;
+      partition(treelet,K);
+
+      /* only accept clear improvements to not restructure back and forth due to rounding */
+      const unsigned all = (1u << treelet.numLeaves)-1;
+      const float newCost = treelet.cost[N*all+K-1];
+      if (!(newCost < 0.999f*oldCost))
+        return false;
+
+      unsigned children[N];
+      const size_t numChildren = groups(treelet,all,K,children);
+      for (size_t i=0; i<numChildren; i++)
+        if (!checkDepth(treelet,children[i],1,depth))
+          return false;
+
+      /* all leaves and nodes of the old treelet got recorded, so nodes can get overwritten now */
+      root->clear();
+      size_t slot = 0, nextNode = 0;
+      for (size_t i=0; i<treelet.numFrozen; i++)
+        root->set(slot++,treelet.frozen[i],treelet.frozenBounds[i]);
+      for (size_t i=0; i<numChildren; i++)
+        root->set(slot++,create(treelet,children[i],nextNode),treelet.bounds[children[i]]);
+      return true;
+    }
+
+    void BVH4TreeletOptimize(void* accel, double deadline) {
+      BVH4* bvh = (BVH4*)(AccelData*)accel;
+      BVHNTreeletOptimizer<4>(bvh,bvh->scene->device->treelet_size,deadline).optimize();
+    }
+
+#if defined(__AVX__)
+    void BVH8TreeletOptimize(void* accel, double deadline) {
+      BVH8* bvh = (BVH8*)(AccelData*)accel;
+      BVHNTreeletOptimizer<8>(bvh,bvh->scene->device->treelet_size,deadline).optimize();
+    }
+#endif
+
+    template class BVHNTreeletOptimizer<4>;
+#if defined(__AVX__)
+    template class BVHNTreeletOptimizer<8>;
+#endif
+  }
+}
@@ -0,0 +1,112 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "bvh.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Treelet restructuring pass that runs after a BVH got built. For
+     *  each node a small treelet is formed by expanding the descendants
+     *  with the largest surface area. The leaves of that treelet are then
+     *  rearranged into the topology of lowest SAH cost, found by dynamic
+     *  programming over all subsets of the treelet leaves. */
+    template<int N>
+    class BVHNTreeletOptimizer
+    {
+      /*! Type shortcuts */
+      typedef BVHN<N> BVH;
+      typedef typename BVH::AABBNode AABBNode;
+      typedef typename BVH::NodeRef NodeRef;
+
+    public:
+      static const size_t MAX_TREELET_LEAVES = 12;  //!< maximum number of leaves of a treelet
+      static const size_t MAX_PASSES = 3;           //!< maximum number of passes over the BVH
+      static const size_t PARALLEL_DEPTH = 3;       //!< nodes up to that depth process their children in parallel
+
+    private:
+
+      /*! per thread workspace to optimize a single treelet */
+      struct Treelet
+      {
+        Treelet (size_t maxLeaves);
+
+      public:
+        size_t numLeaves;
+        NodeRef leaves[MAX_TREELET_LEAVES];           //!< subtrees at the bottom of the treelet
+        BBox3fa leafBounds[MAX_TREELET_LEAVES];
+        size_t leafDepth[MAX_TREELET_LEAVES];         //!< depth of each treelet leaf below the treelet root
+
+        size_t numNodes;
+        AABBNode* nodes[MAX_TREELET_LEAVES];          //!< inner nodes of the treelet without the treelet root
+
+        size_t numFrozen;
+        NodeRef frozen[N];                            //!< children of the treelet root that keep their place
+        BBox3fa frozenBounds[N];
+
+        avector<BBox3fa> bounds;                      //!< bounds of each subset of leaves
+        std::vector<float> cost;                      //!< cost of each subset of leaves when stored in k subtrees
+        std::vector<unsigned> split;                  //!< first subtree of the cheapest partition of each subset
+      };
+
+    public:
+
+      /*! Constructor. The optimization stops when reaching the deadline, a deadline of zero runs all passes. */
+      BVHNTreeletOptimizer (BVH* bvh, size_t maxLeaves, double deadline);
+
+      /*! optimizes the BVH, returns the number of restructured treelets */
+      size_t optimize();
+
+    private:
+
+      /*! checks if the node got allocated by the BVH, nodes of other BVHs are never modified */
+      bool owned(NodeRef ref) const;
+
+      /*! checks if a treelet leaf can get expanded into its children */
+      __forceinline bool expandable(NodeRef ref) const {
+        return ref.isAABBNode() && !ref.isBarrier() && owned(ref);
+      }
+
+      /*! checks if the time budget is exhausted */
+      __forceinline bool timeout() const {
+        return deadline > 0.0 && getSeconds() > deadline;
+      }
+
+      /*! optimizes the treelets of a subtree top down, returns the number of restructured treelets */
+      size_t recurse(NodeRef ref, size_t depth, Treelet& treelet);
+
+      /*! restructures the treelet rooted at some node, returns true if the treelet got changed */
+      bool restructure(NodeRef ref, size_t depth, Treelet& treelet);
+
+      /*! forms the treelet below some node, returns the cost of its current inner nodes */
+      float gather(AABBNode* root, Treelet& treelet);
+
+      /*! finds the cheapest topology over all subsets of treelet leaves */
+      void partition(Treelet& treelet, size_t K);
+
+      /*! decomposes a subset into the subtrees of its cheapest partition into at most k subtrees */
+      size_t groups(const Treelet& treelet, unsigned set, size_t k, unsigned* groups) const;
+
+      /*! checks that no subtree moves deeper than allowed */
+      bool checkDepth(const Treelet& treelet, unsigned set, size_t depth, size_t rootDepth) const;
+
+      /*! creates the subtree over some subset of treelet leaves */
+      NodeRef create(Treelet& treelet, unsigned set, size_t& nextNode);
+
+    private:
+      BVH* bvh;
+      size_t maxLeaves;
+      double deadline;
+      std::vector<std::pair<size_t,size_t>> blocks;  //!< sorted address ranges of the blocks of the BVH allocator
+    };
+
+    /*! optimizes a BVH until the deadline passed */
+    void BVH4TreeletOptimize(void* accel, double deadline);
+#if defined(__AVX__)
+    void BVH8TreeletOptimize(void* accel, double deadline);
+#endif
+  }
+}
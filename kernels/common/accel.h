@@ -116,6 +116,24 @@ namespace embree
                                     RTCRay16& ray,      /*!< ray packet to test occlusion. */
                                     RayQueryContext* context);
 
+    /*! Type of intersect function pointer for queues of single rays. */
+    typedef void (*IntersectQueueFunc) (Intersectors* This, /*!< this pointer to accel */
+                                        RTCRayHit** rays,   /*!< pointers to the rays to intersect */
+                                        size_t M,           /*!< number of rays */
+                                        RayQueryContext* context);
+
+    /*! Type of occlusion function pointer for queues of single rays. */
+    typedef void (*OccludedQueueFunc) (Intersectors* This, /*!< this pointer to accel */
+                                       RTCRay** rays,      /*!< pointers to the rays to test occlusion */
+                                       size_t M,           /*!< number of rays */
+                                       RayQueryContext* context);
+
+    /*! Type of occlusion function pointer for batches of single rays with nearby origins, traversed using frusta. */
+    typedef void (*OccludedFrustumFunc) (Intersectors* This, /*!< this pointer to accel */
+                                         RTCRay** rays,      /*!< pointers to the rays to test occlusion */
+                                         size_t M,           /*!< number of rays */
+                                         RayQueryContext* context);
+
     typedef void (*ErrorFunc) ();
 
     struct Collider
@@ -136,13 +154,17 @@ namespace embree
     struct Intersector1
     {
       Intersector1 (ErrorFunc error = nullptr)
-      : intersect((IntersectFunc)error), occluded((OccludedFunc)error), name(nullptr) {}
+      : intersect((IntersectFunc)error), occluded((OccludedFunc)error), intersectQueue(nullptr), occludedQueue(nullptr), occludedFrustum(nullptr), name(nullptr) {}
       
       Intersector1 (IntersectFunc intersect, OccludedFunc occluded, const char* name)
-      : intersect(intersect), occluded(occluded), pointQuery(nullptr), name(name) {}
+      : intersect(intersect), occluded(occluded), pointQuery(nullptr), intersectQueue(nullptr), occludedQueue(nullptr), occludedFrustum(nullptr), name(name) {}
       
       Intersector1 (IntersectFunc intersect, OccludedFunc occluded, PointQueryFunc pointQuery, const char* name)
-      : intersect(intersect), occluded(occluded), pointQuery(pointQuery), name(name) {}
+      : intersect(intersect), occluded(occluded), pointQuery(pointQuery), intersectQueue(nullptr), occludedQueue(nullptr), occludedFrustum(nullptr), name(name) {}
+
+      Intersector1 (IntersectFunc intersect, OccludedFunc occluded, PointQueryFunc pointQuery,
+                    IntersectQueueFunc intersectQueue, OccludedQueueFunc occludedQueue, OccludedFrustumFunc occludedFrustum, const char* name)
+      : intersect(intersect), occluded(occluded), pointQuery(pointQuery), intersectQueue(intersectQueue), occludedQueue(occludedQueue), occludedFrustum(occludedFrustum), name(name) {}
 
       operator bool() const { return name; }
 
@@ -151,6 +173,9 @@ namespace embree
       IntersectFunc intersect;
       OccludedFunc occluded;
       PointQueryFunc pointQuery;
+      IntersectQueueFunc intersectQueue;
+      OccludedQueueFunc occludedQueue;
+      OccludedFrustumFunc occludedFrustum;
       const char* name;
     };
     
@@ -270,6 +295,12 @@ namespace embree
         intersector1.intersect(this,ray,context);
       }
 
+      /*! Intersects a queue of single rays breadth first with the scene. */
+      __forceinline void intersectQueue (RTCRayHit** rays, size_t M, RayQueryContext* context) {
+        assert(intersector1.intersectQueue);
+        intersector1.intersectQueue(this,rays,M,context);
+      }
+
       /*! Intersects a packet of 4 rays with the scene. */
       __forceinline void intersect4 (const void* valid, RTCRayHit4& ray, RayQueryContext* context) {
         assert(intersector4.intersect);
@@ -330,7 +361,19 @@ namespace embree
         assert(intersector1.occluded);
         intersector1.occluded(this,ray,context);
       }
-      
+
+      /*! Tests if a queue of single rays is occluded by the scene, traversing breadth first. */
+      __forceinline void occludedQueue (RTCRay** rays, size_t M, RayQueryContext* context) {
+        assert(intersector1.occludedQueue);
+        intersector1.occludedQueue(this,rays,M,context);
+      }
+
+      /*! Tests if a batch of single rays with nearby origins is occluded by the scene, culling subtrees using frusta. */
+      __forceinline void occludedFrustum (RTCRay** rays, size_t M, RayQueryContext* context) {
+        assert(intersector1.occludedFrustum);
+        intersector1.occludedFrustum(this,rays,M,context);
+      }
+
       /*! Tests if a packet of 4 rays is occluded by the scene. */
       __forceinline void occluded4 (const void* valid, RTCRay4& ray, RayQueryContext* context) {
         assert(intersector4.occluded);
@@ -450,6 +493,17 @@ namespace embree
                                (Accel::PointQueryFunc)intersector::pointQuery,\
                                TOSTRING(isa) "::" TOSTRING(symbol));          \
   }
+
+#define DEFINE_INTERSECTOR1_QUEUE(symbol,intersector)                                  \
+  Accel::Intersector1 symbol() {                                                       \
+    return Accel::Intersector1((Accel::IntersectFunc     )intersector::intersect,      \
+                               (Accel::OccludedFunc      )intersector::occluded,       \
+                               (Accel::PointQueryFunc    )intersector::pointQuery,     \
+                               (Accel::IntersectQueueFunc)intersector::intersectQueue, \
+                               (Accel::OccludedQueueFunc )intersector::occludedQueue,  \
+                               (Accel::OccludedFrustumFunc)intersector::occludedFrustum,\
+                               TOSTRING(isa) "::" TOSTRING(symbol));                   \
+  }
   
 #define DEFINE_INTERSECTOR4(symbol,intersector)                               \
   Accel::Intersector4 symbol() {                                              \
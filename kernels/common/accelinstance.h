@@ -34,6 +34,10 @@ namespace embree
       if (builder) builder->clear();
     }
 
+    AccelData* getAccel() const {
+      return accel.get();
+    }
+
   private:
     std::unique_ptr<AccelData> accel;
     std::unique_ptr<Builder> builder;
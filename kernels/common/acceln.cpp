@@ -49,6 +49,14 @@ namespace embree
         This->accels[i]->intersectors.intersect(ray,context);
   }
 
+  void AccelN::intersectQueue (Accel::Intersectors* This_in, RTCRayHit** rays, size_t M, RayQueryContext* context)
+  {
+    AccelN* This = (AccelN*)This_in->ptr;
+    for (size_t i=0; i<This->accels.size(); i++)
+      if (!This->accels[i]->isEmpty())
+        This->accels[i]->intersectors.intersectQueue(rays,M,context);
+  }
+
   void AccelN::intersect4 (const void* valid, Accel::Intersectors* This_in, RTCRayHit4& ray, RayQueryContext* context) 
   {
     AccelN* This = (AccelN*)This_in->ptr;
@@ -83,6 +91,23 @@ namespace embree
     }
   }
 
+  void AccelN::occludedQueue (Accel::Intersectors* This_in, RTCRay** rays, size_t M, RayQueryContext* context)
+  {
+    /* rays already found occluded are skipped by the queue traversal of later accels */
+    AccelN* This = (AccelN*)This_in->ptr;
+    for (size_t i=0; i<This->accels.size(); i++)
+      if (!This->accels[i]->isEmpty())
+        This->accels[i]->intersectors.occludedQueue(rays,M,context);
+  }
+
+  void AccelN::occludedFrustum (Accel::Intersectors* This_in, RTCRay** rays, size_t M, RayQueryContext* context)
+  {
+    AccelN* This = (AccelN*)This_in->ptr;
+    for (size_t i=0; i<This->accels.size(); i++)
+      if (!This->accels[i]->isEmpty())
+        This->accels[i]->intersectors.occludedFrustum(rays,M,context);
+  }
+
   void AccelN::occluded4 (const void* valid, Accel::Intersectors* This_in, RTCRay4& ray, RayQueryContext* context) 
   {
     AccelN* This = (AccelN*)This_in->ptr;
@@ -164,8 +189,12 @@ namespace embree
     bool valid4 = true;
     bool valid8 = true;
     bool valid16 = true;
+    bool validQueue = true;
+    bool validFrustum = true;
     for (size_t i=0; i<accels.size(); i++) {
       valid1 &= (bool) accels[i]->intersectors.intersector1;
+      validQueue &= accels[i]->isEmpty() || (accels[i]->intersectors.intersector1.intersectQueue && accels[i]->intersectors.intersector1.occludedQueue);
+      validFrustum &= accels[i]->isEmpty() || accels[i]->intersectors.intersector1.occludedFrustum;
       valid4 &= (bool) accels[i]->intersectors.intersector4;
       valid8 &= (bool) accels[i]->intersectors.intersector8;
       valid16 &= (bool) accels[i]->intersectors.intersector16;
@@ -180,7 +209,11 @@ namespace embree
     {
       type = AccelData::TY_ACCELN;
       intersectors.ptr = this;
-      intersectors.intersector1  = Intersector1(&intersect,&occluded,&pointQuery,valid1 ? "AccelN::intersector1": nullptr);
+      intersectors.intersector1  = Intersector1(&intersect,&occluded,&pointQuery,
+                                                validQueue ? &intersectQueue : nullptr,
+                                                validQueue ? &occludedQueue : nullptr,
+                                                validFrustum ? &occludedFrustum : nullptr,
+                                                valid1 ? "AccelN::intersector1": nullptr);
       intersectors.intersector4  = Intersector4(&intersect4,&occluded4,valid4 ? "AccelN::intersector4" : nullptr);
       intersectors.intersector8  = Intersector8(&intersect8,&occluded8,valid8 ? "AccelN::intersector8" : nullptr);
       intersectors.intersector16 = Intersector16(&intersect16,&occluded16,valid16 ? "AccelN::intersector16": nullptr);
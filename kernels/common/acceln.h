@@ -26,12 +26,15 @@ namespace embree
     static void intersect4 (const void* valid, Accel::Intersectors* This, RTCRayHit4& ray, RayQueryContext* context);
     static void intersect8 (const void* valid, Accel::Intersectors* This, RTCRayHit8& ray, RayQueryContext* context);
     static void intersect16 (const void* valid, Accel::Intersectors* This, RTCRayHit16& ray, RayQueryContext* context);
+    static void intersectQueue (Accel::Intersectors* This, RTCRayHit** rays, size_t M, RayQueryContext* context);
 
   public:
     static void occluded (Accel::Intersectors* This, RTCRay& ray, RayQueryContext* context);
     static void occluded4 (const void* valid, Accel::Intersectors* This, RTCRay4& ray, RayQueryContext* context);
     static void occluded8 (const void* valid, Accel::Intersectors* This, RTCRay8& ray, RayQueryContext* context);
     static void occluded16 (const void* valid, Accel::Intersectors* This, RTCRay16& ray, RayQueryContext* context);
+    static void occludedQueue (Accel::Intersectors* This, RTCRay** rays, size_t M, RayQueryContext* context);
+    static void occludedFrustum (Accel::Intersectors* This, RTCRay** rays, size_t M, RayQueryContext* context);
 
   public:
     void accels_print(size_t ident);
@@ -32,7 +32,7 @@ namespace embree
   public:
 
     struct ThreadLocal2;
-    enum AllocationType { ALIGNED_MALLOC, EMBREE_OS_MALLOC, SHARED, ANY_TYPE };
+    enum AllocationType { ALIGNED_MALLOC, EMBREE_OS_MALLOC, SHARED, MAPPED, ANY_TYPE };
 
     /*! Per thread structure holding the current memory block. */
     struct __aligned(64) ThreadLocal
@@ -459,6 +459,15 @@ namespace embree
       thread_local_allocators.clear();
     }
 
+    /*! appends the address range of each block, used to test if some memory got allocated by this allocator */
+    void gatherBlockRanges(std::vector<std::pair<size_t,size_t>>& ranges) const
+    {
+      for (Block* block = usedBlocks.load(); block; block = block->next)
+        ranges.push_back(std::make_pair((size_t)&block->data[0],(size_t)&block->data[0]+block->reserveEnd));
+      for (Block* block = freeBlocks.load(); block; block = block->next)
+        ranges.push_back(std::make_pair((size_t)&block->data[0],(size_t)&block->data[0]+block->reserveEnd));
+    }
+
     /*! resets the allocator, memory blocks get reused */
     void reset ()
     {
@@ -594,6 +603,40 @@ namespace embree
       freeBlocks = new (aptr) Block(SHARED,bytes-sizeof_Header,bytes-sizeof_Header,freeBlocks,ofs);
     }
 
+    /*! adds a memory mapped file as used block, the data starts at offset ofs of the
+     *  mapping and the allocator unmaps the file when the block gets cleared */
+    void addMappedBlock(void* ptr, size_t bytes, size_t ofs)
+    {
+#if defined(APPLE) && defined(__aarch64__)
+      std::scoped_lock lock(mutex);
+#else
+      Lock<SpinLock> lock(mutex);
+#endif
+      const size_t sizeof_Header = offsetof(Block,data[0]);
+      assert(ofs >= sizeof_Header && (ofs & (maxAlignment-1)) == 0);
+      void* aptr = (char*)ptr + ofs - sizeof_Header;
+      Block* block = new (aptr) Block(MAPPED,bytes-ofs,bytes-ofs,usedBlocks,ofs-sizeof_Header);
+      block->cur = bytes-ofs;
+      usedBlocks = block;
+    }
+
+    /*! replaces all blocks by a single block of the specified size, the
+     *  closure fills the new block while the old blocks are still valid */
+    template<typename Closure>
+    void replaceBlocks(size_t bytes, const Closure& fill)
+    {
+      Block* block = Block::create(device,useUSM,bytes,bytes,nullptr,atype);
+      try {
+        fill(&block->data[0]);
+      } catch (...) {
+        block->clear_block(device,useUSM);
+        throw;
+      }
+      clear();
+      block->cur = bytes;
+      usedBlocks = block;
+    }
+
     /* special allocation only used from morton builder only a single time for each build */
     void* specialAlloc(size_t bytes)
     {
@@ -877,6 +920,10 @@ namespace embree
          if (device) device->memoryMonitor(-sizeof_Alloced,true);
         }
 
+        else if (atype == MAPPED) {
+          os_unmap_file((char*)this-wasted,wasted+sizeof_Header+reserveEnd);
+        }
+
         else /* if (atype == SHARED) */ {
         }
       }
@@ -983,6 +1030,7 @@ namespace embree
         if (atype == ALIGNED_MALLOC) std::cout << "A";
         else if (atype == EMBREE_OS_MALLOC) std::cout << "O";
         else if (atype == SHARED) std::cout << "S";
+        else if (atype == MAPPED) std::cout << "M";
         if (huge_pages) std::cout << "H";
         size_t bytesUsed = getBlockUsedBytes();
         size_t bytesFree = getBlockFreeBytes();
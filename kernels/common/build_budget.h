@@ -0,0 +1,137 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "default.h"
+#include "geometry.h"
+
+namespace embree
+{
+  /*! Estimates the duration of scene builds from the number of
+   *  primitives that get built. The per primitive cost of each build
+   *  strategy starts from a rough default and then follows the timings
+   *  of previous builds of the same scene. */
+  class BuildTimeModel
+  {
+  public:
+
+    /*! build strategies in the order of increasing cost */
+    enum Strategy
+    {
+      TWO_LEVEL_MORTON = 0, //!< Morton build of each geometry and a top level BVH over geometries
+      TWO_LEVEL_SAH,        //!< binned SAH build of each geometry and a top level BVH over geometries
+      SAH,                  //!< binned SAH build over all primitives
+      SPATIAL_SAH,          //!< binned SAH build with spatial splits
+      OPTIMIZED,            //!< spatial split build followed by treelet restructuring
+      NUM_STRATEGIES
+    };
+
+    static const size_t MIN_MEASURED_PRIMITIVES = 1024; //!< smaller builds are dominated by fixed costs and are not measured
+
+    BuildTimeModel ()
+    {
+      /* single threaded seconds per primitive */
+      static const double defaults[NUM_STRATEGIES] = { 40E-9, 120E-9, 150E-9, 300E-9, 600E-9 };
+      for (size_t i=0; i<NUM_STRATEGIES; i++) {
+        cost[i] = defaults[i];
+        measured[i] = false;
+      }
+    }
+
+    /*! strategy a build of the specified quality uses without a time budget */
+    static __forceinline Strategy strategy(RTCBuildQuality quality)
+    {
+      switch (quality) {
+      case RTC_BUILD_QUALITY_OPTIMIZED: return OPTIMIZED;
+      case RTC_BUILD_QUALITY_HIGH     : return SPATIAL_SAH;
+      case RTC_BUILD_QUALITY_MEDIUM   : return SAH;
+      default                         : return TWO_LEVEL_SAH;
+      }
+    }
+
+    /*! estimated build time in seconds */
+    __forceinline double estimate(Strategy s, size_t numPrimitives, size_t numThreads) const {
+      return cost[s]*double(numPrimitives)/double(max(numThreads,size_t(1)));
+    }
+
+    /*! updates the cost of a strategy from a measured build */
+    void update(Strategy s, size_t numPrimitives, size_t numThreads, double seconds)
+    {
+      if (numPrimitives < MIN_MEASURED_PRIMITIVES)
+        return;
+
+      const double c = seconds*double(max(numThreads,size_t(1)))/double(numPrimitives);
+
+      /* the first measurement also scales strategies without measurements of their own */
+      if (!measured[s])
+      {
+        const double scale = c/cost[s];
+        for (size_t i=0; i<NUM_STRATEGIES; i++)
+          if (!measured[i]) cost[i] *= scale;
+        measured[s] = true;
+      }
+      else
+        cost[s] = 0.5*(cost[s]+c);
+    }
+
+  private:
+    double cost[NUM_STRATEGIES];    //!< single threaded seconds per primitive
+    bool measured[NUM_STRATEGIES];  //!< true if the cost got measured
+  };
+
+  /*! Estimates the memory of the acceleration structures of a scene
+   *  from its primitive counts. The bytes per primitive include inner
+   *  nodes and allocator overhead of BVH8 builds, and follow the upper
+   *  bounds the memory consumption tests of the verify tool check. */
+  class AccelMemoryModel
+  {
+  public:
+
+    /*! acceleration structure layouts in the order of decreasing memory */
+    enum Layout
+    {
+      DEFAULT = 0,  //!< acceleration structures selected by the scene flags
+      COMPACT       //!< acceleration structures of RTC_SCENE_FLAG_COMPACT scenes, without spatial splits
+    };
+
+    /*! estimated bytes of the acceleration structures, splitFactor is the growth of the triangle and quad references through spatial splits */
+    static size_t estimate(const GeometryCounts& c, Layout layout, float splitFactor)
+    {
+      const bool compact = layout == COMPACT;
+      const double split = compact ? 1.0 : double(max(splitFactor,1.0f));
+
+      double bytes = 0.0;
+      bytes += split*double(c.numTriangles)*(compact ? 35.0 : 70.0);    // Triangle4i or Triangle4/Triangle4v
+      bytes += split*double(c.numQuads)*(compact ? 41.0 : 85.0);        // Quad4i or Quad4v
+      bytes += double(c.numMBTriangles)*55.0;                           // Triangle4iMB
+      bytes += double(c.numMBQuads)*68.0;                               // Quad4iMB
+      bytes += double(c.numBezierCurves)*(compact ? 105.0 : 222.0);     // CurveNi or CurveNv
+      bytes += double(c.numMBBezierCurves)*190.0;                       // CurveNiMB
+      bytes += double(c.numLineSegments+c.numPoints)*(compact ? 26.0 : 32.0);
+      bytes += double(c.numMBLineSegments+c.numMBPoints)*45.0;
+      bytes += double(c.numGrids+c.numMBGrids)*32.0;
+      bytes += double(c.numSubdivPatches+c.numMBSubdivPatches)*168.0;
+      bytes += double(c.numUserGeometries+c.numMBUserGeometries)*40.0;
+      bytes += double(c.numInstancesCheap+c.numMBInstancesCheap+c.numInstancesExpensive+c.numMBInstancesExpensive)*40.0;
+      return size_t(bytes);
+    }
+
+    /*! estimated bytes of the temporary arrays of primitive references that a build allocates next to the acceleration structures */
+    static size_t estimateBuild(const GeometryCounts& c, BuildTimeModel::Strategy strategy, float splitFactor)
+    {
+      const size_t numMB = c.numMBTriangles + c.numMBQuads + c.numMBBezierCurves + c.numMBLineSegments + c.numMBSubdivPatches + c.numMBUserGeometries
+                         + c.numMBInstancesCheap + c.numMBInstancesExpensive + c.numMBGrids + c.numMBPoints;
+      const size_t numStatic = c.size()-numMB;
+
+      /* Morton builds sort 8 byte codes with a second buffer, the other builds use a PrimRef or PrimRefMB per primitive */
+      double bytes = 0.0;
+      if (strategy == BuildTimeModel::TWO_LEVEL_MORTON)
+        bytes += double(numStatic)*16.0;
+      else
+        bytes += double(numStatic)*32.0*double(max(splitFactor,1.0f));
+      bytes += double(numMB)*64.0;
+      return size_t(bytes);
+    }
+  };
+}
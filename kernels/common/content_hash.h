@@ -0,0 +1,92 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "default.h"
+#include "../../common/algorithms/parallel_for.h"
+
+namespace embree
+{
+  /*! Computes a 64 bit hash over memory ranges and strided buffers. Large
+   *  buffers are hashed in parallel using a fixed decomposition into
+   *  blocks, thus the hash does not depend on the number of threads. */
+  class ContentHash
+  {
+  public:
+    static const size_t BLOCK_SIZE = 4096; //!< number of buffer elements hashed by a single task
+
+    ContentHash (uint64_t seed = 0)
+      : hash(mix(seed ^ 0x9E3779B97F4A7C15ull)) {}
+
+    /*! hashes a single value */
+    template<typename T>
+      __forceinline void add(const T& value) {
+      add(&value,sizeof(T));
+    }
+
+    /*! hashes a string including its length */
+    void add(const std::string& str) {
+      add(str.size());
+      add(str.data(),str.size());
+    }
+
+    /*! hashes a memory range */
+    void add(const void* ptr, size_t bytes) {
+      hash = mix(hashBytes(ptr,bytes,hash));
+    }
+
+    /*! hashes num elements of elementBytes each that are stride bytes apart, padding between elements is ignored */
+    void add(const char* ptr, size_t stride, size_t num, size_t elementBytes)
+    {
+      const size_t numBlocks = (num+BLOCK_SIZE-1)/BLOCK_SIZE;
+      std::vector<uint64_t> hashes(numBlocks);
+      parallel_for(numBlocks, [&] (size_t b) {
+          uint64_t h = b;
+          const size_t end = min(num,(b+1)*BLOCK_SIZE);
+          for (size_t i=b*BLOCK_SIZE; i<end; i++)
+            h = hashBytes(ptr+i*stride,elementBytes,h);
+          hashes[b] = mix(h);
+        });
+
+      add(num);
+      add(elementBytes);
+      for (size_t b=0; b<numBlocks; b++)
+        add(hashes[b]);
+    }
+
+    __forceinline uint64_t get() const {
+      return hash;
+    }
+
+  private:
+
+    /*! finalizer of MurmurHash3 */
+    static __forceinline uint64_t mix(uint64_t h)
+    {
+      h ^= h >> 33; h *= 0xff51afd7ed558ccdull;
+      h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53ull;
+      h ^= h >> 33;
+      return h;
+    }
+
+    static __forceinline uint64_t hashBytes(const void* ptr, size_t bytes, uint64_t h)
+    {
+      const char* p = (const char*) ptr;
+      for (; bytes >= 8; p += 8, bytes -= 8) {
+        uint64_t w; memcpy(&w,p,8);
+        h = ((h ^ w) * 0x87c37b91114253d5ull);
+        h = (h << 31) | (h >> 33);
+      }
+      if (bytes) {
+        uint64_t w = 0; memcpy(&w,p,bytes);
+        h = ((h ^ w) * 0x87c37b91114253d5ull);
+        h = (h << 31) | (h >> 33);
+      }
+      return h;
+    }
+
+  private:
+    uint64_t hash;
+  };
+}
@@ -10,6 +10,7 @@
 namespace embree
 {
   class Scene;
+  struct MultiHitBuffer;
 
   struct RayQueryContext
   {
@@ -45,6 +46,14 @@ namespace embree
       return embree::isIncoherent(args->flags);
     }
 
+    __forceinline bool isBreadthFirst() const {
+      return args->flags & RTC_RAY_QUERY_FLAG_BREADTH_FIRST;
+    }
+
+    __forceinline bool isMultiHit() const {
+      return multiHit != nullptr;
+    }
+
     __forceinline bool enforceArgumentFilterFunction() const {
       return args->flags & RTC_RAY_QUERY_FLAG_INVOKE_ARGUMENT_FILTER;
     }
@@ -59,6 +68,7 @@ namespace embree
     Scene* scene = nullptr;
     RTCRayQueryContext* user = nullptr;
     RTCIntersectArguments* args = nullptr;
+    MultiHitBuffer* multiHit = nullptr; // hit buffer of multi-hit queries
   };
 
   template<int M, typename Geometry>
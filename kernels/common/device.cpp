@@ -47,7 +47,7 @@ namespace embree
 #endif
   };
 
-  Device::Device (const char* cfg) : arena(new TaskArena())
+  Device::Device (const char* cfg) : arena(new TaskArena()), memory_used(0)
   {
     /* check that CPU supports lowest ISA */
     if (!hasISA(ISA)) {
@@ -321,6 +321,7 @@ namespace embree
         }
       }
     }
+    memory_used += bytes;
   }
 
   size_t getMaxNumThreads()
@@ -92,6 +92,11 @@ namespace embree
     /*! invokes the memory monitor callback */
     void memoryMonitor(ssize_t bytes, bool post);
 
+    /*! returns the number of bytes currently allocated by the device */
+    __forceinline size_t getMemoryUsed() const {
+      return size_t(max(memory_used.load(),ssize_t(0)));
+    }
+
     /*! sets the size of the software cache. */
     void setCacheSize(size_t bytes);
 
@@ -123,6 +128,8 @@ namespace embree
 
     std::unique_ptr<TaskArena> arena;
 
+    std::atomic<ssize_t> memory_used;  //!< bytes reported to the memory monitor
+
   public:
 
     // use tasking system arena to execute func
@@ -0,0 +1,108 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "default.h"
+#include "ray.h"
+#include "../../include/embree4/rtcore_ray.h"
+
+namespace embree
+{
+  /*! Sorted buffer of the nearest hits of a multi-hit query. The
+   *  buffer lives inside the ray query context, such that the
+   *  primitive intersectors record hits directly instead of committing
+   *  them to the ray. As soon as the buffer is full, the ray's tfar
+   *  gets shrunk to the distance of the farthest buffered hit, thus
+   *  traversal culls everything behind the maxHits nearest hits. */
+  struct MultiHitBuffer
+  {
+    __forceinline MultiHitBuffer(RTCMultiHit* hits, unsigned int maxHits)
+      : hits(hits), maxHits(maxHits)
+    {
+      assert(maxHits > 0 && maxHits <= RTC_MAX_MULTI_HIT_COUNT);
+      hits->numHits = 0;
+    }
+
+    __forceinline bool full() const {
+      return hits->numHits == maxHits;
+    }
+
+    /*! returns the ray distance up to which further hits are of interest */
+    __forceinline float tfar(float t) const {
+      return full() ? min(t,hits->t[maxHits-1]) : t;
+    }
+
+    /* lexicographical order (t,instID,geomID,primID) to make the order of hits at the same distance deterministic */
+    static __forceinline bool less(float ta, const RTCHit& a, float tb, const RTCHit& b)
+    {
+      if (ta != tb) return ta < tb;
+      for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT; l++)
+        if (a.instID[l] != b.instID[l]) return a.instID[l] < b.instID[l];
+      if (a.geomID != b.geomID) return a.geomID < b.geomID;
+      return a.primID < b.primID;
+    }
+
+    static __forceinline bool equal(float ta, const RTCHit& a, float tb, const RTCHit& b)
+    {
+      if (ta != tb || a.geomID != b.geomID || a.primID != b.primID) return false;
+      for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT; l++)
+        if (a.instID[l] != b.instID[l]) return false;
+      return true;
+    }
+
+    /*! inserts a hit, returns false if the hit is not among the maxHits nearest hits */
+    __forceinline bool insert(float t, const RTCHit& hit)
+    {
+      /* find insert position */
+      unsigned int i = hits->numHits;
+      while (i > 0 && less(t,hit,hits->t[i-1],hits->hit[i-1])) i--;
+
+      /* ignore duplicated hits that occur when primitives are referenced from multiple leaves */
+      if (i > 0 && equal(t,hit,hits->t[i-1],hits->hit[i-1]))
+        return false;
+
+      if (i == maxHits)
+        return false;
+
+      /* shift farther hits back, the farthest hit drops out of a full buffer */
+      const unsigned int end = min(hits->numHits+1,maxHits);
+      for (unsigned int j=end-1; j>i; j--) {
+        hits->t[j] = hits->t[j-1];
+        hits->hit[j] = hits->hit[j-1];
+      }
+      hits->t[i] = t;
+      hits->hit[i] = hit;
+      hits->numHits = end;
+      return true;
+    }
+
+    /*! records the hit currently stored in the ray, used for geometries that commit hits themselves */
+    __forceinline bool insert(const RayHit& ray)
+    {
+      RTCHit hit;
+      hit.Ng_x = ray.Ng.x;
+      hit.Ng_y = ray.Ng.y;
+      hit.Ng_z = ray.Ng.z;
+      hit.u = ray.u;
+      hit.v = ray.v;
+      hit.primID = ray.primID;
+      hit.geomID = ray.geomID;
+      for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT; l++)
+        hit.instID[l] = ray.instID[l];
+      return insert(ray.tfar,hit);
+    }
+
+    /*! stores the nearest hit in the ray like a closest hit query would */
+    __forceinline void finalize(RTCRayHit& rayhit) const
+    {
+      if (hits->numHits == 0) return;
+      rayhit.ray.tfar = hits->t[0];
+      rayhit.hit = hits->hit[0];
+    }
+
+  public:
+    RTCMultiHit* hits;
+    unsigned int maxHits;
+  };
+}
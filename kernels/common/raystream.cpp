@@ -0,0 +1,490 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "raystream.h"
+#include "scene.h"
+
+namespace embree
+{
+  namespace
+  {
+    /* maps packet width to the corresponding ray packet types */
+    template<int K> struct RTCPacket;
+    template<> struct RTCPacket<4>  { typedef RTCRay4  Ray; typedef RTCRayHit4  RayHit; };
+    template<> struct RTCPacket<8>  { typedef RTCRay8  Ray; typedef RTCRayHit8  RayHit; };
+    template<> struct RTCPacket<16> { typedef RTCRay16 Ray; typedef RTCRayHit16 RayHit; };
+
+    /* copies a single ray into lane k of a ray packet */
+    template<typename RTCRayK>
+    __forceinline void setRayK(RTCRayK& ray, size_t k, const RTCRay& r)
+    {
+      ray.org_x[k] = r.org_x;
+      ray.org_y[k] = r.org_y;
+      ray.org_z[k] = r.org_z;
+      ray.tnear[k] = r.tnear;
+      ray.dir_x[k] = r.dir_x;
+      ray.dir_y[k] = r.dir_y;
+      ray.dir_z[k] = r.dir_z;
+      ray.time [k] = r.time;
+      ray.tfar [k] = r.tfar;
+      ray.mask [k] = r.mask;
+      ray.id   [k] = r.id;
+      ray.flags[k] = r.flags;
+    }
+
+    /* copies a single hit into lane k of a hit packet */
+    template<typename RTCHitK>
+    __forceinline void setHitK(RTCHitK& hit, size_t k, const RTCHit& h)
+    {
+      hit.Ng_x[k]   = h.Ng_x;
+      hit.Ng_y[k]   = h.Ng_y;
+      hit.Ng_z[k]   = h.Ng_z;
+      hit.u[k]      = h.u;
+      hit.v[k]      = h.v;
+      hit.primID[k] = h.primID;
+      hit.geomID[k] = h.geomID;
+      for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT; l++)
+        hit.instID[l][k] = h.instID[l];
+    }
+
+    /* copies lane k of a hit packet into a single hit */
+    template<typename RTCHitK>
+    __forceinline void getHitK(const RTCHitK& hit, size_t k, RTCHit& h)
+    {
+      h.Ng_x   = hit.Ng_x[k];
+      h.Ng_y   = hit.Ng_y[k];
+      h.Ng_z   = hit.Ng_z[k];
+      h.u      = hit.u[k];
+      h.v      = hit.v[k];
+      h.primID = hit.primID[k];
+      h.geomID = hit.geomID[k];
+      for (size_t l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT; l++)
+        h.instID[l] = hit.instID[l][k];
+    }
+
+    /* stream of rays to intersect in AOS layout */
+    struct IntersectStreamAOS
+    {
+      template<int K> using Packet = typename RTCPacket<K>::RayHit;
+
+      __forceinline IntersectStreamAOS(RTCRayHit* ptr, size_t byteStride)
+        : ptr((char*)ptr), byteStride(byteStride) {}
+
+      __forceinline RTCRayHit& get(size_t i) const {
+        return *(RTCRayHit*)(ptr + i*byteStride);
+      }
+
+      __forceinline RTCRay ray(size_t i) const {
+        return get(i).ray;
+      }
+
+      template<typename PacketK>
+      __forceinline void gather(size_t i, PacketK& packet, size_t k) const
+      {
+        const RTCRayHit& rayhit = get(i);
+        setRayK(packet.ray,k,rayhit.ray);
+        setHitK(packet.hit,k,rayhit.hit);
+      }
+
+      template<typename PacketK>
+      __forceinline void scatter(size_t i, const PacketK& packet, size_t k) const
+      {
+        RTCRayHit& rayhit = get(i);
+        rayhit.ray.tfar = packet.ray.tfar[k];
+        getHitK(packet.hit,k,rayhit.hit);
+      }
+
+      __forceinline void trace(Scene* scene, size_t i, RayQueryContext* context) const {
+        scene->intersectors.intersect(get(i),context);
+      }
+
+      template<typename PacketK>
+      __forceinline void trace(Scene* scene, const int* valid, PacketK& packet, RayQueryContext* context) const {
+        scene->intersectors.intersect(valid,packet,context);
+      }
+
+      void traceQueue(Scene* scene, size_t begin, size_t end, RayQueryContext* context) const
+      {
+        std::vector<RTCRayHit*> rays; rays.reserve(end-begin);
+        for (size_t i=begin; i<end; i++) {
+          RTCRayHit& rayhit = get(i);
+          if (rayhit.ray.tnear <= rayhit.ray.tfar) rays.push_back(&rayhit);
+        }
+        scene->intersectors.intersectQueue(rays.data(),rays.size(),context);
+      }
+
+      char* ptr;
+      size_t byteStride;
+    };
+
+    /* stream of rays to intersect in SOA layout */
+    struct IntersectStreamSOA
+    {
+      template<int K> using Packet = typename RTCPacket<K>::RayHit;
+
+      __forceinline IntersectStreamSOA(RTCRayHitN* ptr, size_t N)
+        : ptr(ptr), N((unsigned int)N) {}
+
+      __forceinline RTCRay ray(size_t i) const {
+        return rtcGetRayFromRayN(RTCRayHitN_RayN(ptr,N),N,(unsigned int)i);
+      }
+
+      template<typename PacketK>
+      __forceinline void gather(size_t i, PacketK& packet, size_t k) const
+      {
+        setRayK(packet.ray,k,ray(i));
+        setHitK(packet.hit,k,rtcGetHitFromHitN(RTCRayHitN_HitN(ptr,N),N,(unsigned int)i));
+      }
+
+      template<typename PacketK>
+      __forceinline void scatter(size_t i, const PacketK& packet, size_t k) const
+      {
+        RTCHit hit; getHitK(packet.hit,k,hit);
+        RTCRayN_tfar(RTCRayHitN_RayN(ptr,N),N,(unsigned int)i) = packet.ray.tfar[k];
+        rtcCopyHitToHitN(RTCRayHitN_HitN(ptr,N),&hit,N,(unsigned int)i);
+      }
+
+      __forceinline void trace(Scene* scene, size_t i, RayQueryContext* context) const
+      {
+        RTCRayHit rayhit = rtcGetRayHitFromRayHitN(ptr,N,(unsigned int)i);
+        scene->intersectors.intersect(rayhit,context);
+        RTCRayN_tfar(RTCRayHitN_RayN(ptr,N),N,(unsigned int)i) = rayhit.ray.tfar;
+        rtcCopyHitToHitN(RTCRayHitN_HitN(ptr,N),&rayhit.hit,N,(unsigned int)i);
+      }
+
+      template<typename PacketK>
+      __forceinline void trace(Scene* scene, const int* valid, PacketK& packet, RayQueryContext* context) const {
+        scene->intersectors.intersect(valid,packet,context);
+      }
+
+      void traceQueue(Scene* scene, size_t begin, size_t end, RayQueryContext* context) const
+      {
+        std::vector<RTCRayHit> rayhits; rayhits.reserve(end-begin);
+        std::vector<unsigned int> ids; ids.reserve(end-begin);
+        for (size_t i=begin; i<end; i++) {
+          const RTCRayHit rayhit = rtcGetRayHitFromRayHitN(ptr,N,(unsigned int)i);
+          if (!(rayhit.ray.tnear <= rayhit.ray.tfar)) continue;
+          rayhits.push_back(rayhit);
+          ids.push_back((unsigned int)i);
+        }
+        std::vector<RTCRayHit*> rays(rayhits.size());
+        for (size_t i=0; i<rayhits.size(); i++) rays[i] = &rayhits[i];
+        scene->intersectors.intersectQueue(rays.data(),rays.size(),context);
+        for (size_t i=0; i<rayhits.size(); i++) {
+          RTCRayN_tfar(RTCRayHitN_RayN(ptr,N),N,ids[i]) = rayhits[i].ray.tfar;
+          rtcCopyHitToHitN(RTCRayHitN_HitN(ptr,N),&rayhits[i].hit,N,ids[i]);
+        }
+      }
+
+      RTCRayHitN* ptr;
+      unsigned int N;
+    };
+
+    /* stream of rays to test for occlusion in AOS layout */
+    struct OccludedStreamAOS
+    {
+      template<int K> using Packet = typename RTCPacket<K>::Ray;
+
+      __forceinline OccludedStreamAOS(RTCRay* ptr, size_t byteStride)
+        : ptr((char*)ptr), byteStride(byteStride) {}
+
+      __forceinline RTCRay& get(size_t i) const {
+        return *(RTCRay*)(ptr + i*byteStride);
+      }
+
+      __forceinline RTCRay ray(size_t i) const {
+        return get(i);
+      }
+
+      template<typename PacketK>
+      __forceinline void gather(size_t i, PacketK& packet, size_t k) const {
+        setRayK(packet,k,get(i));
+      }
+
+      template<typename PacketK>
+      __forceinline void scatter(size_t i, const PacketK& packet, size_t k) const {
+        get(i).tfar = packet.tfar[k];
+      }
+
+      __forceinline void trace(Scene* scene, size_t i, RayQueryContext* context) const {
+        scene->intersectors.occluded(get(i),context);
+      }
+
+      template<typename PacketK>
+      __forceinline void trace(Scene* scene, const int* valid, PacketK& packet, RayQueryContext* context) const {
+        scene->intersectors.occluded(valid,packet,context);
+      }
+
+      void traceQueue(Scene* scene, size_t begin, size_t end, RayQueryContext* context) const
+      {
+        std::vector<RTCRay*> rays; rays.reserve(end-begin);
+        for (size_t i=begin; i<end; i++) {
+          RTCRay& ray = get(i);
+          if (ray.tnear <= ray.tfar) rays.push_back(&ray);
+        }
+        scene->intersectors.occludedQueue(rays.data(),rays.size(),context);
+      }
+
+      char* ptr;
+      size_t byteStride;
+    };
+
+    /* stream of rays to test for occlusion in SOA layout */
+    struct OccludedStreamSOA
+    {
+      template<int K> using Packet = typename RTCPacket<K>::Ray;
+
+      __forceinline OccludedStreamSOA(RTCRayN* ptr, size_t N)
+        : ptr(ptr), N((unsigned int)N) {}
+
+      __forceinline RTCRay ray(size_t i) const {
+        return rtcGetRayFromRayN(ptr,N,(unsigned int)i);
+      }
+
+      template<typename PacketK>
+      __forceinline void gather(size_t i, PacketK& packet, size_t k) const {
+        setRayK(packet,k,ray(i));
+      }
+
+      template<typename PacketK>
+      __forceinline void scatter(size_t i, const PacketK& packet, size_t k) const {
+        RTCRayN_tfar(ptr,N,(unsigned int)i) = packet.tfar[k];
+      }
+
+      __forceinline void trace(Scene* scene, size_t i, RayQueryContext* context) const
+      {
+        RTCRay ray1 = ray(i);
+        scene->intersectors.occluded(ray1,context);
+        RTCRayN_tfar(ptr,N,(unsigned int)i) = ray1.tfar;
+      }
+
+      template<typename PacketK>
+      __forceinline void trace(Scene* scene, const int* valid, PacketK& packet, RayQueryContext* context) const {
+        scene->intersectors.occluded(valid,packet,context);
+      }
+
+      void traceQueue(Scene* scene, size_t begin, size_t end, RayQueryContext* context) const
+      {
+        std::vector<RTCRay> rays1; rays1.reserve(end-begin);
+        std::vector<unsigned int> ids; ids.reserve(end-begin);
+        for (size_t i=begin; i<end; i++) {
+          const RTCRay ray1 = ray(i);
+          if (!(ray1.tnear <= ray1.tfar)) continue;
+          rays1.push_back(ray1);
+          ids.push_back((unsigned int)i);
+        }
+        std::vector<RTCRay*> rays(rays1.size());
+        for (size_t i=0; i<rays1.size(); i++) rays[i] = &rays1[i];
+        scene->intersectors.occludedQueue(rays.data(),rays.size(),context);
+        for (size_t i=0; i<rays1.size(); i++)
+          RTCRayN_tfar(ptr,N,ids[i]) = rays1[i].tfar;
+      }
+
+      RTCRayN* ptr;
+      unsigned int N;
+    };
+
+    /* quantizes a coordinate into one of N cells */
+    __forceinline unsigned int quantize(float x, float lower, float scale, unsigned int N)
+    {
+      const float f = (x-lower)*scale;
+      if (!(f >= 0.0f)) return 0; // also handles NaNs
+      return min((unsigned int)min(f,float(N-1)),N-1);
+    }
+
+    /* The sort key of a ray consists of 3 bits direction octant, 18 bits
+     * morton code of the origin cell, and 9 bits morton code of the
+     * direction cell inside the octant. */
+    struct RaySortKey
+    {
+      __forceinline RaySortKey(const BBox3fa& bounds)
+        : lower(zero), scale(zero)
+      {
+        if (bounds.lower.x > bounds.upper.x) return; // empty scene
+        const Vec3fa size = bounds.size();
+        lower = bounds.lower;
+        scale.x = size.x > 0.0f ? 64.0f/size.x : 0.0f;
+        scale.y = size.y > 0.0f ? 64.0f/size.y : 0.0f;
+        scale.z = size.z > 0.0f ? 64.0f/size.z : 0.0f;
+      }
+
+      __forceinline unsigned int operator() (const RTCRay& ray) const
+      {
+        const unsigned int octant = (ray.dir_x < 0.0f ? 1 : 0) | (ray.dir_y < 0.0f ? 2 : 0) | (ray.dir_z < 0.0f ? 4 : 0);
+
+        const unsigned int ox = quantize(ray.org_x,lower.x,scale.x,64);
+        const unsigned int oy = quantize(ray.org_y,lower.y,scale.y,64);
+        const unsigned int oz = quantize(ray.org_z,lower.z,scale.z,64);
+        const unsigned int ocell = bitInterleave(ox,oy,oz);
+
+        const float len = sqrtf(ray.dir_x*ray.dir_x + ray.dir_y*ray.dir_y + ray.dir_z*ray.dir_z);
+        const float rcp_len = len > 0.0f ? 8.0f/len : 0.0f;
+        const unsigned int dx = quantize(abs(ray.dir_x),0.0f,rcp_len,8);
+        const unsigned int dy = quantize(abs(ray.dir_y),0.0f,rcp_len,8);
+        const unsigned int dz = quantize(abs(ray.dir_z),0.0f,rcp_len,8);
+        const unsigned int dcell = bitInterleave(dx,dy,dz);
+
+        return (octant << 27) | (ocell << 9) | dcell;
+      }
+
+      static __forceinline unsigned int octant(uint64_t key) {
+        return (unsigned int)(key >> 59);
+      }
+
+      Vec3fa lower;
+      Vec3fa scale;
+    };
+
+    /* returns true if the rays of some packet are sufficiently coherent for packet tracing */
+    template<typename Stream>
+    __forceinline bool isCoherent(const Stream& stream, size_t offset, const uint64_t* keys, size_t num)
+    {
+      Vec3fa sum(zero);
+      for (size_t k=0; k<num; k++) {
+        const RTCRay ray = stream.ray(offset + (unsigned int)keys[k]);
+        sum += normalize(Vec3fa(ray.dir_x,ray.dir_y,ray.dir_z));
+      }
+      const Vec3fa mean = normalize(sum);
+
+      for (size_t k=0; k<num; k++) {
+        const RTCRay ray = stream.ray(offset + (unsigned int)keys[k]);
+        if (!(dot(mean,normalize(Vec3fa(ray.dir_x,ray.dir_y,ray.dir_z))) >= RayStream::MIN_PACKET_COHERENCE))
+          return false;
+      }
+      return true;
+    }
+
+    /* traces num <= K sorted rays either as a packet or ray by ray */
+    template<int K, typename Stream>
+    __forceinline void tracePacket(Scene* scene, const Stream& stream, size_t offset, const uint64_t* keys, size_t num, RayQueryContext* context)
+    {
+      typedef typename Stream::template Packet<K> PacketK;
+
+      if (num < K/2 || !isCoherent(stream,offset,keys,num))
+      {
+        for (size_t k=0; k<num; k++)
+          stream.trace(scene,offset + (unsigned int)keys[k],context);
+        return;
+      }
+
+      /* inactive lanes get a copy of the first ray to not trace garbage data */
+      __aligned(64) int valid[K];
+      PacketK packet;
+      for (size_t k=0; k<K; k++) {
+        valid[k] = k < num ? -1 : 0;
+        stream.gather(offset + (unsigned int)keys[k < num ? k : 0],packet,k);
+      }
+
+      stream.trace(scene,valid,packet,context);
+
+      for (size_t k=0; k<num; k++)
+        stream.scatter(offset + (unsigned int)keys[k],packet,k);
+    }
+
+    template<int K, typename Stream>
+    __noinline void traceStreamK(Scene* scene, const Stream& stream, size_t M, RayQueryContext* context)
+    {
+      const RaySortKey sortKey(scene->bounds.bounds());
+      std::vector<uint64_t> keys(min(M,RayStream::MAX_SORT_RAYS));
+
+      for (size_t offset=0; offset<M; offset+=RayStream::MAX_SORT_RAYS)
+      {
+        const size_t end = min(M,offset+RayStream::MAX_SORT_RAYS);
+
+        /* sort valid rays by key, the lower 32 bits store the ray index */
+        size_t n = 0;
+        for (size_t i=offset; i<end; i++) {
+          const RTCRay ray = stream.ray(i);
+          if (!(ray.tnear <= ray.tfar)) continue;
+          keys[n++] = (uint64_t(sortKey(ray)) << 32) | uint64_t(i-offset);
+        }
+        std::sort(keys.begin(),keys.begin()+n);
+
+        /* repack runs of rays with the same octant into packets */
+        for (size_t i=0; i<n;)
+        {
+          const unsigned int octant = RaySortKey::octant(keys[i]);
+          size_t j = i+1;
+          while (j<n && j-i<K && RaySortKey::octant(keys[j]) == octant) j++;
+          tracePacket<K>(scene,stream,offset,&keys[i],j-i,context);
+          i = j;
+        }
+      }
+    }
+
+    template<typename Stream>
+    void traceStream(Scene* scene, const Stream& stream, size_t M, RayQueryContext* context)
+    {
+      /* breadth first traversal through BVH treelets */
+      if (context->isBreadthFirst() &&
+          scene->intersectors.intersector1.intersectQueue && scene->intersectors.intersector1.occludedQueue)
+      {
+        for (size_t offset=0; offset<M; offset+=RayStream::MAX_QUEUE_RAYS)
+          stream.traceQueue(scene,offset,min(M,offset+RayStream::MAX_QUEUE_RAYS),context);
+      }
+      else if (scene->intersectors.intersector16 && M >= 16*RayStream::MIN_RAYS_PER_LANE)
+        traceStreamK<16>(scene,stream,M,context);
+      else if (scene->intersectors.intersector8 && M >= 8*RayStream::MIN_RAYS_PER_LANE)
+        traceStreamK<8>(scene,stream,M,context);
+      else if (scene->intersectors.intersector4 && M >= 4*RayStream::MIN_RAYS_PER_LANE)
+        traceStreamK<4>(scene,stream,M,context);
+      else
+      {
+        for (size_t i=0; i<M; i++) {
+          const RTCRay ray = stream.ray(i);
+          if (ray.tnear <= ray.tfar)
+            stream.trace(scene,i,context);
+        }
+      }
+    }
+  }
+
+  void RayStream::intersect(Scene* scene, RTCRayHit* rayhit, size_t M, size_t byteStride, RayQueryContext* context) {
+    traceStream(scene,IntersectStreamAOS(rayhit,byteStride),M,context);
+  }
+
+  void RayStream::intersectN(Scene* scene, RTCRayHitN* rayhit, size_t N, RayQueryContext* context) {
+    traceStream(scene,IntersectStreamSOA(rayhit,N),N,context);
+  }
+
+  void RayStream::occluded(Scene* scene, RTCRay* ray, size_t M, size_t byteStride, RayQueryContext* context) {
+    traceStream(scene,OccludedStreamAOS(ray,byteStride),M,context);
+  }
+
+  void RayStream::occludedN(Scene* scene, RTCRayN* ray, size_t N, RayQueryContext* context) {
+    traceStream(scene,OccludedStreamSOA(ray,N),N,context);
+  }
+
+  void RayStream::occludedSharedOrigin(Scene* scene, const RTCRay& ray, const float* dir, float* tfar, size_t M, RayQueryContext* context)
+  {
+    std::vector<RTCRay> rays(min(M,size_t(MAX_SHARED_ORIGIN_RAYS)));
+    std::vector<RTCRay*> active(rays.size());
+
+    for (size_t offset=0; offset<M; offset+=MAX_SHARED_ORIGIN_RAYS)
+    {
+      const size_t num = min(M-offset,size_t(MAX_SHARED_ORIGIN_RAYS));
+
+      /* expand the shared origin into single rays, inactive rays are not traced */
+      size_t numActive = 0;
+      for (size_t i=0; i<num; i++)
+      {
+        RTCRay& r = rays[i];
+        r = ray;
+        r.dir_x = dir[3*(offset+i)+0];
+        r.dir_y = dir[3*(offset+i)+1];
+        r.dir_z = dir[3*(offset+i)+2];
+        r.tfar  = tfar[offset+i];
+        if (r.tnear <= r.tfar) active[numActive++] = &r;
+      }
+
+      /* the frustum traversal culls BVH subtrees for many rays at once, other scenes trace the rays as stream */
+      if (scene->intersectors.intersector1.occludedFrustum)
+        scene->intersectors.occludedFrustum(active.data(),numActive,context);
+      else
+        traceStream(scene,OccludedStreamAOS(rays.data(),sizeof(RTCRay)),num,context);
+
+      for (size_t i=0; i<num; i++)
+        tfar[offset+i] = rays[i].tfar;
+    }
+  }
+}
@@ -0,0 +1,59 @@
+// Copyright 2009-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "default.h"
+#include "context.h"
+#include "../../include/embree4/rtcore_ray.h"
+
+namespace embree
+{
+  class Scene;
+
+  /*! Traces streams of arbitrary many rays. The rays of a stream are
+   *  sorted by direction octant and origin cell, repacked into ray
+   *  packets of the native SIMD width, and each packet is either traced
+   *  using the packet intersector or ray by ray, depending on how
+   *  coherent the rays of that packet are. With the
+   *  RTC_RAY_QUERY_FLAG_BREADTH_FIRST flag, the stream is instead
+   *  traversed breadth first, moving queues of single rays through
+   *  treelets of the BVH. */
+  class RayStream
+  {
+  public:
+
+    /*! rays are sorted in chunks of at most that many rays */
+    static const size_t MAX_SORT_RAYS = 64*1024;
+
+    /*! streams with less rays than this per packet lane are traced ray by ray */
+    static const size_t MIN_RAYS_PER_LANE = 2;
+
+    /*! rays are traversed breadth first in chunks of at most that many rays */
+    static const size_t MAX_QUEUE_RAYS = 1024*1024;
+
+    /*! rays sharing an origin are traced in chunks of at most that many rays */
+    static const size_t MAX_SHARED_ORIGIN_RAYS = 64*1024;
+
+    /*! minimal cosine between the ray directions of a packet and the packet's mean direction to use packet tracing */
+    static constexpr float MIN_PACKET_COHERENCE = 0.9f;
+
+  public:
+
+    /*! intersects a stream of M rays in AOS layout */
+    static void intersect(Scene* scene, RTCRayHit* rayhit, size_t M, size_t byteStride, RayQueryContext* context);
+
+    /*! intersects a stream of N rays in SOA layout */
+    static void intersectN(Scene* scene, RTCRayHitN* rayhit, size_t N, RayQueryContext* context);
+
+    /*! tests a stream of M rays in AOS layout for occlusion */
+    static void occluded(Scene* scene, RTCRay* ray, size_t M, size_t byteStride, RayQueryContext* context);
+
+    /*! tests a stream of N rays in SOA layout for occlusion */
+    static void occludedN(Scene* scene, RTCRayN* ray, size_t N, RayQueryContext* context);
+
+    /*! tests M rays that share the origin of the passed ray for occlusion, the
+     *  directions are stored as 3 floats per ray, tfar is set to -inf for occluded rays */
+    static void occludedSharedOrigin(Scene* scene, const RTCRay& ray, const float* dir, float* tfar, size_t M, RayQueryContext* context);
+  };
+}
@@ -7,6 +7,8 @@
 #include "device.h"
 #include "scene.h"
 #include "context.h"
+#include "raystream.h"
+#include "multihit.h"
 #include "../geometry/filter.h"
 #include "../../include/embree4/rtcore_ray.h"
 
@@ -271,12 +273,38 @@ RTC_NAMESPACE_BEGIN;
     RTC_ENTER_DEVICE(hscene);
     if (quality != RTC_BUILD_QUALITY_LOW &&
         quality != RTC_BUILD_QUALITY_MEDIUM &&
-        quality != RTC_BUILD_QUALITY_HIGH)
+        quality != RTC_BUILD_QUALITY_HIGH &&
+        quality != RTC_BUILD_QUALITY_OPTIMIZED)
       throw std::runtime_error("invalid build quality");
     scene->setBuildQuality(quality);
     RTC_CATCH_END2(scene);
   }
 
+  RTC_API void rtcSetSceneBuildTimeBudget (RTCScene hscene, float milliseconds) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetSceneBuildTimeBudget);
+    RTC_VERIFY_HANDLE(hscene);
+    RTC_ENTER_DEVICE(hscene);
+    if (!(milliseconds >= 0.0f))
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid build time budget");
+    scene->setBuildTimeBudget(milliseconds);
+    RTC_CATCH_END2(scene);
+  }
+
+  RTC_API void rtcEstimateSceneCommit (RTCScene hscene, RTCSceneCommitEstimate* estimate) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcEstimateSceneCommit);
+    RTC_VERIFY_HANDLE(hscene);
+    RTC_VERIFY_HANDLE(estimate);
+    RTC_ENTER_DEVICE(hscene);
+    scene->estimateCommit(estimate->accelBytes,estimate->peakBytes,estimate->buildTime);
+    RTC_CATCH_END2(scene);
+  }
+
   RTC_API void rtcSetSceneFlags (RTCScene hscene, RTCSceneFlags flags) 
   {
     Scene* scene = (Scene*) hscene;
@@ -307,10 +335,39 @@ RTC_NAMESPACE_BEGIN;
     RTC_TRACE(rtcCommitScene);
     RTC_VERIFY_HANDLE(hscene);
     RTC_ENTER_DEVICE(hscene);
+    scene->joinCommitAsync();
     scene->commit(false);
     RTC_CATCH_END2(scene);
   }
 
+  RTC_API void rtcCommitSceneAsync (RTCScene hscene, RTCCommitCompleteFunction complete, void* ptr) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcCommitSceneAsync);
+    RTC_VERIFY_HANDLE(hscene);
+    RTC_ENTER_DEVICE(hscene);
+    scene->commitAsync(complete,ptr);
+    RTC_CATCH_END2(scene);
+  }
+
+  RTC_API void rtcCommitScenes (RTCScene* hscenes, size_t numScenes) 
+  {
+    Scene* scene = (hscenes && numScenes) ? (Scene*) hscenes[0] : nullptr;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcCommitScenes);
+    if (numScenes == 0) return;
+    RTC_VERIFY_HANDLE(hscenes);
+    for (size_t i=0; i<numScenes; i++) {
+      RTC_VERIFY_HANDLE(hscenes[i]);
+      if (((Scene*)hscenes[i])->device != scene->device)
+        throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"scenes belong to different devices");
+    }
+    RTC_ENTER_DEVICE(hscenes[0]);
+    Scene::commitScenes((Scene**)hscenes,numScenes);
+    RTC_CATCH_END2(scene);
+  }
+
   RTC_API void rtcJoinCommitScene (RTCScene hscene) 
   {
     Scene* scene = (Scene*) hscene;
@@ -389,12 +446,16 @@ RTC_NAMESPACE_BEGIN;
     auto nUserPrims1 = scene1->getNumPrimitives (Geometry::MTY_USER_GEOMETRY, false);
     if (scene0->numPrimitives() != nUserPrims0 && scene1->numPrimitives() != nUserPrims1) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scenes must only contain user geometries with a single timestep");
 #endif
+    scene0->buildLazyIfPending();
+    scene1->buildLazyIfPending();
     scene0->intersectors.collide(scene0,scene1,callback,userPtr);
     RTC_CATCH_END(scene0->device);
   }
   
   inline bool pointQuery(Scene* scene, RTCPointQuery* query, RTCPointQueryContext* userContext, RTCPointQueryFunction queryFunc, void* userPtr)
   {
+    scene->buildLazyIfPending();
+
     bool changed = false;
     if (userContext->instStackSize > 0)
     {
@@ -548,6 +609,7 @@ RTC_NAMESPACE_BEGIN;
       rtcInitRayQueryContext(&defaultContext);
       user_context = &defaultContext;
     }
+    scene->buildLazyIfPending();
     RayQueryContext context(scene,user_context,args);
     
     scene->intersectors.intersect(*rayhit,&context);
@@ -578,6 +640,7 @@ RTC_NAMESPACE_BEGIN;
     STAT3(normal.travs,1,1,1);
 
     RTCIntersectArguments* iargs = ((IntersectFunctionNArguments*) args)->args;
+    scene->buildLazyIfPending();
     RayQueryContext context(scene,user_context,iargs);
 
     instance_id_stack::push(user_context, instID);
@@ -617,6 +680,7 @@ RTC_NAMESPACE_BEGIN;
       rtcInitRayQueryContext(&defaultContext);
       user_context = &defaultContext;
     }
+    scene->buildLazyIfPending();
     RayQueryContext context(scene,user_context,args);
 
     if (likely(scene->intersectors.intersector4))
@@ -688,6 +752,7 @@ RTC_NAMESPACE_BEGIN;
     STAT3(normal.travs,cnt,cnt,cnt);
 
     RTCIntersectArguments* iargs = ((IntersectFunctionNArguments*) args)->args;
+    scene->buildLazyIfPending();
     RayQueryContext context(scene,user_context,iargs);
 
     instance_id_stack::push(user_context, instID);
@@ -738,6 +803,7 @@ RTC_NAMESPACE_BEGIN;
       rtcInitRayQueryContext(&defaultContext);
       user_context = &defaultContext;
     }
+    scene->buildLazyIfPending();
     RayQueryContext context(scene,user_context,args);
     
     if (likely(scene->intersectors.intersector8)) 
@@ -793,6 +859,7 @@ RTC_NAMESPACE_BEGIN;
       rtcInitRayQueryContext(&defaultContext);
       user_context = &defaultContext;
     }
+    scene->buildLazyIfPending();
     RayQueryContext context(scene,user_context,args);
 
     if (likely(scene->intersectors.intersector16))
@@ -820,6 +887,197 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(scene);
   }
 
+  RTC_API void rtcIntersectStream (RTCScene hscene, RTCRayHit* rayhit, unsigned int M, size_t byteStride, RTCIntersectArguments* args) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcIntersectStream);
+
+#if defined(DEBUG)
+    RTC_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene not committed");
+    if (((size_t)rayhit) & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "rayhit not aligned to 16 bytes");   
+    if (byteStride & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "byte stride not a multiple of 16 bytes");   
+#endif
+    STAT3(normal.travs,M,M,M);
+
+    RTCIntersectArguments defaultArgs;
+    if (unlikely(args == nullptr)) {
+      rtcInitIntersectArguments(&defaultArgs);
+      args = &defaultArgs;
+    }
+    RTCRayQueryContext* user_context = args->context;
+    
+    RTCRayQueryContext defaultContext;
+    if (unlikely(user_context == nullptr)) {
+      rtcInitRayQueryContext(&defaultContext);
+      user_context = &defaultContext;
+    }
+    scene->buildLazyIfPending();
+    RayQueryContext context(scene,user_context,args);
+
+    RayStream::intersect(scene,rayhit,M,byteStride,&context);
+    RTC_CATCH_END2(scene);
+  }
+
+  RTC_API void rtcIntersectStreamN (RTCScene hscene, RTCRayHitN* rayhit, unsigned int N, RTCIntersectArguments* args) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcIntersectStreamN);
+
+#if defined(DEBUG)
+    RTC_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene not committed");
+    if (((size_t)rayhit) & 0x03) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "rayhit not aligned to 4 bytes");   
+#endif
+    STAT3(normal.travs,N,N,N);
+
+    RTCIntersectArguments defaultArgs;
+    if (unlikely(args == nullptr)) {
+      rtcInitIntersectArguments(&defaultArgs);
+      args = &defaultArgs;
+    }
+    RTCRayQueryContext* user_context = args->context;
+    
+    RTCRayQueryContext defaultContext;
+    if (unlikely(user_context == nullptr)) {
+      rtcInitRayQueryContext(&defaultContext);
+      user_context = &defaultContext;
+    }
+    scene->buildLazyIfPending();
+    RayQueryContext context(scene,user_context,args);
+
+    RayStream::intersectN(scene,rayhit,N,&context);
+    RTC_CATCH_END2(scene);
+  }
+
+  RTC_API void rtcIntersectMultiHit1 (RTCScene hscene, RTCRayHit* rayhit, RTCMultiHit* hits, unsigned int maxHits, RTCIntersectArguments* args) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcIntersectMultiHit1);
+#if defined(DEBUG)
+    RTC_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene not committed");
+    if (((size_t)rayhit) & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "ray not aligned to 16 bytes");   
+    if (((size_t)hits) & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "hits not aligned to 16 bytes");   
+    if (maxHits == 0 || maxHits > RTC_MAX_MULTI_HIT_COUNT) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid number of hits");
+#endif
+    STAT3(normal.travs,1,1,1);
+
+    RTCIntersectArguments defaultArgs;
+    if (unlikely(args == nullptr)) {
+      rtcInitIntersectArguments(&defaultArgs);
+      args = &defaultArgs;
+    }
+    RTCRayQueryContext* user_context = args->context;
+    
+    RTCRayQueryContext defaultContext;
+    if (unlikely(user_context == nullptr)) {
+      rtcInitRayQueryContext(&defaultContext);
+      user_context = &defaultContext;
+    }
+    MultiHitBuffer multiHit(hits,clamp(maxHits,1u,(unsigned int)RTC_MAX_MULTI_HIT_COUNT));
+    scene->buildLazyIfPending();
+    RayQueryContext context(scene,user_context,args);
+    context.multiHit = &multiHit;
+
+    scene->intersectors.intersect(*rayhit,&context);
+    multiHit.finalize(*rayhit);
+#if defined(DEBUG)
+    ((RayHit*)rayhit)->verifyHit();
+#endif
+    RTC_CATCH_END2(scene);
+  }
+
+  template<int K, typename RTCRayHitK>
+  __forceinline void rtcIntersectMultiHitK (const int* valid, Scene* scene, RTCRayHitK* rayhit, RTCMultiHit* hits, unsigned int maxHits, RTCIntersectArguments* args)
+  {
+    STAT(size_t cnt=0; for (size_t i=0; i<K; i++) cnt += ((int*)valid)[i] == -1;);
+    STAT3(normal.travs,cnt,cnt,cnt);
+
+    RTCIntersectArguments defaultArgs;
+    if (unlikely(args == nullptr)) {
+      rtcInitIntersectArguments(&defaultArgs);
+      args = &defaultArgs;
+    }
+    RTCRayQueryContext* user_context = args->context;
+    
+    RTCRayQueryContext defaultContext;
+    if (unlikely(user_context == nullptr)) {
+      rtcInitRayQueryContext(&defaultContext);
+      user_context = &defaultContext;
+    }
+
+    scene->buildLazyIfPending();
+
+    /* the hit buffer is maintained by the single ray kernels, thus trace the rays of the packet one by one */
+    RayHitK<K>* rayK = (RayHitK<K>*) rayhit;
+    for (size_t i=0; i<K; i++)
+    {
+      if (!valid[i]) continue;
+      MultiHitBuffer multiHit(&hits[i],clamp(maxHits,1u,(unsigned int)RTC_MAX_MULTI_HIT_COUNT));
+      RayQueryContext context(scene,user_context,args);
+      context.multiHit = &multiHit;
+      RayHit ray1; rayK->get(i,ray1);
+      scene->intersectors.intersect((RTCRayHit&)ray1,&context);
+      multiHit.finalize((RTCRayHit&)ray1);
+      rayK->set(i,ray1);
+    }
+  }
+
+  RTC_API void rtcIntersectMultiHit4 (const int* valid, RTCScene hscene, RTCRayHit4* rayhit, RTCMultiHit* hits, unsigned int maxHits, RTCIntersectArguments* args) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcIntersectMultiHit4);
+#if defined(DEBUG)
+    RTC_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene not committed");
+    if (((size_t)valid) & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "mask not aligned to 16 bytes");   
+    if (((size_t)rayhit) & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "rayhit not aligned to 16 bytes");   
+    if (((size_t)hits) & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "hits not aligned to 16 bytes");   
+    if (maxHits == 0 || maxHits > RTC_MAX_MULTI_HIT_COUNT) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid number of hits");
+#endif
+    rtcIntersectMultiHitK<4>(valid,scene,rayhit,hits,maxHits,args);
+    RTC_CATCH_END2(scene);
+  }
+
+  RTC_API void rtcIntersectMultiHit8 (const int* valid, RTCScene hscene, RTCRayHit8* rayhit, RTCMultiHit* hits, unsigned int maxHits, RTCIntersectArguments* args) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcIntersectMultiHit8);
+#if defined(DEBUG)
+    RTC_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene not committed");
+    if (((size_t)valid) & 0x1F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "mask not aligned to 32 bytes");   
+    if (((size_t)rayhit) & 0x1F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "rayhit not aligned to 32 bytes");   
+    if (((size_t)hits) & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "hits not aligned to 16 bytes");   
+    if (maxHits == 0 || maxHits > RTC_MAX_MULTI_HIT_COUNT) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid number of hits");
+#endif
+    rtcIntersectMultiHitK<8>(valid,scene,rayhit,hits,maxHits,args);
+    RTC_CATCH_END2(scene);
+  }
+
+  RTC_API void rtcIntersectMultiHit16 (const int* valid, RTCScene hscene, RTCRayHit16* rayhit, RTCMultiHit* hits, unsigned int maxHits, RTCIntersectArguments* args) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcIntersectMultiHit16);
+#if defined(DEBUG)
+    RTC_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene not committed");
+    if (((size_t)valid) & 0x3F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "mask not aligned to 64 bytes");   
+    if (((size_t)rayhit) & 0x3F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "rayhit not aligned to 64 bytes");   
+    if (((size_t)hits) & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "hits not aligned to 16 bytes");   
+    if (maxHits == 0 || maxHits > RTC_MAX_MULTI_HIT_COUNT) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid number of hits");
+#endif
+    rtcIntersectMultiHitK<16>(valid,scene,rayhit,hits,maxHits,args);
+    RTC_CATCH_END2(scene);
+  }
+
   RTC_API void rtcOccluded1 (RTCScene hscene, RTCRay* ray, RTCOccludedArguments* args) 
   {
     Scene* scene = (Scene*) hscene;
@@ -844,6 +1102,7 @@ RTC_NAMESPACE_BEGIN;
       rtcInitRayQueryContext(&defaultContext);
       user_context = &defaultContext;
     }
+    scene->buildLazyIfPending();
     RayQueryContext context(scene,user_context,args);
     
     scene->intersectors.occluded(*ray,&context);
@@ -871,6 +1130,7 @@ RTC_NAMESPACE_BEGIN;
     oray->dir = iray->dir;
 
     RTCIntersectArguments* iargs = ((OccludedFunctionNArguments*) args)->args;
+    scene->buildLazyIfPending();
     RayQueryContext context(scene,user_context,iargs);
 
     instance_id_stack::push(user_context, instID);
@@ -910,6 +1170,7 @@ RTC_NAMESPACE_BEGIN;
       rtcInitRayQueryContext(&defaultContext);
       user_context = &defaultContext;
     }
+    scene->buildLazyIfPending();
     RayQueryContext context(scene,user_context,args);
 
     if (likely(scene->intersectors.intersector4))
@@ -960,6 +1221,7 @@ RTC_NAMESPACE_BEGIN;
     STAT3(normal.travs,cnt,cnt,cnt);
 
     RTCIntersectArguments* iargs = ((IntersectFunctionNArguments*) args)->args;
+    scene->buildLazyIfPending();
     RayQueryContext context(scene,user_context,iargs);
 
     instance_id_stack::push(user_context, instID);
@@ -1010,6 +1272,7 @@ RTC_NAMESPACE_BEGIN;
       rtcInitRayQueryContext(&defaultContext);
       user_context = &defaultContext;
     }
+    scene->buildLazyIfPending();
     RayQueryContext context(scene,user_context,args);
 
     if (likely(scene->intersectors.intersector8))
@@ -1064,6 +1327,7 @@ RTC_NAMESPACE_BEGIN;
       rtcInitRayQueryContext(&defaultContext);
       user_context = &defaultContext;
     }
+    scene->buildLazyIfPending();
     RayQueryContext context(scene,user_context,args);
 
     if (likely(scene->intersectors.intersector16))
@@ -1091,6 +1355,105 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(scene);
   }
   
+  RTC_API void rtcOccludedStream (RTCScene hscene, RTCRay* ray, unsigned int M, size_t byteStride, RTCOccludedArguments* args) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcOccludedStream);
+
+#if defined(DEBUG)
+    RTC_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene not committed");
+    if (((size_t)ray) & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "ray not aligned to 16 bytes");   
+    if (byteStride & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "byte stride not a multiple of 16 bytes");   
+#endif
+    STAT3(shadow.travs,M,M,M);
+
+    RTCOccludedArguments defaultArgs;
+    if (unlikely(args == nullptr)) {
+      rtcInitOccludedArguments(&defaultArgs);
+      args = &defaultArgs;
+    }
+    RTCRayQueryContext* user_context = args->context;
+    
+    RTCRayQueryContext defaultContext;
+    if (unlikely(user_context == nullptr)) {
+      rtcInitRayQueryContext(&defaultContext);
+      user_context = &defaultContext;
+    }
+    scene->buildLazyIfPending();
+    RayQueryContext context(scene,user_context,args);
+
+    RayStream::occluded(scene,ray,M,byteStride,&context);
+    RTC_CATCH_END2(scene);
+  }
+
+  RTC_API void rtcOccludedStreamN (RTCScene hscene, RTCRayN* ray, unsigned int N, RTCOccludedArguments* args) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcOccludedStreamN);
+
+#if defined(DEBUG)
+    RTC_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene not committed");
+    if (((size_t)ray) & 0x03) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "ray not aligned to 4 bytes");   
+#endif
+    STAT3(shadow.travs,N,N,N);
+
+    RTCOccludedArguments defaultArgs;
+    if (unlikely(args == nullptr)) {
+      rtcInitOccludedArguments(&defaultArgs);
+      args = &defaultArgs;
+    }
+    RTCRayQueryContext* user_context = args->context;
+    
+    RTCRayQueryContext defaultContext;
+    if (unlikely(user_context == nullptr)) {
+      rtcInitRayQueryContext(&defaultContext);
+      user_context = &defaultContext;
+    }
+    scene->buildLazyIfPending();
+    RayQueryContext context(scene,user_context,args);
+
+    RayStream::occludedN(scene,ray,N,&context);
+    RTC_CATCH_END2(scene);
+  }
+
+  RTC_API void rtcOccludedSharedOrigin (RTCScene hscene, const RTCRay* ray, const float* dir, float* tfar, unsigned int M, RTCOccludedArguments* args)
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcOccludedSharedOrigin);
+
+#if defined(DEBUG)
+    RTC_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene not committed");
+    if (((size_t)ray) & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "ray not aligned to 16 bytes");
+    if (((size_t)dir) & 0x03) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "directions not aligned to 4 bytes");
+    if (((size_t)tfar) & 0x03) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "tfar values not aligned to 4 bytes");
+#endif
+    STAT3(shadow.travs,M,M,M);
+
+    RTCOccludedArguments defaultArgs;
+    if (unlikely(args == nullptr)) {
+      rtcInitOccludedArguments(&defaultArgs);
+      args = &defaultArgs;
+    }
+    RTCRayQueryContext* user_context = args->context;
+    
+    RTCRayQueryContext defaultContext;
+    if (unlikely(user_context == nullptr)) {
+      rtcInitRayQueryContext(&defaultContext);
+      user_context = &defaultContext;
+    }
+    scene->buildLazyIfPending();
+    RayQueryContext context(scene,user_context,args);
+
+    RayStream::occludedSharedOrigin(scene,*ray,dir,tfar,M,&context);
+    RTC_CATCH_END2(scene);
+  }
+
   RTC_API void rtcRetainScene (RTCScene hscene) 
   {
     Scene* scene = (Scene*) hscene;
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "scene.h"
+#include "accelinstance.h"
 
 #include "../../common/tasking/taskscheduler.h"
 
@@ -45,9 +46,15 @@ namespace embree
       flags_modified(true), enabled_geometry_types(0),
       scene_flags(RTC_SCENE_FLAG_NONE),
       quality_flags(RTC_BUILD_QUALITY_MEDIUM),
+      requested_quality_flags(RTC_BUILD_QUALITY_MEDIUM),
+      max_geometry_quality(RTC_BUILD_QUALITY_HIGH),
       modified(true),
       taskGroup(new TaskGroup()),
-      progressInterface(this), progress_monitor_function(nullptr), progress_monitor_ptr(nullptr), progress_monitor_counter(0)
+      progressInterface(this), progress_monitor_function(nullptr), progress_monitor_ptr(nullptr), progress_monitor_counter(0),
+      async_commit_thread(nullptr), async_commit_function(nullptr), async_commit_ptr(nullptr),
+      build_time_budget(0.0f), build_deadline(0.0), build_strategy(BuildTimeModel::SAH), build_primitives(0),
+      memory_layout(AccelMemoryModel::DEFAULT), accel_bytes(0),
+      lazy_pending(false), lazy_triggered(false)
   {
     device->refInc();
 
@@ -61,13 +68,15 @@ namespace embree
        
     /* one can overwrite flags through device for debugging */
     if (device->quality_flags != -1)
-      quality_flags = (RTCBuildQuality) device->quality_flags;
+      quality_flags = requested_quality_flags = (RTCBuildQuality) device->quality_flags;
     if (device->scene_flags != -1)
       scene_flags = (RTCSceneFlags) device->scene_flags;
   }
 
   Scene::~Scene() noexcept
   {
+    /* a pending asynchronous commit still accesses the scene */
+    joinCommitAsync();
     device->refDec();
   }
   
@@ -131,7 +140,7 @@ namespace embree
 #if defined (EMBREE_TARGET_SIMD8)
           if (device->canUseAVX())
 	  {
-            if (quality_flags == RTC_BUILD_QUALITY_HIGH) 
+            if (isHighQualityAccel()) 
               accels_add(device->bvh8_factory->BVH8Triangle4(this,BVHFactory::BuildVariant::HIGH_QUALITY,BVHFactory::IntersectVariant::FAST));
             else
               accels_add(device->bvh8_factory->BVH8Triangle4(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST));
@@ -139,7 +148,7 @@ namespace embree
           else 
 #endif
           { 
-            if (quality_flags == RTC_BUILD_QUALITY_HIGH) 
+            if (isHighQualityAccel()) 
               accels_add(device->bvh4_factory->BVH4Triangle4(this,BVHFactory::BuildVariant::HIGH_QUALITY,BVHFactory::IntersectVariant::FAST));
             else 
               accels_add(device->bvh4_factory->BVH4Triangle4(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST));
@@ -196,6 +205,7 @@ namespace embree
     else if (device->tri_accel == "bvh8.triangle4i")      accels_add(device->bvh8_factory->BVH8Triangle4i(this));
     else if (device->tri_accel == "qbvh8.triangle4i")     accels_add(device->bvh8_factory->BVH8QuantizedTriangle4i(this));
     else if (device->tri_accel == "qbvh8.triangle4")      accels_add(device->bvh8_factory->BVH8QuantizedTriangle4(this));
+    else if (device->tri_accel == "bvh8obb.triangle4v")   accels_add(device->bvh8_factory->BVH8OBBTriangle4v(this,BVHFactory::IntersectVariant::ROBUST));
 #endif
     else throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"unknown triangle acceleration structure "+device->tri_accel);
 #endif
@@ -256,7 +266,7 @@ namespace embree
 #if defined (EMBREE_TARGET_SIMD8)
           if (device->canUseAVX())
           {
-            if (quality_flags == RTC_BUILD_QUALITY_HIGH) 
+            if (isHighQualityAccel()) 
               accels_add(device->bvh8_factory->BVH8Quad4v(this,BVHFactory::BuildVariant::HIGH_QUALITY,BVHFactory::IntersectVariant::FAST));
             else
               accels_add(device->bvh8_factory->BVH8Quad4v(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST));
@@ -264,7 +274,7 @@ namespace embree
           else
 #endif
           {
-            if (quality_flags == RTC_BUILD_QUALITY_HIGH) 
+            if (isHighQualityAccel()) 
               accels_add(device->bvh4_factory->BVH4Quad4v(this,BVHFactory::BuildVariant::HIGH_QUALITY,BVHFactory::IntersectVariant::FAST));
             else
               accels_add(device->bvh4_factory->BVH4Quad4v(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST));
@@ -318,6 +328,7 @@ namespace embree
     else if (device->quad_accel == "bvh8.quad4v")       accels_add(device->bvh8_factory->BVH8Quad4v(this));
     else if (device->quad_accel == "bvh8.quad4i")       accels_add(device->bvh8_factory->BVH8Quad4i(this));
     else if (device->quad_accel == "qbvh8.quad4i")      accels_add(device->bvh8_factory->BVH8QuantizedQuad4i(this));
+    else if (device->quad_accel == "bvh8obb.quad4v")    accels_add(device->bvh8_factory->BVH8OBBQuad4v(this,BVHFactory::IntersectVariant::ROBUST));
 #endif
     else throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"unknown quad acceleration structure "+device->quad_accel);
 #endif
@@ -723,6 +734,14 @@ namespace embree
     /* build all hierarchies of this scene */
     accels_build();
 
+    /* restructure the treelets of the built hierarchies */
+    if (quality_flags == RTC_BUILD_QUALITY_OPTIMIZED)
+      optimize_cpu_accels();
+
+    /* make the memory layout independent of the number of threads, or repack static BVHs for better cache locality */
+    if (isDeterministicAccel() || (device->bvh_layout == "hot_first" && !isDynamicAccel()))
+      relayout_cpu_accels();
+
     /* make static geometry immutable */
     if (!isDynamicAccel()) {
       accels_immutable();
@@ -737,6 +756,220 @@ namespace embree
     }
   }
 
+  void Scene::optimize_cpu_accels()
+  {
+    /* a budget of zero gives the optimization pass unlimited time, deterministic builds ignore the budget */
+    double deadline = device->treelet_optimization_budget > 0.0f && !isDeterministicAccel() ? getSeconds() + 0.001*device->treelet_optimization_budget : 0.0;
+
+    /* the pass also ends with the build time budget of the scene */
+    if (build_deadline > 0.0 && !isDeterministicAccel() && (deadline == 0.0 || build_deadline < deadline))
+      deadline = build_deadline;
+
+    for (size_t i=0; i<accels.size(); i++)
+    {
+      if (accels[i]->type != AccelData::TY_ACCEL_INSTANCE) continue;
+      AccelData* accel = ((AccelInstance*)accels[i])->getAccel();
+      if (accel->type == AccelData::TY_BVH4)
+        device->bvh4_factory->BVH4TreeletOptimize(accel,deadline);
+#if defined(EMBREE_TARGET_SIMD8)
+      else if (accel->type == AccelData::TY_BVH8)
+        device->bvh8_factory->BVH8TreeletOptimize(accel,deadline);
+#endif
+    }
+  }
+
+  void Scene::relayout_cpu_accels()
+  {
+    for (size_t i=0; i<accels.size(); i++)
+    {
+      if (accels[i]->type != AccelData::TY_ACCEL_INSTANCE) continue;
+      AccelData* accel = ((AccelInstance*)accels[i])->getAccel();
+      if (accel->type == AccelData::TY_BVH4)
+        device->bvh4_factory->BVH4Relayout(accel);
+#if defined(EMBREE_TARGET_SIMD8)
+      else if (accel->type == AccelData::TY_BVH8)
+        device->bvh8_factory->BVH8Relayout(accel);
+#endif
+    }
+  }
+
+  bool Scene::defer_cpu_accels()
+  {
+    if (!isLazyAccel())
+      return false;
+
+    /* motion blur, subdivision, and grid geometries always get built right away */
+    const size_t numLazyPrimitives = getNumPrimitives(Geometry::GTypeMask(Geometry::MTY_ALL & ~(Geometry::MTY_SUBDIV_MESH | Geometry::MTY_GRID_MESH)),false);
+    if (numLazyPrimitives == 0 || numLazyPrimitives != numPrimitives())
+      return false;
+
+    /* the bounds over all primitives are the bounds the build computes, thus instances of the scene can get built already */
+    static const size_t BLOCK_SIZE = 256;
+    const BBox3fa sceneBounds = parallel_reduce(size_t(0), geometries.size(), BBox3fa(empty), [&] (const range<size_t>& r) -> BBox3fa
+    {
+      BBox3fa b = empty;
+      for (size_t i=r.begin(); i<r.end(); i++)
+      {
+        const Geometry* geom = geometries[i].ptr;
+        if (geom == nullptr || !geom->isEnabled()) continue;
+
+        b.extend(parallel_reduce(size_t(0), geom->size(), BLOCK_SIZE, BBox3fa(empty), [&] (const range<size_t>& r) -> BBox3fa
+        {
+          PrimRef prims[BLOCK_SIZE];
+          BBox3fa gb = empty;
+          for (size_t j=r.begin(); j<r.end(); j+=BLOCK_SIZE)
+            gb.extend(geom->createPrimRefArray(prims,range<size_t>(j,min(j+BLOCK_SIZE,r.end())),0,unsigned(i)).geomBounds);
+          return gb;
+        }, [] (const BBox3fa& a, const BBox3fa& b) { return merge(a,b); }));
+      }
+      return b;
+    }, [] (const BBox3fa& a, const BBox3fa& b) { return merge(a,b); });
+
+    bounds = LBBox3fa(sceneBounds);
+    lazy_triggered = false;
+    lazy_pending = true;
+    return true;
+  }
+
+  void Scene::buildLazy()
+  {
+    /* the first thread builds the scene using the thread pool, threads reaching the scene meanwhile wait for the build */
+    Lock<MutexSys> lock(lazyMutex);
+    if (!lazy_pending) return;
+    lazy_triggered = true;
+    commit(false);
+  }
+
+  Scene::BuildPlan Scene::plan_build(const GeometryCounts& counts) const
+  {
+    BuildPlan plan;
+    plan.quality = requested_quality_flags;
+    plan.geometry_quality = RTC_BUILD_QUALITY_HIGH;
+    plan.strategy = BuildTimeModel::strategy(plan.quality);
+
+    /* the two-level builder only rebuilds modified geometries as long as the accels stay the same */
+    size_t numTwoLevel = counts.size();
+    if (quality_flags == RTC_BUILD_QUALITY_LOW && !flags_modified)
+    {
+      numTwoLevel = 0;
+      for (size_t i=0; i<geometries.size(); i++)
+        if (geometries[i] && geometries[i]->isEnabled() && isGeometryModified(i))
+          numTwoLevel += geometries[i]->size();
+    }
+    plan.numPrimitives = plan.strategy == BuildTimeModel::TWO_LEVEL_SAH ? numTwoLevel : counts.size();
+
+    if (build_time_budget > 0.0f)
+    {
+      const double budget = 0.001*double(build_time_budget);
+      const size_t numThreads = TaskScheduler::threadCount();
+
+      /* strategies from the highest to the lowest quality */
+      struct Candidate
+      {
+        RTCBuildQuality quality;
+        RTCBuildQuality geometry_quality;
+        BuildTimeModel::Strategy strategy;
+        size_t numPrimitives;
+      };
+      const Candidate candidates[] = {
+        { RTC_BUILD_QUALITY_OPTIMIZED, RTC_BUILD_QUALITY_HIGH, BuildTimeModel::OPTIMIZED       , counts.size() },
+        { RTC_BUILD_QUALITY_HIGH     , RTC_BUILD_QUALITY_HIGH, BuildTimeModel::SPATIAL_SAH     , counts.size() },
+        { RTC_BUILD_QUALITY_MEDIUM   , RTC_BUILD_QUALITY_HIGH, BuildTimeModel::SAH             , counts.size() },
+        { RTC_BUILD_QUALITY_LOW      , RTC_BUILD_QUALITY_HIGH, BuildTimeModel::TWO_LEVEL_SAH   , numTwoLevel   },
+        { RTC_BUILD_QUALITY_LOW      , RTC_BUILD_QUALITY_LOW , BuildTimeModel::TWO_LEVEL_MORTON, numTwoLevel   }
+      };
+      const size_t numCandidates = sizeof(candidates)/sizeof(Candidate);
+
+      size_t c = 0;
+      switch (requested_quality_flags) {
+      case RTC_BUILD_QUALITY_OPTIMIZED: c = 0; break;
+      case RTC_BUILD_QUALITY_HIGH     : c = 1; break;
+      case RTC_BUILD_QUALITY_MEDIUM   : c = 2; break;
+      default                         : c = 3; break;
+      }
+
+      /* take the highest quality that fits into the budget, Morton builds of all geometries are the fallback */
+      while (c+1 < numCandidates && build_time_model.estimate(candidates[c].strategy,candidates[c].numPrimitives,numThreads) > budget)
+        c++;
+
+      plan.quality = candidates[c].quality;
+      plan.geometry_quality = candidates[c].geometry_quality;
+      plan.strategy = candidates[c].strategy;
+      plan.numPrimitives = candidates[c].numPrimitives;
+    }
+
+    /* switch to compact acceleration structures without spatial splits when the default ones exceed the memory budget */
+    plan.layout = (scene_flags & RTC_SCENE_FLAG_COMPACT) ? AccelMemoryModel::COMPACT : AccelMemoryModel::DEFAULT;
+    plan.splitFactor = plan.strategy == BuildTimeModel::SPATIAL_SAH || plan.strategy == BuildTimeModel::OPTIMIZED ? device->max_spatial_split_replications : 1.0f;
+    plan.accelBytes = AccelMemoryModel::estimate(counts,plan.layout,plan.splitFactor);
+    if (device->memory_budget > 0 && plan.layout == AccelMemoryModel::DEFAULT)
+    {
+      /* the budget covers all memory of the device, the build replaces the acceleration structures of the last commit */
+      const size_t used = device->getMemoryUsed();
+      const size_t other = used - min(used,accel_bytes);
+      if (other+plan.accelBytes > device->memory_budget)
+      {
+        plan.layout = AccelMemoryModel::COMPACT;
+        plan.splitFactor = 1.0f;
+        plan.accelBytes = AccelMemoryModel::estimate(counts,plan.layout,plan.splitFactor);
+        if (plan.quality == RTC_BUILD_QUALITY_HIGH || plan.quality == RTC_BUILD_QUALITY_OPTIMIZED) {
+          plan.quality = RTC_BUILD_QUALITY_MEDIUM;
+          plan.strategy = BuildTimeModel::SAH;
+        }
+      }
+    }
+    return plan;
+  }
+
+  void Scene::select_build_quality()
+  {
+    const BuildPlan plan = plan_build(world);
+    build_deadline = build_time_budget > 0.0f ? getSeconds() + 0.001*double(build_time_budget) : 0.0;
+    build_strategy = plan.strategy;
+    build_primitives = plan.numPrimitives;
+    accel_bytes = plan.accelBytes;
+
+    if (device->verbosity(2))
+    {
+      if (build_time_budget > 0.0f)
+        std::cout << "build time budget of " << build_time_budget << " ms selects " << plan.quality << " build quality" << std::endl;
+      if (device->memory_budget > 0)
+        std::cout << "memory budget of " << 1E-6*double(device->memory_budget) << " MB selects " << (plan.layout == AccelMemoryModel::COMPACT ? "compact" : "default") << " acceleration structures of " << 1E-6*double(plan.accelBytes) << " MB" << std::endl;
+    }
+
+    if (plan.layout != memory_layout) {
+      memory_layout = plan.layout;
+      flags_modified = true;
+    }
+
+    if (plan.quality != quality_flags) {
+      quality_flags = plan.quality;
+      flags_modified = true;
+    }
+    max_geometry_quality = plan.geometry_quality;
+  }
+
+  void Scene::estimateCommit(size_t& accelBytes, size_t& peakBytes, double& seconds) const
+  {
+    /* the same counts and selection a commit would use, without calling the preCommit function of the geometries */
+    const GeometryCounts counts = parallel_reduce (size_t(0), geometries.size(), GeometryCounts (),
+      [this](const range<size_t>& r)->GeometryCounts
+      {
+        GeometryCounts c;
+        for (auto i=r.begin(); i<r.end(); ++i)
+          if (geometries[i] && geometries[i]->isEnabled())
+            geometries[i]->addElementsToCount (c);
+        return c;
+      },
+      std::plus<GeometryCounts>()
+    );
+
+    const BuildPlan plan = plan_build(counts);
+    accelBytes = plan.accelBytes;
+    peakBytes = plan.accelBytes + AccelMemoryModel::estimateBuild(counts,plan.strategy,plan.splitFactor);
+    seconds = build_time_model.estimate(plan.strategy,plan.numPrimitives,TaskScheduler::threadCount());
+  }
+
   void Scene::build_gpu_accels()
   {
 #if defined(EMBREE_SYCL_SUPPORT)
@@ -749,7 +982,10 @@ namespace embree
   void Scene::commit_task ()
   {
     checkIfModifiedAndSet();
-    if (!isModified()) return;
+
+    /* a traversal reached the scene whose build the last commit deferred */
+    const bool lazy_build = lazy_pending && lazy_triggered;
+    if (!isModified() && !lazy_build) return;
     
     /* print scene statistics */
     if (device->verbosity(2))
@@ -782,7 +1018,19 @@ namespace embree
       build_gpu_accels();
     else
 #endif
+    {
+      /* lazy scenes only get their bounds computed, the first traversal builds them */
+      if (!lazy_build && defer_cpu_accels()) {
+        setModified(false);
+        return;
+      }
+
+      /* select the build quality that fits into the build time and memory budgets */
+      select_build_quality();
+      const double t0 = getSeconds();
       build_cpu_accels();
+      build_time_model.update(build_strategy,build_primitives,TaskScheduler::threadCount(),getSeconds()-t0);
+    }
 
     /* call postCommit function of each geometry */
     parallel_for(geometries.size(), [&] ( const size_t i ) {
@@ -794,10 +1042,12 @@ namespace embree
       });
 
     setModified(false);
+    lazy_pending = false;
   }
 
   void Scene::setBuildQuality(RTCBuildQuality quality_flags_i)
   {
+    requested_quality_flags = quality_flags_i;
     if (quality_flags == quality_flags_i) return;
     quality_flags = quality_flags_i;
     flags_modified = true;
@@ -817,7 +1067,82 @@ namespace embree
   RTCSceneFlags Scene::getSceneFlags() const {
     return scene_flags;
   }
+
+  void Scene::setBuildTimeBudget(float milliseconds) {
+    build_time_budget = milliseconds;
+  }
                    
+  std::vector<std::vector<Scene*>> Scene::commitWaves(Scene** scenes_in, size_t numScenes)
+  {
+    /* remove duplicates, sorting also establishes a global locking order */
+    std::vector<Scene*> scenes(scenes_in,scenes_in+numScenes);
+    std::sort(scenes.begin(),scenes.end());
+    scenes.erase(std::unique(scenes.begin(),scenes.end()),scenes.end());
+
+    std::map<Scene*,size_t> index;
+    for (size_t i=0; i<scenes.size(); i++) {
+      scenes[i]->joinCommitAsync();
+      index[scenes[i]] = i;
+    }
+
+    /* instances need the bounds of their committed child scene, thus a scene
+       instanced by another scene of the set gets built in an earlier wave */
+    std::vector<std::vector<size_t>> children(scenes.size());
+    std::vector<size_t> numPrims(scenes.size(),0);
+    for (size_t i=0; i<scenes.size(); i++)
+    {
+      for (const Ref<Geometry>& geom : scenes[i]->geometries)
+      {
+        if (!geom) continue;
+        numPrims[i] += geom->size();
+        if (!(geom->getTypeMask() & Geometry::MTY_INSTANCE)) continue;
+        auto child = index.find((Scene*) ((Instance*) geom.ptr)->object);
+        if (child != index.end()) children[i].push_back(child->second);
+      }
+    }
+
+    std::vector<size_t> level(scenes.size(),0);
+    for (size_t iter=0; iter<scenes.size(); iter++)
+    {
+      bool changed = false;
+      for (size_t i=0; i<scenes.size(); i++) {
+        for (size_t c : children[i]) {
+          if (level[i] > level[c]) continue;
+          level[i] = level[c]+1;
+          changed = true;
+        }
+      }
+      if (!changed) break;
+    }
+
+    std::vector<std::vector<Scene*>> waves;
+    std::vector<size_t> order(scenes.size());
+    for (size_t i=0; i<scenes.size(); i++) order[i] = i;
+
+    /* start large builds first to balance the waves */
+    std::sort(order.begin(),order.end(),[&] (size_t a, size_t b) { return numPrims[a] > numPrims[b]; });
+    for (size_t i : order) {
+      if (level[i] >= waves.size()) waves.resize(level[i]+1);
+      waves[level[i]].push_back(scenes[i]);
+    }
+    return waves;
+  }
+
+  void Scene::commitScenesFailed(const std::vector<std::vector<Scene*>>& waves)
+  {
+    for (const auto& wave : waves)
+      for (Scene* scene : wave)
+        if (scene->isModified()) scene->accels_clear();
+  }
+
+  static void commitWavesTask(const std::vector<std::vector<Scene*>>& waves)
+  {
+    /* small scenes of a wave execute their inner parallel loops within a
+       single task, large scenes spread them over the available threads */
+    for (const auto& wave : waves)
+      parallel_for(wave.size(), [&] ( const size_t i ) { wave[i]->commit_task(); });
+  }
+
 #if defined(TASKING_INTERNAL)
 
   void Scene::commit (bool join) 
@@ -858,6 +1183,60 @@ namespace embree
     }
   }
 
+  void Scene::commitScenes (Scene** scenes, size_t numScenes)
+  {
+    std::vector<std::vector<Scene*>> waves = commitWaves(scenes,numScenes);
+
+    /* all scenes share a single task scheduler, thus joining any of them joins the entire build */
+    Ref<TaskScheduler> scheduler = new TaskScheduler;
+    std::vector<Scene*> locked;
+
+    auto resetSchedulers = [&] () {
+      for (Scene* scene : locked) {
+        Lock<MutexSys> lock(scene->taskGroup->schedulerMutex);
+        scene->taskGroup->scheduler = nullptr;
+      }
+    };
+    auto unlockScenes = [&] () {
+      for (Scene* scene : locked)
+        scene->buildMutex.unlock();
+    };
+
+    for (const auto& wave : waves)
+    {
+      for (Scene* scene : wave)
+      {
+        bool busy = false;
+        {
+          Lock<MutexSys> lock(scene->taskGroup->schedulerMutex);
+          busy = scene->taskGroup->scheduler != null;
+          if (!busy) {
+            scene->buildMutex.lock();
+            scene->taskGroup->scheduler = scheduler;
+            locked.push_back(scene);
+          }
+        }
+        if (busy) {
+          resetSchedulers();
+          unlockScenes();
+          throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene is already being committed");
+        }
+      }
+    }
+
+    try {
+      TaskScheduler::TaskGroupContext context;
+      scheduler->spawn_root([&]() { commitWavesTask(waves); resetSchedulers(); }, &context, 1, true);
+    }
+    catch (...) {
+      commitScenesFailed(waves);
+      resetSchedulers();
+      unlockScenes();
+      throw;
+    }
+    unlockScenes();
+  }
+
 #endif
 
 #if defined(TASKING_TBB)
@@ -922,6 +1301,61 @@ namespace embree
       throw;
     }
   }
+  void Scene::commitScenes (Scene** scenes, size_t numScenes)
+  {
+    std::vector<std::vector<Scene*>> waves = commitWaves(scenes,numScenes);
+    if (waves.empty()) return;
+    Device* device = waves[0][0]->device;
+
+    /* obtain build locks of all scenes */
+    std::vector<Scene*> locked;
+    auto unlockScenes = [&] () {
+      for (Scene* scene : locked)
+        scene->buildMutex.unlock();
+    };
+    
+    for (const auto& wave : waves)
+    {
+      for (Scene* scene : wave)
+      {
+        if (!scene->buildMutex.try_lock()) {
+          unlockScenes();
+          throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene is already being committed");
+        }
+        locked.push_back(scene);
+      }
+    }
+
+    /* for best performance set FTZ and DAZ flags in the MXCSR control and status register */
+    const unsigned int mxcsr = _mm_getcsr();
+    _mm_setcsr(mxcsr | /* FTZ */ (1<<15) | /* DAZ */ (1<<6));
+
+    try {
+#if TBB_INTERFACE_VERSION_MAJOR < 8    
+      tbb::task_group_context ctx( tbb::task_group_context::isolated, tbb::task_group_context::default_traits);
+#else
+      tbb::task_group_context ctx( tbb::task_group_context::isolated, tbb::task_group_context::default_traits | tbb::task_group_context::fp_settings );
+#endif
+      device->execute(false, [&]()
+      {
+        tbb::parallel_for (size_t(0), size_t(1), size_t(1), [&] (size_t) { commitWavesTask(waves); }, ctx);
+      });
+
+      /* reset MXCSR register again */
+      _mm_setcsr(mxcsr);
+    }
+    catch (...)
+    {
+      /* reset MXCSR register again */
+      _mm_setcsr(mxcsr);
+
+      commitScenesFailed(waves);
+      unlockScenes();
+      throw;
+    }
+    unlockScenes();
+  }
+
 #endif
 
 #if defined(TASKING_PPL)
@@ -964,8 +1398,92 @@ namespace embree
       throw;
     }
   }
+  void Scene::commitScenes (Scene** scenes, size_t numScenes)
+  {
+    std::vector<std::vector<Scene*>> waves = commitWaves(scenes,numScenes);
+
+    /* obtain build locks of all scenes in address order */
+    std::vector<Scene*> locked;
+    for (const auto& wave : waves)
+      for (Scene* scene : wave)
+        locked.push_back(scene);
+    std::sort(locked.begin(),locked.end());
+    for (Scene* scene : locked)
+      scene->buildMutex.lock();
+
+    /* for best performance set FTZ and DAZ flags in the MXCSR control and status register */
+    const unsigned int mxcsr = _mm_getcsr();
+    _mm_setcsr(mxcsr | /* FTZ */ (1<<15) | /* DAZ */ (1<<6));
+
+    try {
+      concurrency::parallel_for(size_t(0), size_t(1), size_t(1), [&](size_t) { commitWavesTask(waves); });
+
+      /* reset MXCSR register again */
+      _mm_setcsr(mxcsr);
+    }
+    catch (...)
+    {
+      /* reset MXCSR register again */
+      _mm_setcsr(mxcsr);
+
+      commitScenesFailed(waves);
+      for (Scene* scene : locked) scene->buildMutex.unlock();
+      throw;
+    }
+    for (Scene* scene : locked) scene->buildMutex.unlock();
+  }
+
 #endif
 
+  void Scene::asyncCommitThreadFunc(void* ptr)
+  {
+    Scene* scene = (Scene*) ptr;
+    DeviceEnterLeave enterleave((RTCScene)scene);
+
+    RTCError error = RTC_ERROR_NONE;
+    try {
+      scene->commit(false);
+    }
+    catch (std::bad_alloc&) {
+      error = RTC_ERROR_OUT_OF_MEMORY;
+      Device::process_error(scene->device,error,"out of memory");
+    }
+    catch (rtcore_error& e) {
+      error = e.error;
+      Device::process_error(scene->device,error,e.what());
+    }
+    catch (std::exception& e) {
+      error = RTC_ERROR_UNKNOWN;
+      Device::process_error(scene->device,error,e.what());
+    }
+    catch (...) {
+      error = RTC_ERROR_UNKNOWN;
+      Device::process_error(scene->device,error,"unknown exception caught");
+    }
+
+    if (scene->async_commit_function)
+      scene->async_commit_function(scene->async_commit_ptr,(RTCScene)scene,error);
+  }
+
+  void Scene::commitAsync (RTCCommitCompleteFunction func, void* ptr)
+  {
+    /* only one asynchronous commit can be pending per scene */
+    joinCommitAsync();
+
+    Lock<MutexSys> lock(asyncCommitMutex);
+    async_commit_function = func;
+    async_commit_ptr      = ptr;
+    async_commit_thread   = createThread(asyncCommitThreadFunc,this);
+  }
+
+  void Scene::joinCommitAsync ()
+  {
+    Lock<MutexSys> lock(asyncCommitMutex);
+    if (async_commit_thread == nullptr) return;
+    join(async_commit_thread);
+    async_commit_thread = nullptr;
+  }
+
   void Scene::setProgressMonitorFunction(RTCProgressMonitorFunction func, void* ptr) 
   {
     progress_monitor_function = func;
@@ -19,6 +19,7 @@
 
 #include "acceln.h"
 #include "geometry.h"
+#include "build_budget.h"
 
 #if defined(EMBREE_SYCL_SUPPORT)
 #include "../rthwif/rthwif_embree_builder.h"
@@ -183,10 +184,52 @@ namespace embree
     void setSceneFlags(RTCSceneFlags scene_flags);
     RTCSceneFlags getSceneFlags() const;
 
+    /* sets the time in milliseconds a commit should take, zero disables the budget */
+    void setBuildTimeBudget(float milliseconds);
+
+    /* returns the quality geometries of two-level BVHs get built with */
+    __forceinline RTCBuildQuality getGeometryBuildQuality(RTCBuildQuality quality) const {
+      if (quality == RTC_BUILD_QUALITY_REFIT) return quality;
+      return (RTCBuildQuality) min((int)quality,(int)max_geometry_quality);
+    }
+
     void build_cpu_accels();
+    void optimize_cpu_accels();
+    void relayout_cpu_accels();
+
+    /* build settings a commit selects from the primitive counts and the time and memory budgets */
+    struct BuildPlan
+    {
+      RTCBuildQuality quality;           //!< build quality of the scene
+      RTCBuildQuality geometry_quality;  //!< maximal build quality of geometries of two-level BVHs
+      BuildTimeModel::Strategy strategy; //!< build strategy the time model predicts
+      size_t numPrimitives;              //!< number of primitives that get built
+      AccelMemoryModel::Layout layout;   //!< layout of the acceleration structures
+      float splitFactor;                 //!< growth of the primitive references through spatial splits
+      size_t accelBytes;                 //!< estimated bytes of the acceleration structures
+    };
+    BuildPlan plan_build(const GeometryCounts& counts) const;
+    void select_build_quality();
     void build_gpu_accels();
     void commit (bool join);
     void commit_task ();
+
+    /* estimates the acceleration structure bytes, peak build bytes and build time of the next commit without building */
+    void estimateCommit(size_t& accelBytes, size_t& peakBytes, double& seconds) const;
+
+    /* builds the scene if its build got deferred by RTC_SCENE_FLAG_LAZY, has to get called before each traversal */
+    __forceinline void buildLazyIfPending() {
+      if (unlikely(lazy_pending.load())) buildLazy();
+    }
+
+    /* commits the scene in a background thread and invokes func when done */
+    void commitAsync (RTCCommitCompleteFunction func, void* ptr);
+
+    /* waits for a pending asynchronous commit to finish */
+    void joinCommitAsync ();
+
+    /* commits multiple scenes of the same device in a single task graph */
+    static void commitScenes (Scene** scenes, size_t numScenes);
     void build () {}
 
     /* return number of geometries */
@@ -249,10 +292,13 @@ namespace embree
 
     /* flag decoding */
     __forceinline bool isFastAccel() const { return !isCompactAccel() && !isRobustAccel(); }
-    __forceinline bool isCompactAccel() const { return scene_flags & RTC_SCENE_FLAG_COMPACT; }
+    __forceinline bool isCompactAccel() const { return (scene_flags & RTC_SCENE_FLAG_COMPACT) || memory_layout == AccelMemoryModel::COMPACT; }
     __forceinline bool isRobustAccel()  const { return scene_flags & RTC_SCENE_FLAG_ROBUST; }
     __forceinline bool isStaticAccel()  const { return !(scene_flags & RTC_SCENE_FLAG_DYNAMIC); }
     __forceinline bool isDynamicAccel() const { return scene_flags & RTC_SCENE_FLAG_DYNAMIC; }
+    __forceinline bool isDeterministicAccel() const { return scene_flags & RTC_SCENE_FLAG_DETERMINISTIC; }
+    __forceinline bool isLazyAccel() const { return scene_flags & RTC_SCENE_FLAG_LAZY; }
+    __forceinline bool isHighQualityAccel() const { return quality_flags == RTC_BUILD_QUALITY_HIGH || quality_flags == RTC_BUILD_QUALITY_OPTIMIZED; }
     
     __forceinline bool hasArgumentFilterFunction() const {
       return scene_flags & RTC_SCENE_FLAG_FILTER_FUNCTION_IN_ARGUMENTS;
@@ -284,6 +330,8 @@ namespace embree
     
     RTCSceneFlags scene_flags;
     RTCBuildQuality quality_flags;
+    RTCBuildQuality requested_quality_flags; //!< quality set by the user, the build time budget may select a lower one
+    RTCBuildQuality max_geometry_quality;    //!< highest quality of geometries of two-level BVHs
     MutexSys buildMutex;
     SpinLock geometriesMutex;
 
@@ -316,8 +364,31 @@ namespace embree
     void setProgressMonitorFunction(RTCProgressMonitorFunction func, void* ptr);
 
   private:
+    static std::vector<std::vector<Scene*>> commitWaves(Scene** scenes, size_t numScenes);
+    static void commitScenesFailed(const std::vector<std::vector<Scene*>>& waves);
+    static void asyncCommitThreadFunc(void* ptr);
+    MutexSys asyncCommitMutex;
+    thread_t async_commit_thread;
+    RTCCommitCompleteFunction async_commit_function;
+    void* async_commit_ptr;
+
     GeometryCounts world;               //!< counts for geometry
 
+    float build_time_budget;                  //!< build time budget in milliseconds, zero if disabled
+    double build_deadline;                    //!< end of the build time budget of the current commit, zero if unlimited
+    BuildTimeModel build_time_model;          //!< estimates the build time of each strategy
+    BuildTimeModel::Strategy build_strategy;  //!< strategy selected for the current commit
+    size_t build_primitives;                  //!< number of primitives the current commit builds
+
+    AccelMemoryModel::Layout memory_layout;   //!< layout selected by the memory budget of the device
+    size_t accel_bytes;                       //!< estimated bytes of the acceleration structures of the last commit
+
+    void buildLazy();
+    bool defer_cpu_accels();
+    std::atomic<bool> lazy_pending;           //!< true if the last commit only computed the bounds
+    std::atomic<bool> lazy_triggered;         //!< true if a traversal requested the deferred build
+    MutexSys lazyMutex;                       //!< serializes the threads that trigger the deferred build
+
   public:
 
     __forceinline size_t numPrimitives() const {
@@ -164,6 +164,31 @@ namespace embree
       return BBox3fa(min(v0,v1,v2,v3),max(v0,v1,v2,v3));
     }
 
+    /*! calculates the bounds of the i'th quad in the specified space */
+    __forceinline BBox3fa bounds(const LinearSpace3fa& space, size_t i) const
+    {
+      const Quad& q = quad(i);
+      const Vec3fa v0 = xfmVector(space,vertex(q.v[0]));
+      const Vec3fa v1 = xfmVector(space,vertex(q.v[1]));
+      const Vec3fa v2 = xfmVector(space,vertex(q.v[2]));
+      const Vec3fa v3 = xfmVector(space,vertex(q.v[3]));
+      return BBox3fa(min(v0,v1,v2,v3),max(v0,v1,v2,v3));
+    }
+
+    /*! calculates the direction of the longest edge of the i'th quad */
+    __forceinline Vec3fa longestEdge(size_t i) const
+    {
+      const Quad& q = quad(i);
+      const Vec3fa v0 = vertex(q.v[0]);
+      const Vec3fa v1 = vertex(q.v[1]);
+      const Vec3fa v2 = vertex(q.v[2]);
+      const Vec3fa v3 = vertex(q.v[3]);
+      const Vec3fa e0 = v1-v0, e1 = v2-v1, e2 = v3-v2, e3 = v0-v3;
+      const Vec3fa e01 = dot(e0,e0) >= dot(e1,e1) ? e0 : e1;
+      const Vec3fa e23 = dot(e2,e2) >= dot(e3,e3) ? e2 : e3;
+      return dot(e01,e01) >= dot(e23,e23) ? e01 : e23;
+    }
+
     /*! calculates the bounds of the i'th quad at the itime'th timestep */
     __forceinline BBox3fa bounds(size_t i, size_t itime) const
     {
@@ -312,6 +337,18 @@ namespace embree
         return linearBounds(primID,time_range);
       }
 
+      Vec3fa computeDirection(unsigned int primID) const {
+        return longestEdge(primID);
+      }
+
+      BBox3fa vbounds(size_t primID) const {
+        return bounds(primID);
+      }
+
+      BBox3fa vbounds(const LinearSpace3fa& space, size_t primID) const {
+        return bounds(space,primID);
+      }
+
       PrimInfo createPrimRefArray(PrimRef* prims, const range<size_t>& r, size_t k, unsigned int geomID) const
       {
         PrimInfo pinfo(empty);
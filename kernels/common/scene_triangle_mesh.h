@@ -151,6 +151,29 @@ namespace embree
       return BBox3fa(min(v0,v1,v2),max(v0,v1,v2));
     }
 
+    /*! calculates the bounds of the i'th triangle in the specified space */
+    __forceinline BBox3fa bounds(const LinearSpace3fa& space, size_t i) const
+    {
+      const Triangle& tri = triangle(i);
+      const Vec3fa v0 = xfmVector(space,vertex(tri.v[0]));
+      const Vec3fa v1 = xfmVector(space,vertex(tri.v[1]));
+      const Vec3fa v2 = xfmVector(space,vertex(tri.v[2]));
+      return BBox3fa(min(v0,v1,v2),max(v0,v1,v2));
+    }
+
+    /*! calculates the direction of the longest edge of the i'th triangle */
+    __forceinline Vec3fa longestEdge(size_t i) const
+    {
+      const Triangle& tri = triangle(i);
+      const Vec3fa v0 = vertex(tri.v[0]);
+      const Vec3fa v1 = vertex(tri.v[1]);
+      const Vec3fa v2 = vertex(tri.v[2]);
+      const Vec3fa e0 = v1-v0, e1 = v2-v1, e2 = v0-v2;
+      const float l0 = dot(e0,e0), l1 = dot(e1,e1), l2 = dot(e2,e2);
+      if (l0 >= l1 && l0 >= l2) return e0;
+      return l1 >= l2 ? e1 : e2;
+    }
+
     /*! calculates the bounds of the i'th triangle at the itime'th timestep */
     __forceinline BBox3fa bounds(size_t i, size_t itime) const
     {
@@ -287,6 +310,18 @@ namespace embree
         return linearBounds(primID,time_range);
       }
 
+      Vec3fa computeDirection(unsigned int primID) const {
+        return longestEdge(primID);
+      }
+
+      BBox3fa vbounds(size_t primID) const {
+        return bounds(primID);
+      }
+
+      BBox3fa vbounds(const LinearSpace3fa& space, size_t primID) const {
+        return bounds(space,primID);
+      }
+
       PrimInfo createPrimRefArray(PrimRef* prims, const range<size_t>& r, size_t k, unsigned int geomID) const
       {
         PrimInfo pinfo(empty);
@@ -85,6 +85,13 @@ namespace embree
     useSpatialPreSplits = false;
 
     tessellation_cache_size = 128*1024*1024;
+    refit_max_sah_degradation = 1.5f;
+    treelet_size = 8;
+    treelet_optimization_budget = 0.0f;
+    bvh_cache_dir = "";
+    mesh_dedup = false;
+    bvh_layout = "default";
+    memory_budget = 0;
 
     subdiv_accel = "default";
     subdiv_accel_mb = "default";
@@ -405,6 +412,7 @@ namespace embree
           if      (flag == Token::Id("low"))    quality_flags = RTC_BUILD_QUALITY_LOW;
           else if (flag == Token::Id("medium")) quality_flags = RTC_BUILD_QUALITY_MEDIUM;
           else if (flag == Token::Id("high"))   quality_flags = RTC_BUILD_QUALITY_HIGH;
+          else if (flag == Token::Id("optimized")) quality_flags = RTC_BUILD_QUALITY_OPTIMIZED;
         }
       }
 
@@ -416,6 +424,8 @@ namespace embree
             if (flag == Token::Id("dynamic") ) scene_flags |= RTC_SCENE_FLAG_DYNAMIC;
             else if (flag == Token::Id("compact")) scene_flags |= RTC_SCENE_FLAG_COMPACT;
             else if (flag == Token::Id("robust")) scene_flags |= RTC_SCENE_FLAG_ROBUST;
+            else if (flag == Token::Id("deterministic")) scene_flags |= RTC_SCENE_FLAG_DETERMINISTIC;
+            else if (flag == Token::Id("lazy")) scene_flags |= RTC_SCENE_FLAG_LAZY;
           } while (cin->trySymbol("|"));
         }
       }
@@ -423,6 +433,22 @@ namespace embree
       else if (tok == Token::Id("max_spatial_split_replications") && cin->trySymbol("="))
         max_spatial_split_replications = cin->get().Float();
 
+      else if (tok == Token::Id("refit_max_sah_degradation") && cin->trySymbol("="))
+        refit_max_sah_degradation = cin->get().Float();
+
+      else if (tok == Token::Id("treelet_size") && cin->trySymbol("="))
+        treelet_size = cin->get().Int();
+      else if (tok == Token::Id("treelet_optimization_budget") && cin->trySymbol("="))
+        treelet_optimization_budget = cin->get().Float();
+      else if (tok == Token::Id("bvh_cache_dir") && cin->trySymbol("="))
+        bvh_cache_dir = cin->get().String();
+      else if (tok == Token::Id("mesh_dedup") && cin->trySymbol("="))
+        mesh_dedup = cin->get().Int() != 0;
+      else if (tok == Token::Id("bvh_layout") && cin->trySymbol("="))
+        bvh_layout = cin->get().Identifier();
+      else if (tok == Token::Id("memory_budget") && cin->trySymbol("="))
+        memory_budget = size_t(double(cin->get().Float())*1024.0*1024.0);
+
       else if (tok == Token::Id("presplits") && cin->trySymbol("="))
         useSpatialPreSplits = cin->get().Int() != 0 ? true : false;
 
@@ -471,6 +497,13 @@ namespace embree
     std::cout << "  verbosity          = " << verbose << std::endl;
     std::cout << "  cache_size         = " << float(tessellation_cache_size)*1E-6 << " MB" << std::endl;
     std::cout << "  max_spatial_split_replications = " << max_spatial_split_replications << std::endl;
+    std::cout << "  refit_max_sah_degradation = " << refit_max_sah_degradation << std::endl;
+    std::cout << "  treelet_size = " << treelet_size << std::endl;
+    std::cout << "  treelet_optimization_budget = " << treelet_optimization_budget << " ms" << std::endl;
+    std::cout << "  bvh_cache_dir = \"" << bvh_cache_dir << "\"" << std::endl;
+    std::cout << "  mesh_dedup = " << mesh_dedup << std::endl;
+    std::cout << "  bvh_layout = " << bvh_layout << std::endl;
+    std::cout << "  memory_budget = " << float(memory_budget)*1E-6 << " MB" << std::endl;
     
     std::cout << "triangles:" << std::endl;
     std::cout << "  accel              = " << tri_accel << std::endl;
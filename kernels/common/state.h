@@ -109,6 +109,13 @@ namespace embree
     float max_spatial_split_replications;  //!< maximally replications*N many primitives in accel for spatial splits
     bool useSpatialPreSplits;              //!< use spatial pre-splits instead of the full spatial split builder
     size_t tessellation_cache_size;        //!< size of the shared tessellation cache 
+    float refit_max_sah_degradation;       //!< refit BVHs get (partially) rebuilt when their SAH cost grows by this factor, 0 disables
+    size_t treelet_size;                   //!< maximum number of leaves of the treelets restructured for RTC_BUILD_QUALITY_OPTIMIZED
+    float treelet_optimization_budget;     //!< time budget in ms of the treelet restructuring pass, 0 is unlimited
+    std::string bvh_cache_dir;             //!< directory of the on-disk BVH cache, empty disables the cache
+    bool mesh_dedup;                       //!< two-level builds copy the BVH of modified meshes from an identical mesh
+    std::string bvh_layout;                //!< memory layout of BVH nodes of static scenes, hot_first repacks the BVH after the build
+    size_t memory_budget;                  //!< bytes of memory the device should stay within by building compact acceleration structures, 0 disables
 
   public:
     size_t instancing_open_min;            //!< instancing opens tree to minimally that number of subtrees
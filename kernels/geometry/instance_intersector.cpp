@@ -27,7 +27,9 @@ namespace embree
         const Vec3ff ray_dir = ray.dir;
         ray.org = Vec3ff(xfmPoint(world2local, ray_org), ray.tnear());
         ray.dir = Vec3ff(xfmVector(world2local, ray_dir), ray.time());
+        ((Scene*)instance->object)->buildLazyIfPending();
         RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
+        newcontext.multiHit = context->multiHit;
         instance->object->intersectors.intersect((RTCRayHit&)ray, &newcontext);
         ray.org = ray_org;
         ray.dir = ray_dir;
@@ -54,6 +56,7 @@ namespace embree
         const Vec3ff ray_dir = ray.dir;
         ray.org = Vec3ff(xfmPoint(world2local, ray_org), ray.tnear());
         ray.dir = Vec3ff(xfmVector(world2local, ray_dir), ray.time());
+        ((Scene*)instance->object)->buildLazyIfPending();
         RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
         instance->object->intersectors.occluded((RTCRay&)ray, &newcontext);
         ray.org = ray_org;
@@ -82,6 +85,7 @@ namespace embree
         query_inst.p = xfmPoint(world2local, query->p); 
         query_inst.radius = query->radius * similarityScale;
 
+        ((Scene*)instance->object)->buildLazyIfPending();
         PointQueryContext context_inst(
           (Scene*)instance->object, 
           context->query_ws, 
@@ -116,7 +120,9 @@ namespace embree
         const Vec3ff ray_dir = ray.dir;
         ray.org = Vec3ff(xfmPoint(world2local, ray_org), ray.tnear());
         ray.dir = Vec3ff(xfmVector(world2local, ray_dir), ray.time());
+        ((Scene*)instance->object)->buildLazyIfPending();
         RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
+        newcontext.multiHit = context->multiHit;
         instance->object->intersectors.intersect((RTCRayHit&)ray, &newcontext);
         ray.org = ray_org;
         ray.dir = ray_dir;
@@ -143,6 +149,7 @@ namespace embree
         const Vec3ff ray_dir = ray.dir;
         ray.org = Vec3ff(xfmPoint(world2local, ray_org), ray.tnear());
         ray.dir = Vec3ff(xfmVector(world2local, ray_dir), ray.time());
+        ((Scene*)instance->object)->buildLazyIfPending();
         RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
         instance->object->intersectors.occluded((RTCRay&)ray, &newcontext);
         ray.org = ray_org;
@@ -170,6 +177,7 @@ namespace embree
         query_inst.p = xfmPoint(world2local, query->p); 
         query_inst.radius = query->radius * similarityScale;
         
+        ((Scene*)instance->object)->buildLazyIfPending();
         PointQueryContext context_inst(
           (Scene*)instance->object, 
           context->query_ws, 
@@ -207,6 +215,7 @@ namespace embree
         const Vec3vf<K> ray_dir = ray.dir;
         ray.org = xfmPoint(world2local, ray_org);
         ray.dir = xfmVector(world2local, ray_dir);
+        ((Scene*)instance->object)->buildLazyIfPending();
         RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
         instance->object->intersectors.intersect(valid, ray, &newcontext);
         ray.org = ray_org;
@@ -236,6 +245,7 @@ namespace embree
         const Vec3vf<K> ray_dir = ray.dir;
         ray.org = xfmPoint(world2local, ray_org);
         ray.dir = xfmVector(world2local, ray_dir);
+        ((Scene*)instance->object)->buildLazyIfPending();
         RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
         instance->object->intersectors.occluded(valid, ray, &newcontext);
         ray.org = ray_org;
@@ -266,6 +276,7 @@ namespace embree
         const Vec3vf<K> ray_dir = ray.dir;
         ray.org = xfmPoint(world2local, ray_org);
         ray.dir = xfmVector(world2local, ray_dir);
+        ((Scene*)instance->object)->buildLazyIfPending();
         RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
         instance->object->intersectors.intersect(valid, ray, &newcontext);
         ray.org = ray_org;
@@ -295,6 +306,7 @@ namespace embree
         const Vec3vf<K> ray_dir = ray.dir;
         ray.org = xfmPoint(world2local, ray_org);
         ray.dir = xfmVector(world2local, ray_dir);
+        ((Scene*)instance->object)->buildLazyIfPending();
         RayQueryContext newcontext((Scene*)instance->object, user_context, context->args);
         instance->object->intersectors.occluded(valid, ray, &newcontext);
         ray.org = ray_org;
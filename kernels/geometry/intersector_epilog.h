@@ -5,6 +5,7 @@
 
 #include "../common/ray.h"
 #include "../common/context.h"
+#include "../common/multihit.h"
 #include "filter.h"
 
 namespace embree
@@ -17,6 +18,42 @@ namespace embree
     };
 
 
+    /* records a hit of a multi-hit query in the hit buffer of the
+     * context instead of committing it to the ray, and shrinks tfar as
+     * soon as the buffer is full */
+    template<bool filter>
+    __forceinline bool recordMultiHit1(RayHit& ray, RayQueryContext* context, const Geometry* geometry,
+                                       const unsigned int geomID, const unsigned int primID,
+                                       const float t, const float u, const float v, const Vec3fa& Ng)
+    {
+      /* intersection filter test */
+#if defined(EMBREE_FILTER_FUNCTION)
+      if (filter) {
+        if (unlikely(context->hasContextFilter() || geometry->hasIntersectionFilter())) {
+          HitK<1> h(context->user,geomID,primID,u,v,Ng);
+          const float old_t = ray.tfar;
+          ray.tfar = t;
+          const bool found = runIntersectionFilter1(geometry,ray,context,h);
+          ray.tfar = old_t;
+          if (!found) return false;
+        }
+      }
+#endif
+
+      RTCHit h;
+      h.Ng_x = Ng.x;
+      h.Ng_y = Ng.y;
+      h.Ng_z = Ng.z;
+      h.u = u;
+      h.v = v;
+      h.primID = primID;
+      h.geomID = geomID;
+      instance_id_stack::copy_UU(context->user->instID, h.instID);
+      if (!context->multiHit->insert(t,h)) return false;
+      ray.tfar = context->multiHit->tfar(ray.tfar);
+      return true;
+    }
+
     template<bool filter>
     struct Intersect1Epilog1
     {
@@ -42,6 +79,10 @@ namespace embree
 #endif
         hit.finalize();
 
+        /* multi-hit queries record the hit */
+        if (unlikely(context->isMultiHit()))
+          return recordMultiHit1<filter>(ray,context,geometry,geomID,primID,hit.t,hit.u,hit.v,hit.Ng);
+
         /* intersection filter test */
 #if defined(EMBREE_FILTER_FUNCTION)
         if (filter) {
@@ -231,6 +272,27 @@ namespace embree
         Scene* scene MAYBE_UNUSED = context->scene;
         vbool<M> valid = valid_i;
         hit.finalize();
+
+        /* multi-hit queries record all hits front to back */
+        if (unlikely(context->isMultiHit()))
+        {
+          bool foundhit = false;
+          while (any(valid))
+          {
+            const size_t i = select_min(valid,hit.vt);
+            clear(valid,i);
+            const unsigned int geomID = geomIDs[i];
+            Geometry* geometry = scene->get(geomID);
+#if defined(EMBREE_RAY_MASK)
+            if ((geometry->mask & ray.mask) == 0) continue;
+#endif
+            const Vec2f uv = hit.uv(i);
+            foundhit |= recordMultiHit1<filter>(ray,context,geometry,geomID,primIDs[i],hit.t(i),uv.x,uv.y,hit.Ng(i));
+            valid &= hit.vt <= ray.tfar;
+          }
+          return foundhit;
+        }
+
         size_t i = select_min(valid,hit.vt);
         unsigned int geomID = geomIDs[i];
 
@@ -386,6 +448,21 @@ namespace embree
         vbool<M> valid = valid_i;
         hit.finalize();
 
+        /* multi-hit queries record all hits front to back */
+        if (unlikely(context->isMultiHit()))
+        {
+          bool foundhit = false;
+          while (any(valid))
+          {
+            const size_t i = select_min(valid,hit.vt);
+            clear(valid,i);
+            const Vec2f uv = hit.uv(i);
+            foundhit |= recordMultiHit1<filter>(ray,context,geometry,geomID,primID,hit.t(i),uv.x,uv.y,hit.Ng(i));
+            valid &= hit.vt <= ray.tfar;
+          }
+          return foundhit;
+        }
+
         size_t i = select_min(valid,hit.vt);
 
         /* intersection filter test */
@@ -5,6 +5,7 @@
 
 #include "object.h"
 #include "../common/ray.h"
+#include "../common/multihit.h"
 
 namespace embree
 {
@@ -32,6 +33,18 @@ namespace embree
           return;
 #endif
 
+        /* user geometries commit hits to the ray, multi-hit queries move these hits into the hit buffer */
+        if (unlikely(context->isMultiHit()))
+        {
+          const float old_t = ray.tfar;
+          accel->intersect(ray,prim.geomID(),prim.primID(),context);
+          if (ray.tfar < old_t) {
+            context->multiHit->insert(ray);
+            ray.tfar = context->multiHit->tfar(old_t);
+          }
+          return;
+        }
+
         accel->intersect(ray,prim.geomID(),prim.primID(),context);
       }
       
@@ -61,6 +61,7 @@ namespace embree
 
     /* Returns the geometry IDs */
     __forceinline vuint<M> geomID() const { return geomIDs; }
+    __forceinline vuint<M>& geomID() { return geomIDs; }
     __forceinline unsigned int geomID(const size_t i) const { assert(i<M); return geomIDs[i]; }
 
     /* Returns the primitive IDs */
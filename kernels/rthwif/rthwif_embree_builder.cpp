@@ -420,6 +420,7 @@ namespace embree
     case RTC_BUILD_QUALITY_LOW    : return RTHWIF_BUILD_QUALITY_LOW;
     case RTC_BUILD_QUALITY_MEDIUM : return RTHWIF_BUILD_QUALITY_MEDIUM;
     case RTC_BUILD_QUALITY_HIGH   : return RTHWIF_BUILD_QUALITY_HIGH;
+    case RTC_BUILD_QUALITY_OPTIMIZED: return RTHWIF_BUILD_QUALITY_HIGH;
     case RTC_BUILD_QUALITY_REFIT  : return RTHWIF_BUILD_QUALITY_LOW;
     default                       : return RTHWIF_BUILD_QUALITY_MEDIUM;
     }
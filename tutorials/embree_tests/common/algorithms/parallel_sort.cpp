@@ -9,7 +9,7 @@ using namespace embree;
 namespace parallel_sort_unit_test {
 
 template<typename Key>
-bool run_sort_test()
+bool run_sort_test(Key mask = Key(-1))
 {
   bool passed = true;
   const size_t M = 10;
@@ -21,7 +21,7 @@ bool run_sort_test()
     std::vector<Key> tmp(N);
     memset(tmp.data(), 0, N * sizeof(Key));
     for (size_t i = 0; i < N; i++)
-      src[i] = uint64_t(rand()) * uint64_t(rand());
+      src[i] = Key(uint64_t(rand()) * uint64_t(rand())) & mask;
 
     /* calculate checksum */
     Key sum0 = 0;
@@ -59,4 +59,9 @@ TEST_CASE("Test parallel_sort (uint64_t)", "[parallel_sort_uint64_t]")
   REQUIRE(run_sort_test<uint64_t>());
 }
 
+TEST_CASE("Test parallel_sort (uint64_t with constant high bits)", "[parallel_sort_uint64_t_48bit]")
+{
+  REQUIRE(run_sort_test<uint64_t>((uint64_t(1) << 48) - 1));
+}
+
 }
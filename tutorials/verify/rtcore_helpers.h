@@ -357,6 +357,7 @@ namespace embree
     RTCRayN_time(ray_o,N,i) = ray_i.ray.time;
     RTCRayN_mask(ray_o,N,i) = ray_i.ray.mask;
     RTCRayN_id(ray_o,N,i) = ray_i.ray.id;
+    RTCRayN_flags(ray_o,N,i) = ray_i.ray.flags;
     RTCHitN* hit_o = RTCRayHitN_HitN(rayhit_o,N);
     RTCHitN_geomID(hit_o,N,i) = ray_i.hit.geomID;
     RTCHitN_primID(hit_o,N,i) = ray_i.hit.primID;
@@ -489,7 +490,10 @@ namespace embree
     MODE_INTERSECT1,
     MODE_INTERSECT4,
     MODE_INTERSECT8,
-    MODE_INTERSECT16
+    MODE_INTERSECT16,
+    MODE_INTERSECT_STREAM,
+    MODE_INTERSECT_STREAM_N,
+    MODE_INTERSECT_STREAM_BREADTH_FIRST
   };
 
   inline std::string to_string(IntersectMode imode)
@@ -500,6 +504,9 @@ namespace embree
     case MODE_INTERSECT4: return "4";
     case MODE_INTERSECT8: return "8";
     case MODE_INTERSECT16: return "16";
+    case MODE_INTERSECT_STREAM: return "Stream";
+    case MODE_INTERSECT_STREAM_N: return "StreamN";
+    case MODE_INTERSECT_STREAM_BREADTH_FIRST: return "StreamBreadthFirst";
     default                : return "U";
     }
   }
@@ -512,6 +519,9 @@ namespace embree
     case MODE_INTERSECT4: return 16;
     case MODE_INTERSECT8: return 32;
     case MODE_INTERSECT16: return 64;
+    case MODE_INTERSECT_STREAM: return 16;
+    case MODE_INTERSECT_STREAM_N: return 16;
+    case MODE_INTERSECT_STREAM_BREADTH_FIRST: return 16;
     default              : return 0;
     }
   }
@@ -555,6 +565,9 @@ namespace embree
     case MODE_INTERSECT4:
     case MODE_INTERSECT8:
     case MODE_INTERSECT16:
+    case MODE_INTERSECT_STREAM:
+    case MODE_INTERSECT_STREAM_N:
+    case MODE_INTERSECT_STREAM_BREADTH_FIRST:
       switch (ivariant) {
       case VARIANT_INTERSECT: return true;
       case VARIANT_OCCLUDED : return true;
@@ -573,6 +586,9 @@ namespace embree
     case MODE_INTERSECT4:
     case MODE_INTERSECT8:
     case MODE_INTERSECT16:
+    case MODE_INTERSECT_STREAM:
+    case MODE_INTERSECT_STREAM_N:
+    case MODE_INTERSECT_STREAM_BREADTH_FIRST:
       switch (ivariant) {
       case VARIANT_INTERSECT: return "Intersect" + to_string(imode);
       case VARIANT_OCCLUDED : return "Occluded" + to_string(imode);
@@ -591,6 +607,8 @@ namespace embree
     else ret += "Static";
     if (scene_flags & RTC_SCENE_FLAG_COMPACT) ret += "Compact";
     if (scene_flags & RTC_SCENE_FLAG_ROBUST ) ret += "Robust";
+    if (scene_flags & RTC_SCENE_FLAG_DETERMINISTIC) ret += "Deterministic";
+    if (scene_flags & RTC_SCENE_FLAG_LAZY) ret += "Lazy";
     if (!(scene_flags & RTC_SCENE_FLAG_COMPACT) && !(scene_flags & RTC_SCENE_FLAG_ROBUST)) ret += "Fast"; 
     return ret;
   }
@@ -601,6 +619,7 @@ namespace embree
     else if (quality_flags == RTC_BUILD_QUALITY_MEDIUM) return "MediumQuality";
     else if (quality_flags == RTC_BUILD_QUALITY_HIGH  ) return "HighQuality";
     else if (quality_flags == RTC_BUILD_QUALITY_REFIT ) return "RefitQuality";
+    else if (quality_flags == RTC_BUILD_QUALITY_OPTIMIZED) return "OptimizedQuality";
     else { assert(false); return ""; }
   }
 
@@ -713,6 +732,38 @@ namespace embree
       }
       break;
     }
+    case MODE_INTERSECT_STREAM:
+    {
+      switch (ivariant & VARIANT_INTERSECT_OCCLUDED_MASK) {
+      case VARIANT_INTERSECT: rtcIntersectStream(scene,rays,N,sizeof(RTCRayHit),args); break;
+      case VARIANT_OCCLUDED : rtcOccludedStream (scene,(RTCRay*)rays,N,sizeof(RTCRayHit),(RTCOccludedArguments*)args); break;
+      default: assert(false);
+      }
+      break;
+    }
+    case MODE_INTERSECT_STREAM_N:
+    {
+      vector_t<char,aligned_allocator<char,16>> data(N*sizeof(RTCRayHit));
+      RTCRayHitN* rayN = (RTCRayHitN*) data.data();
+      for (unsigned int i=0; i<N; i++) setRay(rayN,N,i,rays[i]);
+      switch (ivariant & VARIANT_INTERSECT_OCCLUDED_MASK) {
+      case VARIANT_INTERSECT: rtcIntersectStreamN(scene,rayN,N,args); break;
+      case VARIANT_OCCLUDED : rtcOccludedStreamN (scene,RTCRayHitN_RayN(rayN,N),N,(RTCOccludedArguments*)args); break;
+      default: assert(false);
+      }
+      for (unsigned int i=0; i<N; i++) rays[i] = getRay(rayN,N,i);
+      break;
+    }
+    case MODE_INTERSECT_STREAM_BREADTH_FIRST:
+    {
+      args->flags = (RTCRayQueryFlags) (args->flags | RTC_RAY_QUERY_FLAG_BREADTH_FIRST);
+      switch (ivariant & VARIANT_INTERSECT_OCCLUDED_MASK) {
+      case VARIANT_INTERSECT: rtcIntersectStream(scene,rays,N,sizeof(RTCRayHit),args); break;
+      case VARIANT_OCCLUDED : rtcOccludedStream (scene,(RTCRay*)rays,N,sizeof(RTCRayHit),(RTCOccludedArguments*)args); break;
+      default: assert(false);
+      }
+      break;
+    }
     }
   }
 
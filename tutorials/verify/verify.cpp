@@ -1206,6 +1206,1249 @@ namespace embree
     }
   };
 
+  struct PLOCBuildTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    RTCBuildQuality quality;
+
+    PLOCBuildTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      std::string ploc_cfg = cfg + ",tri_builder=ploc,quad_builder=ploc";
+      RTCDeviceRef ploc_device = rtcNewDevice(ploc_cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(ploc_device));
+      VerifyScene scene(device,sflags);
+      VerifyScene ploc_scene(ploc_device,sflags);
+
+      /* randomly placed spheres of different size make the clustering non-trivial */
+      for (size_t i=0; i<16; i++)
+      {
+        const Vec3fa center = 8.0f*Vec3fa(random_float(),random_float(),random_float());
+        const float radius = 0.2f+random_float();
+        Ref<SceneGraph::Node> node;
+        if (i%2) node = SceneGraph::createTriangleSphere(center,radius,10+random_int()%40);
+        else     node = SceneGraph::createQuadSphere(center,radius,10+random_int()%40);
+        scene.addGeometry(quality,node);
+        ploc_scene.addGeometry(quality,node);
+      }
+      rtcCommitScene(scene);
+      AssertNoError(device);
+      rtcCommitScene(ploc_scene);
+      AssertNoError(ploc_device);
+
+      for (size_t i=0; i<1000; i++)
+      {
+        const Vec3fa org = 10.0f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(1.0f);
+        const Vec3fa dir = 2.0f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(1.0f);
+        RTCRayHit ray0 = makeRay(org,dir); rtcIntersect1(scene,&ray0);
+        RTCRayHit ray1 = makeRay(org,dir); rtcIntersect1(ploc_scene,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.primID != ray1.hit.primID || ray0.ray.tfar != ray1.ray.tfar)
+          return VerifyApplication::FAILED;
+      }
+      AssertNoError(ploc_device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct MortonBuildTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    RTCBuildQuality quality;
+
+    MortonBuildTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      std::string morton_cfg = cfg + ",tri_builder=morton";
+      RTCDeviceRef morton_device = rtcNewDevice(morton_cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(morton_device));
+      VerifyScene scene(device,sflags);
+      VerifyScene morton_scene(morton_device,sflags);
+
+      /* dense clusters of tiny triangles and a far away triangle make many triangles share the same 32 bit morton code, thus 64 bit codes get used */
+      const size_t numClusters = 16;
+      const size_t numClusterTriangles = 1 << 16;
+      Ref<SceneGraph::TriangleMeshNode> mesh = new SceneGraph::TriangleMeshNode(nullptr,BBox1f(0,1),1);
+      std::vector<Vec3fa> centers(numClusters);
+      for (size_t i=0; i<numClusters; i++)
+      {
+        centers[i] = 8.0f*Vec3fa(random_float(),random_float(),random_float());
+        for (size_t j=0; j<numClusterTriangles; j++)
+        {
+          const Vec3fa p = centers[i]+0.5f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(0.25f);
+          const unsigned v = (unsigned) mesh->positions[0].size();
+          for (size_t k=0; k<3; k++)
+            mesh->positions[0].push_back(p+0.01f*Vec3fa(random_float(),random_float(),random_float()));
+          mesh->triangles.push_back(SceneGraph::TriangleMeshNode::Triangle(v+0,v+1,v+2));
+        }
+      }
+      const unsigned v = (unsigned) mesh->positions[0].size();
+      mesh->positions[0].push_back(Vec3fa(1000.0f,0.0f,0.0f));
+      mesh->positions[0].push_back(Vec3fa(1000.0f,1.0f,0.0f));
+      mesh->positions[0].push_back(Vec3fa(1000.0f,0.0f,1.0f));
+      mesh->triangles.push_back(SceneGraph::TriangleMeshNode::Triangle(v+0,v+1,v+2));
+      scene.addGeometry(quality,mesh.dynamicCast<SceneGraph::Node>());
+      morton_scene.addGeometry(quality,mesh.dynamicCast<SceneGraph::Node>());
+
+      rtcCommitScene(scene);
+      AssertNoError(device);
+      rtcCommitScene(morton_scene);
+      AssertNoError(morton_device);
+
+      for (size_t i=0; i<1000; i++)
+      {
+        const Vec3fa org = 10.0f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(1.0f);
+        const Vec3fa dir = centers[i%numClusters]+0.5f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(0.25f)-org;
+        RTCRayHit ray0 = makeRay(org,dir); rtcIntersect1(scene,&ray0);
+        RTCRayHit ray1 = makeRay(org,dir); rtcIntersect1(morton_scene,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.primID != ray1.hit.primID || ray0.ray.tfar != ray1.ray.tfar)
+          return VerifyApplication::FAILED;
+      }
+      AssertNoError(morton_device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct BVHLayoutTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    RTCBuildQuality quality;
+
+    BVHLayoutTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      std::string layout_cfg = cfg + ",bvh_layout=hot_first";
+      RTCDeviceRef layout_device = rtcNewDevice(layout_cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(layout_device));
+      VerifyScene scene(device,sflags);
+      VerifyScene layout_scene(layout_device,sflags);
+
+      /* spheres of different size give children of different surface area, some of them moving to get motion blur nodes */
+      for (size_t i=0; i<16; i++)
+      {
+        const Vec3fa center = 8.0f*Vec3fa(random_float(),random_float(),random_float());
+        const float radius = 0.2f+random_float();
+        Ref<SceneGraph::Node> node;
+        if (i%2) node = SceneGraph::createTriangleSphere(center,radius,10+random_int()%40);
+        else     node = SceneGraph::createQuadSphere(center,radius,10+random_int()%40);
+        if (i%4 == 3) node = node->set_motion_vector(random_motion_vector(1.0f));
+        scene.addGeometry(quality,node);
+        layout_scene.addGeometry(quality,node);
+      }
+      rtcCommitScene(scene);
+      AssertNoError(device);
+      rtcCommitScene(layout_scene);
+      AssertNoError(layout_device);
+
+      for (size_t i=0; i<1000; i++)
+      {
+        const Vec3fa org = 10.0f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(1.0f);
+        const Vec3fa dir = 2.0f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(1.0f);
+        RTCRayHit ray0 = makeRay(org,dir); rtcIntersect1(scene,&ray0);
+        RTCRayHit ray1 = makeRay(org,dir); rtcIntersect1(layout_scene,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.primID != ray1.hit.primID || ray0.ray.tfar != ray1.ray.tfar)
+          return VerifyApplication::FAILED;
+      }
+      AssertNoError(layout_device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct MemoryBudgetTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    MemoryBudgetTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    static bool memoryMonitor(void* userPtr, const ssize_t bytes, const bool /*post*/)
+    {
+      *(std::atomic<ssize_t>*)userPtr += bytes;
+      return true;
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      std::string budget_cfg = cfg + ",memory_budget=1";
+      RTCDeviceRef budget_device = rtcNewDevice(budget_cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(budget_device));
+
+      std::atomic<ssize_t> bytes(0), budget_bytes(0);
+      rtcSetDeviceMemoryMonitorFunction(device,memoryMonitor,&bytes);
+      rtcSetDeviceMemoryMonitorFunction(budget_device,memoryMonitor,&budget_bytes);
+
+      /* the default acceleration structures of these spheres exceed the budget of 1 MB, thus the compact ones get built */
+      {
+        VerifyScene scene(device,sflags);
+        VerifyScene compact_scene(device,SceneFlags(RTCSceneFlags(sflags.sflags | RTC_SCENE_FLAG_COMPACT),RTC_BUILD_QUALITY_MEDIUM));
+        VerifyScene budget_scene(budget_device,sflags);
+        for (size_t i=0; i<4; i++)
+        {
+          const Vec3fa center = 8.0f*Vec3fa(random_float(),random_float(),random_float());
+          const float radius = 0.5f+random_float();
+          Ref<SceneGraph::Node> node;
+          if (i%2) node = SceneGraph::createTriangleSphere(center,radius,100);
+          else     node = SceneGraph::createQuadSphere(center,radius,100);
+          scene.addGeometry(sflags.qflags,node);
+          compact_scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,node);
+          budget_scene.addGeometry(sflags.qflags,node);
+        }
+        rtcCommitScene(compact_scene);
+        AssertNoError(device);
+        const ssize_t compact_bytes = bytes;
+        rtcCommitScene(scene);
+        AssertNoError(device);
+        rtcCommitScene(budget_scene);
+        AssertNoError(budget_device);
+
+        /* only the compact scene fits into the budget */
+        const ssize_t default_bytes = bytes-compact_bytes;
+        if (budget_bytes.load() > compact_bytes + compact_bytes/8 || budget_bytes.load() >= default_bytes)
+          return VerifyApplication::FAILED;
+
+        for (size_t i=0; i<1000; i++)
+        {
+          const Vec3fa org = 10.0f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(1.0f);
+          const Vec3fa dir = 2.0f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(1.0f);
+          RTCRayHit ray0 = makeRay(org,dir); rtcIntersect1(compact_scene,&ray0);
+          RTCRayHit ray1 = makeRay(org,dir); rtcIntersect1(budget_scene,&ray1);
+          if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.primID != ray1.hit.primID || ray0.ray.tfar != ray1.ray.tfar)
+            return VerifyApplication::FAILED;
+        }
+        AssertNoError(budget_device);
+      }
+
+      rtcSetDeviceMemoryMonitorFunction(device,nullptr,nullptr);
+      rtcSetDeviceMemoryMonitorFunction(budget_device,nullptr,nullptr);
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct CommitEstimateTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    CommitEstimateTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    struct MemoryCounter
+    {
+      std::atomic<ssize_t> bytes;
+      std::atomic<ssize_t> peak;
+    };
+
+    static bool memoryMonitor(void* userPtr, const ssize_t bytes, const bool /*post*/)
+    {
+      MemoryCounter* counter = (MemoryCounter*) userPtr;
+      const ssize_t b = counter->bytes += bytes;
+      ssize_t peak = counter->peak;
+      while (b > peak && !counter->peak.compare_exchange_weak(peak,b));
+      return true;
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      MemoryCounter counter;
+      counter.bytes = 0;
+      counter.peak = 0;
+
+      {
+        VerifyScene scene(device,sflags);
+        RTCSceneCommitEstimate estimate;
+        rtcEstimateSceneCommit(scene,&estimate);
+        AssertNoError(device);
+        if (estimate.accelBytes != 0 || estimate.peakBytes != 0)
+          return VerifyApplication::FAILED;
+
+        for (size_t i=0; i<4; i++)
+        {
+          const Vec3fa center = 8.0f*Vec3fa(random_float(),random_float(),random_float());
+          const float radius = 0.5f+random_float();
+          Ref<SceneGraph::Node> node;
+          if (i%2) node = SceneGraph::createTriangleSphere(center,radius,100);
+          else     node = SceneGraph::createQuadSphere(center,radius,100);
+          scene.addGeometry(sflags.qflags,node);
+        }
+
+        /* estimating must not allocate anything */
+        rtcSetDeviceMemoryMonitorFunction(device,memoryMonitor,&counter);
+        rtcEstimateSceneCommit(scene,&estimate);
+        AssertNoError(device);
+        if (counter.peak.load() != 0)
+          return VerifyApplication::FAILED;
+        if (estimate.accelBytes == 0 || estimate.peakBytes < estimate.accelBytes || !(estimate.buildTime > 0.0))
+          return VerifyApplication::FAILED;
+
+        rtcCommitScene(scene);
+        AssertNoError(device);
+        const double accelBytes = double(counter.bytes.load());
+        const double peakBytes = double(counter.peak.load());
+        if (!silent)
+          std::cout << " " << 1E-6*double(estimate.accelBytes) << " MB (" << 1E-6*accelBytes << " MB), peak "
+                    << 1E-6*double(estimate.peakBytes) << " MB (" << 1E-6*peakBytes << " MB) " << std::flush;
+
+        /* the estimates are not bounds but should be within a small factor of the measured memory */
+        if (double(estimate.accelBytes) < 0.5*accelBytes || double(estimate.accelBytes) > 2.0*accelBytes)
+          return VerifyApplication::FAILED;
+        if (double(estimate.peakBytes) < 0.5*peakBytes || double(estimate.peakBytes) > 2.0*peakBytes)
+          return VerifyApplication::FAILED;
+      }
+
+      rtcSetDeviceMemoryMonitorFunction(device,nullptr,nullptr);
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  /* long and thin strips running diagonally through the scene, such as cables, whose axis-aligned bounding boxes heavily overlap */
+  static void addCables(VerifyScene& scene, RTCBuildQuality quality, size_t numCables, int seed)
+  {
+    RandomSampler sampler;
+    RandomSampler_init(sampler,seed);
+    for (size_t i=0; i<numCables; i++)
+    {
+      const Vec3fa p0 = 8.0f*RandomSampler_get3D(sampler)-Vec3fa(2.0f);
+      const Vec3fa dx = Vec3fa(4.0f)+0.3f*(RandomSampler_get3D(sampler)-Vec3fa(0.5f));
+      const Vec3fa dy = 0.02f*normalize(cross(dx,RandomSampler_get3D(sampler)-Vec3fa(0.5f)));
+      if (i%2) scene.addGeometry(quality,SceneGraph::createTrianglePlane(p0,dx,dy,1,1));
+      else     scene.addGeometry(quality,SceneGraph::createQuadPlane(p0,dx,dy,1,1));
+    }
+  }
+
+  struct OBBBuildTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    OBBBuildTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      std::string obb_cfg = cfg + ",tri_accel=bvh8obb.triangle4v,quad_accel=bvh8obb.quad4v";
+      RTCDeviceRef obb_device = rtcNewDevice(obb_cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(obb_device));
+
+      /* robust scenes use the same Pluecker leaf intersectors in the default BVH8 and the OBB BVH8 */
+      const SceneFlags robustFlags(RTCSceneFlags(sflags.sflags | RTC_SCENE_FLAG_ROBUST),sflags.qflags);
+      VerifyScene scene(device,robustFlags);
+      VerifyScene obb_scene(obb_device,robustFlags);
+      addCables(scene,sflags.qflags,256,1);
+      addCables(obb_scene,sflags.qflags,256,1);
+      rtcCommitScene(scene);
+      AssertNoError(device);
+      rtcCommitScene(obb_scene);
+      AssertNoError(obb_device);
+
+      for (size_t i=0; i<1000; i++)
+      {
+        /* single rays and packets traverse the oriented nodes with different code */
+        RTCRayHit rays0[8], rays1[8];
+        RTCRayHit8 ray8_0, ray8_1;
+        __aligned(32) int valid8[8] = { -1,-1,-1,-1,-1,-1,-1,-1 };
+        for (size_t k=0; k<8; k++)
+        {
+          const Vec3fa org = 10.0f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(1.0f);
+          const Vec3fa dir = 2.0f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(1.0f);
+          rays0[k] = makeRay(org,dir); rtcIntersect1(scene,&rays0[k]);
+          rays1[k] = makeRay(org,dir); rtcIntersect1(obb_scene,&rays1[k]);
+          setRay(ray8_0,k,makeRay(org,dir));
+          setRay(ray8_1,k,makeRay(org,dir));
+        }
+        rtcIntersect8(valid8,scene,&ray8_0);
+        rtcIntersect8(valid8,obb_scene,&ray8_1);
+        for (size_t k=0; k<8; k++)
+        {
+          if (rays0[k].hit.geomID != rays1[k].hit.geomID || rays0[k].hit.primID != rays1[k].hit.primID || rays0[k].ray.tfar != rays1[k].ray.tfar)
+            return VerifyApplication::FAILED;
+          const RTCRayHit hit0 = getRay(ray8_0,k);
+          const RTCRayHit hit1 = getRay(ray8_1,k);
+          if (hit0.hit.geomID != hit1.hit.geomID || hit0.hit.primID != hit1.hit.primID || hit0.ray.tfar != hit1.ray.tfar)
+            return VerifyApplication::FAILED;
+        }
+      }
+      AssertNoError(obb_device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct TreeletOptimizationTest : public VerifyApplication::Test
+  {
+    RTCSceneFlags sflags;
+    std::string builder;
+    size_t treelet_size;
+
+    TreeletOptimizationTest (std::string name, int isa, RTCSceneFlags sflags, std::string builder, size_t treelet_size)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), builder(builder), treelet_size(treelet_size) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      std::string opt_cfg = cfg + ",tri_builder="+builder+",treelet_size="+std::to_string(treelet_size);
+      RTCDeviceRef opt_device = rtcNewDevice(opt_cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(opt_device));
+      VerifyScene scene(device,SceneFlags(sflags,RTC_BUILD_QUALITY_HIGH));
+      VerifyScene opt_scene(opt_device,SceneFlags(sflags,RTC_BUILD_QUALITY_OPTIMIZED));
+      AssertNoError(opt_device);
+
+      for (size_t i=0; i<16; i++)
+      {
+        const Vec3fa center = 8.0f*Vec3fa(random_float(),random_float(),random_float());
+        const float radius = 0.2f+random_float();
+        Ref<SceneGraph::Node> node;
+        if (i%2) node = SceneGraph::createTriangleSphere(center,radius,10+random_int()%40);
+        else     node = SceneGraph::createQuadSphere(center,radius,10+random_int()%40);
+        scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,node);
+        opt_scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,node);
+      }
+      rtcCommitScene(scene);
+      AssertNoError(device);
+      rtcCommitScene(opt_scene);
+      AssertNoError(opt_device);
+
+      /* restructured treelets have to contain the same primitives */
+      for (size_t i=0; i<1000; i++)
+      {
+        const Vec3fa org = 10.0f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(1.0f);
+        const Vec3fa dir = 2.0f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(1.0f);
+        RTCRayHit ray0 = makeRay(org,dir); rtcIntersect1(scene,&ray0);
+        RTCRayHit ray1 = makeRay(org,dir); rtcIntersect1(opt_scene,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.primID != ray1.hit.primID || ray0.ray.tfar != ray1.ray.tfar)
+          return VerifyApplication::FAILED;
+      }
+      AssertNoError(opt_device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct BVHCacheTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    BVHCacheTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      std::string cache_cfg = cfg + ",bvh_cache_dir=\".\"";
+      RTCDeviceRef cache_device = rtcNewDevice(cache_cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(cache_device));
+      VerifyScene scene(device,sflags);
+      VerifyScene store_scene(cache_device,sflags);
+      VerifyScene load_scene(cache_device,sflags);
+
+      for (size_t i=0; i<16; i++)
+      {
+        const Vec3fa center = 8.0f*Vec3fa(random_float(),random_float(),random_float());
+        const float radius = 0.2f+random_float();
+        Ref<SceneGraph::Node> node;
+        if (i%2) node = SceneGraph::createTriangleSphere(center,radius,10+random_int()%40);
+        else     node = SceneGraph::createQuadSphere(center,radius,10+random_int()%40);
+        scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,node);
+        store_scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,node);
+        load_scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,node);
+      }
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      /* the first commit stores the BVHs, the second one maps them back */
+      rtcCommitScene(store_scene);
+      AssertNoError(cache_device);
+      rtcCommitScene(load_scene);
+      AssertNoError(cache_device);
+
+      for (size_t i=0; i<1000; i++)
+      {
+        const Vec3fa org = 10.0f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(1.0f);
+        const Vec3fa dir = 2.0f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(1.0f);
+        RTCRayHit ray0 = makeRay(org,dir); rtcIntersect1(scene,&ray0);
+        RTCRayHit ray1 = makeRay(org,dir); rtcIntersect1(store_scene,&ray1);
+        RTCRayHit ray2 = makeRay(org,dir); rtcIntersect1(load_scene,&ray2);
+        if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.primID != ray1.hit.primID || ray0.ray.tfar != ray1.ray.tfar)
+          return VerifyApplication::FAILED;
+        if (ray0.hit.geomID != ray2.hit.geomID || ray0.hit.primID != ray2.hit.primID || ray0.ray.tfar != ray2.ray.tfar)
+          return VerifyApplication::FAILED;
+      }
+      AssertNoError(cache_device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct DeterministicBuildTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    DeterministicBuildTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      std::string cfg0 = cfg + ",threads=1";
+      RTCDeviceRef device0 = rtcNewDevice(cfg0.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device0));
+      std::string cfg1 = cfg + ",threads=4";
+      RTCDeviceRef device1 = rtcNewDevice(cfg1.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device1));
+      VerifyScene scene0(device0,sflags);
+      VerifyScene scene1(device1,sflags);
+
+      for (size_t i=0; i<16; i++)
+      {
+        const Vec3fa center = 8.0f*Vec3fa(random_float(),random_float(),random_float());
+        const float radius = 0.2f+random_float();
+        Ref<SceneGraph::Node> node;
+        if (i%2) node = SceneGraph::createTriangleSphere(center,radius,10+random_int()%40);
+        else     node = SceneGraph::createQuadSphere(center,radius,10+random_int()%40);
+        scene0.addGeometry(RTC_BUILD_QUALITY_MEDIUM,node);
+        scene1.addGeometry(RTC_BUILD_QUALITY_MEDIUM,node);
+      }
+      rtcCommitScene(scene0);
+      AssertNoError(device0);
+      rtcCommitScene(scene1);
+      AssertNoError(device1);
+
+      RTCBounds bounds0; rtcGetSceneBounds(scene0,&bounds0);
+      RTCBounds bounds1; rtcGetSceneBounds(scene1,&bounds1);
+      if (memcmp(&bounds0,&bounds1,sizeof(RTCBounds)) != 0)
+        return VerifyApplication::FAILED;
+
+      /* identical hierarchies find the same hit even for rays hitting shared edges */
+      for (size_t i=0; i<1000; i++)
+      {
+        const Vec3fa org = 10.0f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(1.0f);
+        const Vec3fa dir = 2.0f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(1.0f);
+        RTCRayHit ray0 = makeRay(org,dir); rtcIntersect1(scene0,&ray0);
+        RTCRayHit ray1 = makeRay(org,dir); rtcIntersect1(scene1,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.primID != ray1.hit.primID || ray0.ray.tfar != ray1.ray.tfar)
+          return VerifyApplication::FAILED;
+        if (ray0.hit.u != ray1.hit.u || ray0.hit.v != ray1.hit.v)
+          return VerifyApplication::FAILED;
+      }
+      AssertNoError(device1);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct BuildTimeBudgetTest : public VerifyApplication::Test
+  {
+    RTCSceneFlags sflags;
+    float budget;
+
+    BuildTimeBudgetTest (std::string name, int isa, RTCSceneFlags sflags, float budget)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), budget(budget) {}
+
+    void addSphere(VerifyScene& scene0, VerifyScene& scene1, size_t i)
+    {
+      const Vec3fa center = 8.0f*Vec3fa(random_float(),random_float(),random_float());
+      const float radius = 0.2f+random_float();
+      Ref<SceneGraph::Node> node;
+      if (i%2) node = SceneGraph::createTriangleSphere(center,radius,10+random_int()%40);
+      else     node = SceneGraph::createQuadSphere(center,radius,10+random_int()%40);
+      scene0.addGeometry(RTC_BUILD_QUALITY_MEDIUM,node);
+      scene1.addGeometry(RTC_BUILD_QUALITY_MEDIUM,node);
+    }
+
+    bool compareHits(RTCScene scene0, RTCScene scene1)
+    {
+      for (size_t i=0; i<1000; i++)
+      {
+        const Vec3fa org = 10.0f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(1.0f);
+        const Vec3fa dir = 2.0f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(1.0f);
+        RTCRayHit ray0 = makeRay(org,dir); rtcIntersect1(scene0,&ray0);
+        RTCRayHit ray1 = makeRay(org,dir); rtcIntersect1(scene1,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.primID != ray1.hit.primID || ray0.ray.tfar != ray1.ray.tfar)
+          return false;
+      }
+      return true;
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      VerifyScene scene(device,SceneFlags(sflags,RTC_BUILD_QUALITY_HIGH));
+      VerifyScene budget_scene(device,SceneFlags(sflags,RTC_BUILD_QUALITY_HIGH));
+      rtcSetSceneBuildTimeBudget(budget_scene,-1.0f);
+      AssertError(device,RTC_ERROR_INVALID_ARGUMENT);
+      rtcSetSceneBuildTimeBudget(budget_scene,budget);
+      AssertNoError(device);
+
+      for (size_t i=0; i<16; i++)
+        addSphere(scene,budget_scene,i);
+      rtcCommitScene(scene);
+      rtcCommitScene(budget_scene);
+      AssertNoError(device);
+      if (!compareHits(scene,budget_scene))
+        return VerifyApplication::FAILED;
+
+      /* later commits may select a different quality and only rebuild modified geometries */
+      for (size_t i=16; i<20; i++)
+      {
+        rtcDetachGeometry(scene,(unsigned)(i-16));
+        rtcDetachGeometry(budget_scene,(unsigned)(i-16));
+        addSphere(scene,budget_scene,i);
+        rtcCommitScene(scene);
+        rtcCommitScene(budget_scene);
+        AssertNoError(device);
+        if (!compareHits(scene,budget_scene))
+          return VerifyApplication::FAILED;
+      }
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct MeshDedupTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    RTCBuildQuality quality;
+
+    MeshDedupTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality) {}
+
+    template<typename Positions>
+    static void transform(Positions& positions, const AffineSpace3fa& xfm)
+    {
+      for (auto& p : positions)
+        p = xfmPoint(xfm,Vec3fa(p));
+    }
+
+    bool compareHits(RTCScene scene0, RTCScene scene1)
+    {
+      for (size_t i=0; i<1000; i++)
+      {
+        const Vec3fa org = 10.0f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(1.0f);
+        const Vec3fa dir = 2.0f*Vec3fa(random_float(),random_float(),random_float())-Vec3fa(1.0f);
+        RTCRayHit ray0 = makeRay(org,dir); rtcIntersect1(scene0,&ray0);
+        RTCRayHit ray1 = makeRay(org,dir); rtcIntersect1(scene1,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.primID != ray1.hit.primID || ray0.ray.tfar != ray1.ray.tfar)
+          return false;
+      }
+      return true;
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      std::string dedup_cfg = cfg + ",mesh_dedup=1";
+      RTCDeviceRef dedup_device = rtcNewDevice(dedup_cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(dedup_device));
+      VerifyScene scene(device,sflags);
+      VerifyScene dedup_scene(dedup_device,sflags);
+
+      /* rotated and translated copies of a few spheres, the last copy is also scaled and thus no duplicate */
+      std::vector<Ref<SceneGraph::Node>> nodes;
+      for (size_t i=0; i<24; i++)
+      {
+        const Vec3fa axis = normalize(Vec3fa(random_float(),random_float(),random_float())+Vec3fa(0.1f));
+        AffineSpace3fa xfm = AffineSpace3fa::translate(8.0f*Vec3fa(random_float(),random_float(),random_float())) * AffineSpace3fa::rotate(axis,6.0f*random_float());
+        if (i == 23) xfm = xfm * AffineSpace3fa::scale(Vec3fa(1.5f));
+
+        const unsigned int numPhi = (i%4) < 2 ? 20 : 32;
+        Ref<SceneGraph::Node> node;
+        if (i%2) {
+          Ref<SceneGraph::TriangleMeshNode> mesh = SceneGraph::createTriangleSphere(Vec3fa(zero),1.0f,numPhi).dynamicCast<SceneGraph::TriangleMeshNode>();
+          transform(mesh->positions[0],xfm);
+          node = mesh.dynamicCast<SceneGraph::Node>();
+        } else {
+          Ref<SceneGraph::QuadMeshNode> mesh = SceneGraph::createQuadSphere(Vec3fa(zero),1.0f,numPhi).dynamicCast<SceneGraph::QuadMeshNode>();
+          transform(mesh->positions[0],xfm);
+          node = mesh.dynamicCast<SceneGraph::Node>();
+        }
+        scene.addGeometry(quality,node);
+        dedup_scene.addGeometry(quality,node);
+        nodes.push_back(node);
+      }
+      rtcCommitScene(scene);
+      rtcCommitScene(dedup_scene);
+      AssertNoError(device);
+      AssertNoError(dedup_device);
+      if (!compareHits(scene,dedup_scene))
+        return VerifyApplication::FAILED;
+
+      /* moving some copies makes them duplicates of the same prototypes again */
+      for (unsigned int geomID=4; geomID<8; geomID++)
+      {
+        const AffineSpace3fa xfm = AffineSpace3fa::translate(Vec3fa(0.5f,0.0f,0.0f));
+        if (Ref<SceneGraph::TriangleMeshNode> mesh = nodes[geomID].dynamicCast<SceneGraph::TriangleMeshNode>())
+          transform(mesh->positions[0],xfm);
+        else if (Ref<SceneGraph::QuadMeshNode> mesh = nodes[geomID].dynamicCast<SceneGraph::QuadMeshNode>())
+          transform(mesh->positions[0],xfm);
+
+        for (RTCScene s : { (RTCScene)scene, (RTCScene)dedup_scene }) {
+          RTCGeometry geom = rtcGetGeometry(s,geomID);
+          rtcUpdateGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0);
+          rtcCommitGeometry(geom);
+        }
+      }
+      rtcCommitScene(scene);
+      rtcCommitScene(dedup_scene);
+      AssertNoError(device);
+      AssertNoError(dedup_device);
+      if (!compareHits(scene,dedup_scene))
+        return VerifyApplication::FAILED;
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct AsyncCommitTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    RTCBuildQuality quality;
+
+    AsyncCommitTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality) {}
+
+    struct CommitState
+    {
+      CommitState () : done(false), error(RTC_ERROR_UNKNOWN), scene(nullptr) {}
+      std::atomic<bool> done;
+      RTCError error;
+      RTCScene scene;
+    };
+
+    static void commitComplete(void* ptr, RTCScene scene, RTCError error)
+    {
+      CommitState* state = (CommitState*) ptr;
+      state->error = error;
+      state->scene = scene;
+      state->done = true;
+    }
+
+    static void addGeometries(VerifyScene& scene, RTCBuildQuality quality)
+    {
+      for (size_t i=0; i<8; i++) {
+        const Vec3fa center(float(i),0.0f,0.0f);
+        scene.addGeometry(quality,SceneGraph::createTriangleSphere(center,0.4f,50));
+        scene.addGeometry(quality,SceneGraph::createQuadSphere(center+Vec3fa(0,1,0),0.4f,50));
+      }
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* the front scene gets rendered while the back scene builds in the background */
+      VerifyScene front(device,sflags);
+      addGeometries(front,quality);
+      rtcCommitScene (front);
+      AssertNoError(device);
+
+      VerifyScene back(device,sflags);
+      addGeometries(back,quality);
+      CommitState commitState;
+      rtcCommitSceneAsync(back,commitComplete,&commitState);
+      AssertNoError(device);
+
+      const size_t numRays = 1000;
+      std::vector<RTCRayHit> rays(numRays);
+      for (size_t i=0; i<numRays; i++)
+      {
+        const Vec3fa org(random_float()*8.0f-0.5f,random_float()*2.0f-0.5f,-10.0f);
+        rays[i] = makeRay(org,Vec3fa(0,0,1));
+        rtcIntersect1(front,&rays[i]);
+      }
+      AssertNoError(device);
+
+      while (!commitState.done) yield();
+      if (commitState.error != RTC_ERROR_NONE || commitState.scene != (RTCScene)back)
+        return VerifyApplication::FAILED;
+      AssertNoError(device);
+
+      /* the back scene has to produce the same hits after the callback got invoked */
+      for (size_t i=0; i<numRays; i++)
+      {
+        RTCRayHit ray = makeRay(Vec3fa(rays[i].ray.org_x,rays[i].ray.org_y,rays[i].ray.org_z),Vec3fa(0,0,1));
+        rtcIntersect1(back,&ray);
+        if (ray.hit.geomID != rays[i].hit.geomID || ray.hit.primID != rays[i].hit.primID || ray.ray.tfar != rays[i].ray.tfar)
+          return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+
+      /* a synchronous commit waits for a pending asynchronous commit */
+      rtcCommitSceneAsync(back,nullptr,nullptr);
+      rtcCommitScene(back);
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct CommitScenesTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    RTCBuildQuality quality;
+
+    CommitScenesTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality) {}
+
+    /* creates a top level scene that instances numChildren small scenes */
+    static void createScenes(RTCDeviceRef& device, SceneFlags sflags, RTCBuildQuality quality, size_t numChildren,
+                             Ref<VerifyScene>& top, std::vector<Ref<VerifyScene>>& children)
+    {
+      top = new VerifyScene(device,sflags);
+      for (size_t i=0; i<numChildren; i++)
+      {
+        Ref<VerifyScene> child = new VerifyScene(device,sflags);
+        child->addGeometry(quality,SceneGraph::createTriangleSphere(zero,0.4f,4+unsigned(i%16)*4));
+        children.push_back(child);
+
+        RTCGeometry inst = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_INSTANCE);
+        rtcSetGeometryInstancedScene(inst,*child);
+        const float xfm[12] = { 1,0,0, 0,1,0, 0,0,1, float(i%8),float(i/8),0 };
+        rtcSetGeometryTransform(inst,0,RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR,xfm);
+        rtcCommitGeometry(inst);
+        rtcAttachGeometry(*top,inst);
+        rtcReleaseGeometry(inst);
+      }
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      const size_t numChildren = 64;
+
+      /* reference scenes get committed one by one */
+      Ref<VerifyScene> refTop; std::vector<Ref<VerifyScene>> refChildren;
+      createScenes(device,sflags,quality,numChildren,refTop,refChildren);
+      for (auto& child : refChildren) rtcCommitScene(*child);
+      rtcCommitScene(*refTop);
+      AssertNoError(device);
+
+      /* the top level scene comes first and one child is listed twice */
+      Ref<VerifyScene> top; std::vector<Ref<VerifyScene>> children;
+      createScenes(device,sflags,quality,numChildren,top,children);
+      std::vector<RTCScene> scenes;
+      scenes.push_back(*top);
+      for (auto& child : children) scenes.push_back(*child);
+      scenes.push_back(*children[0]);
+      rtcCommitScenes(scenes.data(),scenes.size());
+      AssertNoError(device);
+
+      for (size_t i=0; i<1000; i++)
+      {
+        const Vec3fa org(random_float()*8.0f-0.5f,random_float()*8.0f-0.5f,-10.0f);
+        RTCRayHit ray0 = makeRay(org,Vec3fa(0,0,1)); rtcIntersect1(*refTop,&ray0);
+        RTCRayHit ray1 = makeRay(org,Vec3fa(0,0,1)); rtcIntersect1(*top,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.instID[0] != ray1.hit.instID[0] ||
+            ray0.hit.primID != ray1.hit.primID || ray0.ray.tfar != ray1.ray.tfar)
+          return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+
+      /* committing already committed scenes is a no-op */
+      rtcCommitScenes(scenes.data(),scenes.size());
+      rtcCommitScenes(nullptr,0);
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct LazyBuildTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    RTCBuildQuality quality;
+
+    LazyBuildTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality) {}
+
+    /* creates a top level scene that instances numChildren scenes with the given flags */
+    static void createScenes(RTCDeviceRef& device, SceneFlags sflags, SceneFlags childFlags, RTCBuildQuality quality, size_t numChildren,
+                             Ref<VerifyScene>& top, std::vector<Ref<VerifyScene>>& children)
+    {
+      top = new VerifyScene(device,sflags);
+      for (size_t i=0; i<numChildren; i++)
+      {
+        Ref<VerifyScene> child = new VerifyScene(device,childFlags);
+        if (i%2) child->addGeometry(quality,SceneGraph::createTriangleSphere(zero,0.4f,8+unsigned(i%8)*4));
+        else     child->addGeometry(quality,SceneGraph::createQuadSphere(zero,0.4f,8+unsigned(i%8)*4));
+        children.push_back(child);
+
+        RTCGeometry inst = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_INSTANCE);
+        rtcSetGeometryInstancedScene(inst,*child);
+        const float xfm[12] = { 1,0,0, 0,1,0, 0,0,1, float(i%8),float(i/8),0 };
+        rtcSetGeometryTransform(inst,0,RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR,xfm);
+        rtcCommitGeometry(inst);
+        rtcAttachGeometry(*top,inst);
+        rtcReleaseGeometry(inst);
+      }
+    }
+
+    struct TraceTask
+    {
+      RTCScene scene;
+      const std::vector<RTCRayHit>* rays;
+      size_t begin, end;
+      std::vector<RTCRayHit> hits;
+    };
+
+    static void traceThread(void* ptr)
+    {
+      TraceTask* task = (TraceTask*) ptr;
+      for (size_t i=task->begin; i<task->end; i++) {
+        RTCRayHit ray = (*task->rays)[i];
+        rtcIntersect1(task->scene,&ray);
+        task->hits.push_back(ray);
+      }
+    }
+
+    /* traces the rays from multiple threads at once, such that multiple threads reach each lazy scene first */
+    static std::vector<RTCRayHit> trace(RTCScene scene, const std::vector<RTCRayHit>& rays)
+    {
+      const size_t numThreads = 4;
+      std::vector<TraceTask> tasks(numThreads);
+      std::vector<thread_t> threads;
+      for (size_t i=0; i<numThreads; i++) {
+        tasks[i].scene = scene;
+        tasks[i].rays = &rays;
+        tasks[i].begin = i*rays.size()/numThreads;
+        tasks[i].end = (i+1)*rays.size()/numThreads;
+        threads.push_back(createThread(traceThread,&tasks[i]));
+      }
+      std::vector<RTCRayHit> hits;
+      for (size_t i=0; i<numThreads; i++) {
+        join(threads[i]);
+        hits.insert(hits.end(),tasks[i].hits.begin(),tasks[i].hits.end());
+      }
+      return hits;
+    }
+
+    static bool compareHits(const std::vector<RTCRayHit>& hits0, const std::vector<RTCRayHit>& hits1)
+    {
+      for (size_t i=0; i<hits0.size(); i++)
+      {
+        const RTCRayHit& ray0 = hits0[i];
+        const RTCRayHit& ray1 = hits1[i];
+        if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.instID[0] != ray1.hit.instID[0] ||
+            ray0.hit.primID != ray1.hit.primID || ray0.ray.tfar != ray1.ray.tfar)
+          return false;
+      }
+      return true;
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      const size_t numChildren = 32;
+      const SceneFlags lazyFlags(RTCSceneFlags(sflags.sflags | RTC_SCENE_FLAG_LAZY),sflags.qflags);
+
+      Ref<VerifyScene> refTop; std::vector<Ref<VerifyScene>> refChildren;
+      createScenes(device,sflags,sflags,quality,numChildren,refTop,refChildren);
+      for (auto& child : refChildren) rtcCommitScene(*child);
+      rtcCommitScene(*refTop);
+      AssertNoError(device);
+
+      Ref<VerifyScene> top; std::vector<Ref<VerifyScene>> children;
+      createScenes(device,sflags,lazyFlags,quality,numChildren,top,children);
+      for (auto& child : children) rtcCommitScene(*child);
+      rtcCommitScene(*top);
+      AssertNoError(device);
+
+      /* the commit of a lazy scene computes the same bounds as the build */
+      for (size_t i=0; i<numChildren; i++)
+      {
+        RTCBounds b0; rtcGetSceneBounds(*refChildren[i],&b0);
+        RTCBounds b1; rtcGetSceneBounds(*children[i],&b1);
+        if (b0.lower_x != b1.lower_x || b0.lower_y != b1.lower_y || b0.lower_z != b1.lower_z ||
+            b0.upper_x != b1.upper_x || b0.upper_y != b1.upper_y || b0.upper_z != b1.upper_z)
+          return VerifyApplication::FAILED;
+      }
+
+      /* rays only reach some of the scenes */
+      std::vector<RTCRayHit> rays;
+      for (size_t i=0; i<1000; i++) {
+        const Vec3fa org(random_float()*4.0f-0.5f,random_float()*4.0f-0.5f,-10.0f);
+        rays.push_back(makeRay(org,Vec3fa(0,0,1)));
+      }
+      if (!compareHits(trace(*refTop,rays),trace(*top,rays)))
+        return VerifyApplication::FAILED;
+      AssertNoError(device);
+
+      /* lazy scenes can also get traced directly */
+      for (size_t i=0; i<numChildren; i++)
+      {
+        RTCRayHit ray0 = makeRay(Vec3fa(0.1f,0.1f,-10.0f),Vec3fa(0,0,1)); rtcIntersect1(*refChildren[i],&ray0);
+        RTCRayHit ray1 = makeRay(Vec3fa(0.1f,0.1f,-10.0f),Vec3fa(0,0,1)); rtcIntersect1(*children[i],&ray1);
+        if (ray0.hit.primID != ray1.hit.primID || ray0.ray.tfar != ray1.ray.tfar)
+          return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+
+      /* a commit after a modification defers the build again */
+      for (auto& child : children) {
+        rtcCommitGeometry(rtcGetGeometry(*child,0));
+        rtcCommitScene(*child);
+      }
+      rtcCommitScene(*top);
+      if (!compareHits(trace(*refTop,rays),trace(*top,rays)))
+        return VerifyApplication::FAILED;
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct IncrementalBuildTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    IncrementalBuildTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    static RTCGeometry createSphere (RTCDevice device, const Vec3fa& pos, float r, size_t numPhi, size_t* numVertices = nullptr)
+    {
+      Ref<SceneGraph::TriangleMeshNode> mesh = SceneGraph::createTriangleSphere(pos,r,numPhi).dynamicCast<SceneGraph::TriangleMeshNode>();
+      if (numVertices) *numVertices = mesh->positions[0].size();
+      RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
+      void* indices  = rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT3,sizeof(SceneGraph::TriangleMeshNode::Triangle),mesh->triangles.size());
+      void* vertices = rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,sizeof(SceneGraph::TriangleMeshNode::Vertex),mesh->positions[0].size());
+      memcpy(indices,mesh->triangles.data(),mesh->triangles.size()*sizeof(SceneGraph::TriangleMeshNode::Triangle));
+      memcpy(vertices,mesh->positions[0].data(),mesh->positions[0].size()*sizeof(SceneGraph::TriangleMeshNode::Vertex));
+      rtcCommitGeometry(geom);
+      return geom;
+    }
+
+    static RTCGeometry createInstance (RTCDevice device, RTCScene child, const Vec3fa& pos)
+    {
+      RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_INSTANCE);
+      rtcSetGeometryInstancedScene(geom,child);
+      const float xfm[12] = { 1,0,0, 0,1,0, 0,0,1, pos.x,pos.y,pos.z };
+      rtcSetGeometryTransform(geom,0,RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR,xfm);
+      rtcCommitGeometry(geom);
+      return geom;
+    }
+
+    Vec3fa randomPosition () {
+      return Vec3fa(32.0f*random_float(),32.0f*random_float(),4.0f*random_float());
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* scene instanced by some geometries of the dynamic scene */
+      RTCSceneRef child = rtcNewScene(device);
+      RTCGeometry childGeom = createSphere(device,zero,0.5f,8);
+      rtcAttachGeometry(child,childGeom);
+      rtcCommitScene(child);
+
+      /* dynamic scene that gets updated incrementally, geometries are small and large meshes and instances */
+      const unsigned int numSlots = 512;
+      std::vector<RTCGeometry> geoms(numSlots,nullptr);
+      std::vector<size_t> numVertices(numSlots,0);
+      VerifyScene scene(device,sflags);
+      auto createGeometry = [&] (unsigned int slot) {
+        switch (slot%3) {
+        case 0 : geoms[slot] = createSphere(device,randomPosition(),0.2f,1,&numVertices[slot]); break;
+        case 1 : geoms[slot] = createSphere(device,randomPosition(),0.5f,6,&numVertices[slot]); break;
+        default: geoms[slot] = createInstance(device,child,randomPosition()); break;
+        }
+        rtcAttachGeometryByID(scene,geoms[slot],slot);
+      };
+      for (unsigned int i=0; i<numSlots; i++)
+        createGeometry(i);
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      for (size_t frame=0; frame<50; frame++)
+      {
+        /* add, remove, disable, enable, and move a few geometries */
+        for (size_t i=0; i<8; i++)
+        {
+          const unsigned int slot = random_int()%numSlots;
+          if (geoms[slot] == nullptr) {
+            createGeometry(slot);
+            continue;
+          }
+          switch (random_int()%4) {
+          case 0:
+            rtcDetachGeometry(scene,slot);
+            rtcReleaseGeometry(geoms[slot]);
+            geoms[slot] = nullptr;
+            break;
+          case 1: rtcDisableGeometry(geoms[slot]); break;
+          case 2: rtcEnableGeometry(geoms[slot]); break;
+          case 3:
+            if (slot%3 == 2) {
+              const Vec3fa pos = randomPosition();
+              const float xfm[12] = { 1,0,0, 0,1,0, 0,0,1, pos.x,pos.y,pos.z };
+              rtcSetGeometryTransform(geoms[slot],0,RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR,xfm);
+            }
+            else {
+              SceneGraph::TriangleMeshNode::Vertex* vertices = (SceneGraph::TriangleMeshNode::Vertex*) rtcGetGeometryBufferData(geoms[slot],RTC_BUFFER_TYPE_VERTEX,0);
+              const Vec3fa delta = randomPosition()-Vec3fa(16.0f,16.0f,2.0f);
+              for (size_t v=0; v<numVertices[slot]; v++)
+                vertices[v] = Vec3fa(vertices[v]) + delta;
+              rtcUpdateGeometryBuffer(geoms[slot],RTC_BUFFER_TYPE_VERTEX,0);
+            }
+            rtcCommitGeometry(geoms[slot]);
+            break;
+          }
+        }
+
+        /* instances change their bounds when the instanced scene gets recommitted */
+        if (frame%10 == 5) {
+          float* vertices = (float*) rtcGetGeometryBufferData(childGeom,RTC_BUFFER_TYPE_VERTEX,0);
+          vertices[0] += 0.5f;
+          rtcUpdateGeometryBuffer(childGeom,RTC_BUFFER_TYPE_VERTEX,0);
+          rtcCommitGeometry(childGeom);
+          rtcCommitScene(child);
+        }
+        rtcCommitScene(scene);
+        AssertNoError(device);
+
+        /* the incrementally updated scene has to match a scene built from scratch */
+        RTCSceneRef reference = rtcNewScene(device);
+        for (unsigned int slot=0; slot<numSlots; slot++)
+          if (geoms[slot]) rtcAttachGeometryByID(reference,geoms[slot],slot);
+        rtcCommitScene(reference);
+        AssertNoError(device);
+
+        for (size_t i=0; i<200; i++)
+        {
+          const Vec3fa org(34.0f*random_float()-1.0f,34.0f*random_float()-1.0f,-10.0f);
+          RTCRayHit ray0 = makeRay(org,Vec3fa(0,0,1)); rtcIntersect1(reference,&ray0);
+          RTCRayHit ray1 = makeRay(org,Vec3fa(0,0,1)); rtcIntersect1(scene,&ray1);
+          if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.instID[0] != ray1.hit.instID[0] || abs(ray0.ray.tfar-ray1.ray.tfar) > 1E-4f)
+            return VerifyApplication::FAILED;
+        }
+        AssertNoError(device);
+      }
+
+      for (auto geom : geoms)
+        if (geom) rtcReleaseGeometry(geom);
+      rtcReleaseGeometry(childGeom);
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct RefitDegradationTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    float maxDegradation;
+
+    RefitDegradationTest (std::string name, int isa, SceneFlags sflags, float maxDegradation)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), maxDegradation(maxDegradation) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa)+",refit_max_sah_degradation="+std::to_string(maxDegradation);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      VerifyScene scene(device,sflags);
+
+      /* a large and a small bumpy plane whose corner gets scrambled by moving vertices towards random other corner vertices */
+      const size_t numMeshes = 2;
+      const size_t resolution[numMeshes] = { 100, 20 };
+      RTCGeometry geoms[numMeshes];
+      std::vector<Vec3fa> positions[numMeshes];
+      std::vector<unsigned int> targets[numMeshes];
+      for (size_t m=0; m<numMeshes; m++)
+      {
+        Ref<SceneGraph::TriangleMeshNode> mesh = SceneGraph::createTrianglePlane(Vec3fa(0,0,0),Vec3fa(32,0,0),Vec3fa(0,32,0),resolution[m],resolution[m]).dynamicCast<SceneGraph::TriangleMeshNode>();
+        const size_t numVertices = mesh->positions[0].size();
+        std::vector<unsigned int> corner;
+        for (size_t v=0; v<numVertices; v++) {
+          positions[m].push_back(Vec3fa(mesh->positions[0][v].x,mesh->positions[0][v].y,4.0f*random_float()));
+          if (positions[m][v].x < 8.0f && positions[m][v].y < 8.0f) corner.push_back((unsigned int)v);
+        }
+        for (size_t v=0; v<numVertices; v++)
+          targets[m].push_back(corner.size() && positions[m][v].x < 8.0f && positions[m][v].y < 8.0f ? corner[random_int()%corner.size()] : (unsigned int)v);
+        geoms[m] = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
+        rtcSetGeometryBuildQuality(geoms[m],RTC_BUILD_QUALITY_REFIT);
+        void* indices = rtcSetNewGeometryBuffer(geoms[m],RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT3,sizeof(SceneGraph::TriangleMeshNode::Triangle),mesh->triangles.size());
+        memcpy(indices,mesh->triangles.data(),mesh->triangles.size()*sizeof(SceneGraph::TriangleMeshNode::Triangle));
+        rtcSetNewGeometryBuffer(geoms[m],RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,sizeof(SceneGraph::TriangleMeshNode::Vertex),numVertices);
+        rtcAttachGeometryByID(scene,geoms[m],(unsigned int)m);
+      }
+
+      for (size_t frame=0; frame<=20; frame++)
+      {
+        const float t = float(frame)/20.0f;
+        for (size_t m=0; m<numMeshes; m++)
+        {
+          SceneGraph::TriangleMeshNode::Vertex* vertices = (SceneGraph::TriangleMeshNode::Vertex*) rtcGetGeometryBufferData(geoms[m],RTC_BUFFER_TYPE_VERTEX,0);
+          for (size_t v=0; v<positions[m].size(); v++)
+            vertices[v] = lerp(positions[m][v],positions[m][targets[m][v]],t);
+          rtcUpdateGeometryBuffer(geoms[m],RTC_BUFFER_TYPE_VERTEX,0);
+          rtcCommitGeometry(geoms[m]);
+        }
+        rtcCommitScene(scene);
+        AssertNoError(device);
+
+        /* the refitted and partially rebuilt scene has to match a scene built from scratch */
+        RTCSceneRef reference = rtcNewScene(device);
+        for (size_t m=0; m<numMeshes; m++)
+          rtcAttachGeometryByID(reference,geoms[m],(unsigned int)m);
+        rtcCommitScene(reference);
+        AssertNoError(device);
+
+        for (size_t i=0; i<400; i++)
+        {
+          const Vec3fa org(34.0f*random_float()-1.0f,34.0f*random_float()-1.0f,-10.0f);
+          RTCRayHit ray0 = makeRay(org,Vec3fa(0,0,1)); rtcIntersect1(reference,&ray0);
+          RTCRayHit ray1 = makeRay(org,Vec3fa(0,0,1)); rtcIntersect1(scene,&ray1);
+          if (ray0.hit.geomID != ray1.hit.geomID || abs(ray0.ray.tfar-ray1.ray.tfar) > 1E-4f)
+            return VerifyApplication::FAILED;
+        }
+        AssertNoError(device);
+      }
+
+      for (size_t m=0; m<numMeshes; m++)
+        rtcReleaseGeometry(geoms[m]);
+      return VerifyApplication::PASSED;
+    }
+  };
+
   struct OverlappingGeometryTest : public VerifyApplication::Test
   {
     SceneFlags sflags;
@@ -4062,6 +5305,235 @@ namespace embree
     }
   };
   
+  struct MultiHitTest : public VerifyApplication::Test
+  {
+    static const unsigned int numLayers = 24;
+
+    SceneFlags sflags;
+    GeometryType gtype;
+    bool instancing;
+    bool filter;
+    unsigned int K;
+
+    MultiHitTest (std::string name, int isa, SceneFlags sflags, GeometryType gtype, bool instancing, bool filter, unsigned int K)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), gtype(gtype), instancing(instancing), filter(filter), K(K) {}
+
+    /* creates a stack of parallel layers, layer i is placed at z=i+1 and gets geometry ID i */
+    void createLayers(RTCDevice device, RTCScene scene)
+    {
+      for (unsigned int i=0; i<numLayers; i++)
+      {
+        const float z = float(i+1);
+        if (gtype == QUAD_MESH)
+        {
+          RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_QUAD);
+          Vec3f* vertices = (Vec3f*) rtcSetNewGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, sizeof(Vec3f), 4);
+          vertices[0] = Vec3f(-10.0f,-10.0f,z);
+          vertices[1] = Vec3f(+10.0f,-10.0f,z);
+          vertices[2] = Vec3f(+10.0f,+10.0f,z);
+          vertices[3] = Vec3f(-10.0f,+10.0f,z);
+          unsigned int* indices = (unsigned int*) rtcSetNewGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT4, 4*sizeof(unsigned int), 1);
+          indices[0] = 0; indices[1] = 1; indices[2] = 2; indices[3] = 3;
+          rtcCommitGeometry(geom);
+          rtcAttachGeometry(scene,geom);
+          rtcReleaseGeometry(geom);
+        }
+        else
+        {
+          RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
+          Vec3f* vertices = (Vec3f*) rtcSetNewGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, sizeof(Vec3f), 3);
+          vertices[0] = Vec3f(-10.0f,-10.0f,z);
+          vertices[1] = Vec3f(+10.0f,-10.0f,z);
+          vertices[2] = Vec3f(  0.0f,+10.0f,z);
+          unsigned int* indices = (unsigned int*) rtcSetNewGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3, 3*sizeof(unsigned int), 1);
+          indices[0] = 0; indices[1] = 1; indices[2] = 2;
+          rtcCommitGeometry(geom);
+          rtcAttachGeometry(scene,geom);
+          rtcReleaseGeometry(geom);
+        }
+      }
+    }
+
+    /* rejects all hits of layers with even geometry ID */
+    static void rejectEvenLayers(const RTCFilterFunctionNArguments* args)
+    {
+      assert(args->N == 1);
+      if (RTCHitN_geomID(args->hit,args->N,0) % 2 == 0)
+        args->valid[0] = 0;
+    }
+
+    template<int N, typename RTCRayHitN>
+    void intersectPacket(RTCScene scene, RTCRayHit* rays, RTCMultiHit* hits, unsigned int maxHits, RTCIntersectArguments* args)
+    {
+      __aligned(64) int valid[N];
+      __aligned(64) RTCRayHitN rayN;
+      for (size_t j=0; j<N; j++) {
+        valid[j] = -1;
+        setRay(rayN,j,rays[j]);
+      }
+      rtcIntersectMultiHit(valid,scene,&rayN,hits,maxHits,args);
+      for (size_t j=0; j<N; j++) rays[j] = getRay(rayN,j);
+    }
+
+    void rtcIntersectMultiHit(const int* valid, RTCScene scene, RTCRayHit4* ray, RTCMultiHit* hits, unsigned int maxHits, RTCIntersectArguments* args) {
+      rtcIntersectMultiHit4(valid,scene,ray,hits,maxHits,args);
+    }
+    void rtcIntersectMultiHit(const int* valid, RTCScene scene, RTCRayHit8* ray, RTCMultiHit* hits, unsigned int maxHits, RTCIntersectArguments* args) {
+      rtcIntersectMultiHit8(valid,scene,ray,hits,maxHits,args);
+    }
+    void rtcIntersectMultiHit(const int* valid, RTCScene scene, RTCRayHit16* ray, RTCMultiHit* hits, unsigned int maxHits, RTCIntersectArguments* args) {
+      rtcIntersectMultiHit16(valid,scene,ray,hits,maxHits,args);
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      RTCSceneRef scene = rtcNewScene(device);
+      rtcSetSceneFlags(scene,RTCSceneFlags(sflags.sflags | RTC_SCENE_FLAG_FILTER_FUNCTION_IN_ARGUMENTS));
+      rtcSetSceneBuildQuality(scene,sflags.qflags);
+
+      RTCSceneRef child = rtcNewScene(device);
+      if (instancing)
+      {
+        rtcSetSceneFlags(child,RTCSceneFlags(sflags.sflags | RTC_SCENE_FLAG_FILTER_FUNCTION_IN_ARGUMENTS));
+        rtcSetSceneBuildQuality(child,sflags.qflags);
+        createLayers(device,child);
+        rtcCommitScene(child);
+        RTCGeometry inst = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_INSTANCE);
+        rtcSetGeometryInstancedScene(inst,child);
+        const float xfm[12] = { 1,0,0, 0,1,0, 0,0,1, 0,0,0 };
+        rtcSetGeometryTransform(inst,0,RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR,xfm);
+        rtcCommitGeometry(inst);
+        rtcAttachGeometry(scene,inst);
+        rtcReleaseGeometry(inst);
+      }
+      else
+        createLayers(device,scene);
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      RTCIntersectArguments args;
+      rtcInitIntersectArguments(&args);
+      if (filter) {
+        args.filter = rejectEvenLayers;
+        args.flags = RTC_RAY_QUERY_FLAG_INVOKE_ARGUMENT_FILTER;
+      }
+
+      /* expected hits front to back */
+      std::vector<unsigned int> expected;
+      for (unsigned int i=0; i<numLayers; i++)
+        if (!filter || i%2 == 1) expected.push_back(i);
+
+      const unsigned int maxHitsList[] = { 1, 2, 5, RTC_MAX_MULTI_HIT_COUNT };
+      for (unsigned int maxHits : maxHitsList)
+      {
+        RTCRayHit rays[16];
+        vector_t<RTCMultiHit,aligned_allocator<RTCMultiHit,16>> hits(16);
+        for (size_t i=0; i<16; i++) {
+          const Vec3fa org(random_float()-0.5f,random_float()-0.5f,0.0f);
+          const Vec3fa dir(0.1f*(random_float()-0.5f),0.1f*(random_float()-0.5f),1.0f);
+          rays[i] = makeRay(org,dir);
+        }
+
+        switch (K) {
+        case  1: for (size_t i=0; i<16; i++) rtcIntersectMultiHit1(scene,&rays[i],&hits[i],maxHits,&args); break;
+        case  4: for (size_t i=0; i<16; i+=4) intersectPacket<4,RTCRayHit4>(scene,&rays[i],&hits[i],maxHits,&args); break;
+        case  8: for (size_t i=0; i<16; i+=8) intersectPacket<8,RTCRayHit8>(scene,&rays[i],&hits[i],maxHits,&args); break;
+        case 16: intersectPacket<16,RTCRayHit16>(scene,rays,hits.data(),maxHits,&args); break;
+        default: assert(false);
+        }
+        AssertNoError(device);
+
+        const unsigned int instID = instancing ? 0 : RTC_INVALID_GEOMETRY_ID;
+        for (size_t i=0; i<16; i++)
+        {
+          const RTCMultiHit& h = hits[i];
+          if (h.numHits != min(maxHits,(unsigned int)expected.size())) return VerifyApplication::FAILED;
+
+          for (unsigned int j=0; j<h.numHits; j++)
+          {
+            const float t = float(expected[j]+1)/rays[i].ray.dir_z;
+            if (h.hit[j].geomID != expected[j]) return VerifyApplication::FAILED;
+            if (h.hit[j].primID != 0) return VerifyApplication::FAILED;
+            if (h.hit[j].instID[0] != instID) return VerifyApplication::FAILED;
+            if (abs(h.t[j] - t) > 1E-4f*t) return VerifyApplication::FAILED;
+          }
+
+          /* the ray returns the nearest hit */
+          if (rays[i].hit.geomID != h.hit[0].geomID) return VerifyApplication::FAILED;
+          if (rays[i].ray.tfar != h.t[0]) return VerifyApplication::FAILED;
+        }
+      }
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct SharedOriginOccludedTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    bool motion_blur;
+
+    static const size_t numSpheres = 40;
+    static const size_t numRays = 2000;
+
+    SharedOriginOccludedTest (std::string name, int isa, SceneFlags sflags, bool motion_blur)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), motion_blur(motion_blur) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      VerifyScene scene(device,sflags);
+      for (size_t i=0; i<numSpheres; i++)
+      {
+        const Vec3fa pos = 20.0f*random_Vec3fa()-Vec3fa(10.0f);
+        const float r = 0.2f+random_float();
+        if (motion_blur) scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,r,10,-1,random_motion_vector(1.0f));
+        else             scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos,r,10);
+      }
+      rtcCommitScene (scene);
+      AssertNoError(device);
+
+      size_t numFailures = 0;
+      for (size_t i=0; i<size_t(4*state->intensity); i++)
+      {
+        /* shadow rays from a point light towards random points, some of them are inactive */
+        const Vec3fa org = 16.0f*random_Vec3fa()-Vec3fa(8.0f);
+        RTCRay ray = makeRay(org,Vec3fa(0,0,1)).ray;
+        ray.time = motion_blur ? random_float() : 0.0f;
+
+        std::vector<float> dir(3*numRays);
+        std::vector<float> tfar(numRays);
+        std::vector<float> tfar_expected(numRays);
+        for (size_t j=0; j<numRays; j++)
+        {
+          const Vec3fa d = 24.0f*random_Vec3fa()-Vec3fa(12.0f)-org;
+          dir[3*j+0] = d.x; dir[3*j+1] = d.y; dir[3*j+2] = d.z;
+          tfar[j] = j%10 == 0 ? -1.0f : random_float();
+
+          RTCRay ray1 = ray;
+          ray1.dir_x = d.x; ray1.dir_y = d.y; ray1.dir_z = d.z;
+          ray1.tfar = tfar[j];
+          if (ray1.tnear <= ray1.tfar) rtcOccluded1(scene,&ray1);
+          tfar_expected[j] = ray1.tfar;
+        }
+
+        rtcOccludedSharedOrigin(scene,&ray,dir.data(),tfar.data(),(unsigned int)numRays);
+        AssertNoError(device);
+
+        for (size_t j=0; j<numRays; j++)
+          numFailures += tfar[j] != tfar_expected[j];
+      }
+      return (VerifyApplication::TestReturnValue) (numFailures == 0);
+    }
+  };
+
   /////////////////////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////
@@ -5117,6 +6589,24 @@ namespace embree
         }
         break;
       }
+      case MODE_INTERSECT_STREAM: 
+      case MODE_INTERSECT_STREAM_BREADTH_FIRST: 
+      {
+        if (imode == MODE_INTERSECT_STREAM_BREADTH_FIRST)
+          args.flags = (RTCRayQueryFlags) (args.flags | RTC_RAY_QUERY_FLAG_BREADTH_FIRST);
+        vector_t<RTCRayHit,aligned_allocator<RTCRayHit,16>> rays;
+        rays.reserve((y1-y0)*(x1-x0));
+        for (size_t y=y0; y<y1; y++) {
+          for (size_t x=x0; x<x1; x++) {
+            rays.push_back(fastMakeRay(zero,Vec3f(float(x)*rcpWidth,1,float(y)*rcpHeight)));
+          }
+        }
+        switch (ivariant & VARIANT_INTERSECT_OCCLUDED_MASK) {
+        case VARIANT_INTERSECT: rtcIntersectStream(*scene,rays.data(),(unsigned int)rays.size(),sizeof(RTCRayHit),&args); break;
+        case VARIANT_OCCLUDED : rtcOccludedStream (*scene,(RTCRay*)rays.data(),(unsigned int)rays.size(),sizeof(RTCRayHit),(RTCOccludedArguments*)&args); break;
+        }
+        break;
+      }
       default: break;
       }
     }
@@ -5260,6 +6750,21 @@ namespace embree
         }
         break;
       }
+      case MODE_INTERSECT_STREAM: 
+      case MODE_INTERSECT_STREAM_BREADTH_FIRST: 
+      {
+        if (imode == MODE_INTERSECT_STREAM_BREADTH_FIRST)
+          args.flags = (RTCRayQueryFlags) (args.flags | RTC_RAY_QUERY_FLAG_BREADTH_FIRST);
+        vector_t<RTCRayHit,aligned_allocator<RTCRayHit,16>> rays(dn);
+        for (size_t j=0; j<dn; j++) {
+          fastMakeRay(rays[j],zero,sampler);
+        }
+        switch (ivariant & VARIANT_INTERSECT_OCCLUDED_MASK) {
+        case VARIANT_INTERSECT: rtcIntersectStream(*scene,rays.data(),(unsigned int)dn,sizeof(RTCRayHit),&args); break;
+        case VARIANT_OCCLUDED : rtcOccludedStream (*scene,(RTCRay*)rays.data(),(unsigned int)dn,sizeof(RTCRayHit),(RTCOccludedArguments*)&args); break;
+        }
+        break;
+      }
       default: break;
       }
     }
@@ -5273,6 +6778,58 @@ namespace embree
     }
   };
 
+  struct CablesBenchmark : public ParallelIntersectBenchmark
+  {
+    std::string accel;
+    RTCDeviceRef device;
+    Ref<VerifyScene> scene;
+    static const size_t numRays = 4*1024*1024;
+    static const size_t deltaRays = 1024;
+
+    CablesBenchmark (std::string name, int isa, std::string accel)
+      : ParallelIntersectBenchmark(name,isa,numRays,deltaRays), accel(accel), device(nullptr) {}
+
+    bool setup(VerifyApplication* state)
+    {
+      if (!ParallelIntersectBenchmark::setup(state))
+        return false;
+
+      /* robust scenes use BVH8 Triangle4v and Quad4v by default, which only differ from the OBB variants in the node types */
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      if (accel != "bvh8") cfg += ",tri_accel="+accel+".triangle4v,quad_accel="+accel+".quad4v";
+      device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      rtcSetDeviceErrorFunction(device,errorHandler,nullptr);
+
+      scene = new VerifyScene(device,SceneFlags(RTC_SCENE_FLAG_ROBUST,RTC_BUILD_QUALITY_MEDIUM));
+      addCables(*scene,RTC_BUILD_QUALITY_MEDIUM,4096,1);
+      rtcCommitScene (*scene);
+      AssertNoError(device);
+
+      return true;
+    }
+
+    void render_block(size_t i, size_t dn)
+    {
+      RandomSampler sampler;
+      RandomSampler_init(sampler, (int)i);
+
+      for (size_t j=0; j<dn; j++) {
+        RTCRayHit ray;
+        fastMakeRay(ray,Vec3fa(4.0f),sampler);
+        rtcIntersect1(*scene,&ray);
+      }
+    }
+
+    virtual void cleanup(VerifyApplication* state)
+    {
+      AssertNoError(device);
+      scene = nullptr;
+      device = nullptr;
+      ParallelIntersectBenchmark::cleanup(state);
+    }
+  };
+
   static std::atomic<ssize_t> create_geometry_bytes_used(0);
 
   struct CreateGeometryBenchmark : public VerifyApplication::Benchmark
@@ -5469,6 +7026,9 @@ namespace embree
     intersectModes.push_back(MODE_INTERSECT4);
     intersectModes.push_back(MODE_INTERSECT8);
     intersectModes.push_back(MODE_INTERSECT16);
+    intersectModes.push_back(MODE_INTERSECT_STREAM);
+    intersectModes.push_back(MODE_INTERSECT_STREAM_N);
+    intersectModes.push_back(MODE_INTERSECT_STREAM_BREADTH_FIRST);
         
     /* create a list of all intersect variants for each intersect mode */
     intersectVariants.push_back(VARIANT_INTERSECT_COHERENT);
@@ -5568,7 +7128,101 @@ namespace embree
       for (auto sflags : sceneFlags) 
         groups.top()->add(new BuildTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_MEDIUM));
       groups.pop();
+
+      push(new TestGroup("ploc_build",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new PLOCBuildTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_MEDIUM));
+      groups.pop();
+
+      push(new TestGroup("morton_build",true,true));
+      for (auto sflags : { RTC_SCENE_FLAG_NONE, RTC_SCENE_FLAG_DYNAMIC })
+        groups.top()->add(new MortonBuildTest(to_string(SceneFlags(sflags,RTC_BUILD_QUALITY_MEDIUM)),isa,SceneFlags(sflags,RTC_BUILD_QUALITY_MEDIUM),RTC_BUILD_QUALITY_MEDIUM));
+      groups.pop();
+
+      push(new TestGroup("bvh_layout",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new BVHLayoutTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_MEDIUM));
+      groups.pop();
+
+      push(new TestGroup("memory_budget",true,true));
+      for (auto sflags : { RTC_SCENE_FLAG_NONE, RTC_SCENE_FLAG_ROBUST })
+        for (auto quality : { RTC_BUILD_QUALITY_MEDIUM, RTC_BUILD_QUALITY_HIGH })
+          groups.top()->add(new MemoryBudgetTest(to_string(SceneFlags(sflags,quality)),isa,SceneFlags(sflags,quality)));
+      groups.pop();
+
+      push(new TestGroup("commit_estimate",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new CommitEstimateTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      if ((isa & AVX) == AVX)
+      {
+        push(new TestGroup("obb_build",true,true));
+        for (auto quality : { RTC_BUILD_QUALITY_MEDIUM, RTC_BUILD_QUALITY_HIGH })
+          groups.top()->add(new OBBBuildTest(to_string(SceneFlags(RTC_SCENE_FLAG_NONE,quality)),isa,SceneFlags(RTC_SCENE_FLAG_NONE,quality)));
+        groups.pop();
+      }
+
+      push(new TestGroup("treelet_optimization",true,true));
+      for (auto sflags : { RTC_SCENE_FLAG_NONE, RTC_SCENE_FLAG_ROBUST, RTC_SCENE_FLAG_COMPACT })
+        for (auto builder : { "default", "ploc" })
+          for (auto treelet_size : { 5, 12 })
+            groups.top()->add(new TreeletOptimizationTest(to_string(sflags)+"."+builder+".treelet"+std::to_string(treelet_size),isa,sflags,builder,treelet_size));
+      groups.pop();
+
+      push(new TestGroup("bvh_cache",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new BVHCacheTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("deterministic_build",true,true));
+      for (auto sflags : { RTC_SCENE_FLAG_NONE, RTC_SCENE_FLAG_ROBUST, RTC_SCENE_FLAG_COMPACT })
+        for (auto quality : { RTC_BUILD_QUALITY_MEDIUM, RTC_BUILD_QUALITY_HIGH, RTC_BUILD_QUALITY_OPTIMIZED })
+          groups.top()->add(new DeterministicBuildTest(to_string(SceneFlags(sflags|RTC_SCENE_FLAG_DETERMINISTIC,quality)),isa,SceneFlags(sflags|RTC_SCENE_FLAG_DETERMINISTIC,quality)));
+      groups.pop();
+
+      push(new TestGroup("build_time_budget",true,true));
+      for (auto sflags : { RTC_SCENE_FLAG_NONE, RTC_SCENE_FLAG_ROBUST, RTC_SCENE_FLAG_COMPACT, RTC_SCENE_FLAG_DYNAMIC })
+        for (auto budget : { 0.001f, 1.0f, 1000.0f })
+          groups.top()->add(new BuildTimeBudgetTest(to_string(sflags)+".budget"+std::to_string(int(1000.0f*budget))+"us",isa,sflags,budget));
+      groups.pop();
+
+      push(new TestGroup("mesh_dedup",true,true));
+      for (auto sflags : { RTC_SCENE_FLAG_NONE, RTC_SCENE_FLAG_ROBUST, RTC_SCENE_FLAG_COMPACT })
+        for (auto quality : { RTC_BUILD_QUALITY_LOW, RTC_BUILD_QUALITY_MEDIUM })
+          groups.top()->add(new MeshDedupTest(to_string(SceneFlags(sflags,RTC_BUILD_QUALITY_LOW),quality),isa,SceneFlags(sflags,RTC_BUILD_QUALITY_LOW),quality));
+      groups.pop();
+
+      push(new TestGroup("async_commit",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new AsyncCommitTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_MEDIUM));
+      groups.pop();
       
+      push(new TestGroup("commit_scenes",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new CommitScenesTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_MEDIUM));
+      groups.pop();
+
+      push(new TestGroup("lazy_build",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new LazyBuildTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_MEDIUM));
+      groups.pop();
+
+      push(new TestGroup("incremental_build",true,true));
+      for (auto sflags : sceneFlags)
+        if (sflags.qflags == RTC_BUILD_QUALITY_LOW)
+          groups.top()->add(new IncrementalBuildTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("refit_degradation",true,true));
+      for (auto sflags : sceneFlags)
+        if (sflags.qflags == RTC_BUILD_QUALITY_LOW) {
+          groups.top()->add(new RefitDegradationTest(to_string(sflags)+".off",isa,sflags,0.0f));
+          groups.top()->add(new RefitDegradationTest(to_string(sflags)+".default",isa,sflags,1.5f));
+          groups.top()->add(new RefitDegradationTest(to_string(sflags)+".tight",isa,sflags,1.05f));
+        }
+      groups.pop();
+
       push(new TestGroup("overlapping_primitives",true,false));
       for (auto sflags : sceneFlags)
         groups.top()->add(new OverlappingGeometryTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_MEDIUM,clamp(int(intensity*10000),1000,100000)));
@@ -5678,6 +7332,21 @@ namespace embree
                 groups.top()->add(new QuadHitTest(to_string(sflags,imode,ivariant),isa,sflags,RTC_BUILD_QUALITY_MEDIUM,imode,ivariant));
       groups.pop();
 
+      push(new TestGroup("multi_hit",true,true));
+      for (auto sflags : sceneFlags)
+        for (auto gtype : { TRIANGLE_MESH, QUAD_MESH })
+          for (bool instancing : { false, true })
+            for (bool filter : { false, true })
+              for (unsigned int K : { 1, 4, 8, 16 })
+                groups.top()->add(new MultiHitTest(to_string(sflags)+"."+to_string(gtype)+(instancing ? ".instanced" : "")+(filter ? ".filter" : "")+".MultiHit"+std::to_string(K),isa,sflags,gtype,instancing,filter,K));
+      groups.pop();
+
+      push(new TestGroup("shared_origin_occluded",true,true));
+      for (auto sflags : sceneFlags)
+        for (bool motion_blur : { false, true })
+          groups.top()->add(new SharedOriginOccludedTest(to_string(sflags)+(motion_blur ? ".mblur" : ""),isa,sflags,motion_blur));
+      groups.pop();
+
       if (rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_RAY_MASK_SUPPORTED)) 
       {
         push(new TestGroup("ray_masks",true,true));
@@ -5868,6 +7537,7 @@ namespace embree
           groups.top()->add(new PointQueryTest(to_string(sflags),isa,sflags,"bvh8.triangle4i"));
           groups.top()->add(new PointQueryTest(to_string(sflags),isa,sflags,"qbvh8.triangle4"));
           groups.top()->add(new PointQueryTest(to_string(sflags),isa,sflags,"qbvh8.triangle4i"));
+          groups.top()->add(new PointQueryTest(to_string(sflags),isa,sflags,"bvh8obb.triangle4v"));
         }
         groups.top()->add(new PointQueryTest(to_string(sflags),isa,sflags));
       }
@@ -5931,6 +7601,10 @@ namespace embree
       benchmark_imodes_ivariants.push_back(std::make_pair(MODE_INTERSECT8,VARIANT_OCCLUDED));
       benchmark_imodes_ivariants.push_back(std::make_pair(MODE_INTERSECT16,VARIANT_INTERSECT));
       benchmark_imodes_ivariants.push_back(std::make_pair(MODE_INTERSECT16,VARIANT_OCCLUDED));
+      benchmark_imodes_ivariants.push_back(std::make_pair(MODE_INTERSECT_STREAM,VARIANT_INTERSECT));
+      benchmark_imodes_ivariants.push_back(std::make_pair(MODE_INTERSECT_STREAM,VARIANT_OCCLUDED));
+      benchmark_imodes_ivariants.push_back(std::make_pair(MODE_INTERSECT_STREAM_BREADTH_FIRST,VARIANT_INTERSECT));
+      benchmark_imodes_ivariants.push_back(std::make_pair(MODE_INTERSECT_STREAM_BREADTH_FIRST,VARIANT_OCCLUDED));
 
       GeometryType benchmark_gtypes[] = { 
         TRIANGLE_MESH, 
@@ -5962,6 +7636,11 @@ namespace embree
             groups.top()->add(new IncoherentRaysBenchmark("incoherent."+to_string(gtype)+"_1000k."+to_string(sflags.first,imode.first,imode.second),
                                                           isa,gtype,sflags.first,sflags.second,imode.first,imode.second,501));
 
+      if ((isa & AVX) == AVX) {
+        groups.top()->add(new CablesBenchmark("cables.bvh8",isa,"bvh8"));
+        groups.top()->add(new CablesBenchmark("cables.bvh8obb",isa,"bvh8obb"));
+      }
+
       std::vector<std::pair<SceneFlags,RTCBuildQuality>> benchmark_create_sflags_quality;
       benchmark_create_sflags_quality.push_back(std::make_pair(SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM),RTC_BUILD_QUALITY_MEDIUM));
       benchmark_create_sflags_quality.push_back(std::make_pair(SceneFlags(RTC_SCENE_FLAG_DYNAMIC,RTC_BUILD_QUALITY_LOW),RTC_BUILD_QUALITY_LOW));